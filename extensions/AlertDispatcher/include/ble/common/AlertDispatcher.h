@@ -0,0 +1,139 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_COMMON_ALERT_DISPATCHER_H
+#define BLE_COMMON_ALERT_DISPATCHER_H
+
+#include "ble/common/EmbeddedEvent.h"
+#include "events/EventQueue.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ble {
+
+/**
+ * Level of an alert, the value of the Alert Level characteristic shared by the link loss and immediate alert
+ * services
+ */
+enum class AlertLevel : uint8_t {
+    NO_ALERT    = 0,
+    MILD_ALERT  = 1,
+    HIGH_ALERT  = 2
+};
+
+/**
+ * Alert Dispatcher
+ *
+ * @par purpose
+ * Single point where the alerts of a device, a proximity tag for instance, are decided. The services and
+ * triggers raising alerts each request a level from the dispatcher, which drives the buzzer or the lights
+ * through one event handler.
+ *
+ * @par usage
+ * Pass the dispatcher to the ImmediateAlertService and to LinkLossService::set_alert_dispatcher(), request
+ * levels for your own triggers with request(), and handle on_alert_changed() in your EventHandler.
+ *
+ * The level of the alert is the highest level requested by the sources. The changes requested until the event
+ * queue runs are coalesced: two links lost at once and a write of the immediate alert level raise a single
+ * on_alert_changed(), and a request withdrawn before then raises none.
+ *
+ * @attention The dispatcher belongs to the thread dispatching the event queue, the one processing the BLE
+ * events in most applications.
+ */
+class AlertDispatcher {
+public:
+    /**
+     * Sources of alert, as a bitmask
+     */
+    enum Source : uint8_t {
+        /** Links lost with an alert level, from the link loss service */
+        LINK_LOSS       = 1 << 0,
+        /** Alert level written by a client of the immediate alert service */
+        IMMEDIATE_ALERT = 1 << 1,
+        /** Peer going out of range, from the pre-alerts of the link loss service or the application */
+        OUT_OF_RANGE    = 1 << 2
+    };
+
+    struct EventHandler {
+        /**
+         * On alert changed
+         *
+         * This function is called from the event queue when the level of the alert, or the sources requesting
+         * it, have changed.
+         *
+         * @param level Highest level requested, NO_ALERT once every source has ended its alert
+         * @param sources Bitmask of the sources requesting an alert
+         */
+        virtual void on_alert_changed(AlertLevel level, uint8_t sources) { }
+    };
+
+    /**
+     * Constructor
+     *
+     * @param event_queue EventQueue object the changes are dispatched from
+     */
+    AlertDispatcher(events::EventQueue &event_queue);
+
+    AlertDispatcher(const AlertDispatcher&) = delete;
+    AlertDispatcher &operator=(const AlertDispatcher&) = delete;
+
+    /**
+     * Set event handler
+     *
+     * @param handler EventHandler object to handle the changes of the alert
+     */
+    void set_event_handler(EventHandler *handler)
+    {
+        _handler = handler;
+    }
+
+    /**
+     * Request an alert of @p level on behalf of @p source, replacing its previous request. NO_ALERT ends the
+     * alert of the source.
+     */
+    void request(Source source, AlertLevel level);
+
+    /**
+     * @return Highest level requested now, possibly not reported to the event handler yet
+     */
+    AlertLevel get_level() const;
+
+    /**
+     * @return Bitmask of the sources requesting an alert now
+     */
+    uint8_t get_sources() const;
+
+private:
+    static constexpr size_t SOURCE_COUNT = 3;
+
+    void dispatch();
+
+    EventHandler *_handler = nullptr;
+    AlertLevel _levels[SOURCE_COUNT] = {};
+
+    /* the alert as last reported to the handler */
+    AlertLevel _reported_level = AlertLevel::NO_ALERT;
+    uint8_t _reported_sources = 0;
+
+    bool _dispatching = false;
+    EmbeddedEvent _event;
+};
+
+} // namespace ble
+
+#endif // BLE_COMMON_ALERT_DISPATCHER_H
@@ -0,0 +1,85 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/common/AlertDispatcher.h"
+
+#include <chrono>
+
+namespace ble {
+
+AlertDispatcher::AlertDispatcher(events::EventQueue &event_queue) :
+    _event(event_queue, mbed::callback(this, &AlertDispatcher::dispatch))
+{
+}
+
+void AlertDispatcher::request(Source source, AlertLevel level)
+{
+    for (size_t i = 0; i < SOURCE_COUNT; i++) {
+        if (source & (1 << i)) {
+            _levels[i] = level;
+        }
+    }
+
+    /* a dispatch in progress reports the requests made by the handler before returning */
+    if (!_dispatching && !_event.pending()) {
+        _event.post(std::chrono::milliseconds(0));
+    }
+}
+
+AlertLevel AlertDispatcher::get_level() const
+{
+    AlertLevel level = AlertLevel::NO_ALERT;
+
+    for (AlertLevel source_level : _levels) {
+        if (source_level > level) {
+            level = source_level;
+        }
+    }
+
+    return level;
+}
+
+uint8_t AlertDispatcher::get_sources() const
+{
+    uint8_t sources = 0;
+
+    for (size_t i = 0; i < SOURCE_COUNT; i++) {
+        if (_levels[i] != AlertLevel::NO_ALERT) {
+            sources |= 1 << i;
+        }
+    }
+
+    return sources;
+}
+
+void AlertDispatcher::dispatch()
+{
+    _dispatching = true;
+
+    while (get_level() != _reported_level || get_sources() != _reported_sources) {
+        _reported_level = get_level();
+        _reported_sources = get_sources();
+
+        if (_handler) {
+            _handler->on_alert_changed(_reported_level, _reported_sources);
+        }
+    }
+
+    _dispatching = false;
+}
+
+} // namespace ble
@@ -0,0 +1,168 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_GATT_CACHED_VALUE_H
+#define BLE_GATT_CACHED_VALUE_H
+
+#include "ble/GattServer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ble {
+
+namespace detail {
+
+/*
+ * Compare Size bytes as a sequence of the widest words that fit, the loads are unaligned-safe and the whole
+ * comparison is unrolled at compile time. Values larger than a few words are left to memcmp.
+ */
+template<size_t Size, bool Small = (Size <= 32)>
+struct bytes_equal {
+    static bool apply(const uint8_t *lhs, const uint8_t *rhs)
+    {
+        return memcmp(lhs, rhs, Size) == 0;
+    }
+};
+
+template<size_t Size>
+struct bytes_equal<Size, true> {
+    static constexpr size_t chunk = (Size >= 8) ? 8 : (Size >= 4) ? 4 : (Size >= 2) ? 2 : 1;
+
+    using word_t =
+        typename std::conditional<(chunk == 8), uint64_t,
+        typename std::conditional<(chunk == 4), uint32_t,
+        typename std::conditional<(chunk == 2), uint16_t, uint8_t>::type>::type>::type;
+
+    static bool apply(const uint8_t *lhs, const uint8_t *rhs)
+    {
+        word_t lhs_word;
+        word_t rhs_word;
+        memcpy(&lhs_word, lhs, chunk);
+        memcpy(&rhs_word, rhs, chunk);
+
+        return (lhs_word == rhs_word) && bytes_equal<Size - chunk>::apply(lhs + chunk, rhs + chunk);
+    }
+};
+
+template<>
+struct bytes_equal<0, true> {
+    static bool apply(const uint8_t *, const uint8_t *)
+    {
+        return true;
+    }
+};
+
+} // namespace detail
+
+/**
+ * Cached Value
+ *
+ * @par purpose
+ * Copy of the last value written to a characteristic, so that writing the same bytes again does not reach
+ * the GattServer. Every write of a characteristic with the notify or indicate property sends an update to
+ * its subscribers; skipping the unchanged ones saves the copy into the stack and the radio traffic.
+ *
+ * @par usage
+ * Write the characteristic through write() instead of GattServer::write(). Call invalidate() when the value
+ * held by the stack may no longer match the cache, for instance when a new client subscribes and must
+ * receive the next value even if it did not change. The counters tell how many writes reached the
+ * GattServer and how many were suppressed.
+ *
+ * @tparam Size Length of the value in bytes
+ */
+template<size_t Size>
+class CachedValue {
+    static_assert(Size > 0, "A cached value holds at least one byte");
+
+public:
+    /**
+     * Write @p value to the attribute @p handle of @p server unless it is the last value written.
+     *
+     * @param local_only Only update the value held by the stack, the subscribers are not sent it. For
+     * services that send the updates to each connection themselves.
+     *
+     * @return BLE_ERROR_NONE if the value was written or unchanged, the error of GattServer::write() otherwise.
+     */
+    ble_error_t write(GattServer &server, GattAttribute::Handle_t handle, const uint8_t *value, bool local_only = false)
+    {
+        if (_valid && detail::bytes_equal<Size>::apply(_value, value)) {
+            _suppressed_writes++;
+            return BLE_ERROR_NONE;
+        }
+
+        ble_error_t error = server.write(handle, value, Size, local_only);
+
+        /* after a failed write the stack may hold either value */
+        _valid = (error == BLE_ERROR_NONE);
+        if (_valid) {
+            memcpy(_value, value, Size);
+            _writes++;
+        }
+
+        return error;
+    }
+
+    /**
+     * @return true if @p value differs from the last value written
+     */
+    bool changed(const uint8_t *value) const
+    {
+        return !_valid || !detail::bytes_equal<Size>::apply(_value, value);
+    }
+
+    /**
+     * Forget the last value written, the next write reaches the GattServer.
+     */
+    void invalidate()
+    {
+        _valid = false;
+    }
+
+    /**
+     * @return Number of writes that reached the GattServer
+     */
+    uint32_t writes() const
+    {
+        return _writes;
+    }
+
+    /**
+     * @return Number of writes suppressed because the value had not changed
+     */
+    uint32_t suppressed_writes() const
+    {
+        return _suppressed_writes;
+    }
+
+    static constexpr size_t size()
+    {
+        return Size;
+    }
+
+private:
+    uint8_t _value[Size] = {};
+    bool _valid = false;
+    uint32_t _writes = 0;
+    uint32_t _suppressed_writes = 0;
+};
+
+} // namespace ble
+
+#endif // BLE_GATT_CACHED_VALUE_H
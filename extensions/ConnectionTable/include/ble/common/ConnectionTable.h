@@ -0,0 +1,206 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_COMMON_CONNECTION_TABLE_H
+#define BLE_COMMON_CONNECTION_TABLE_H
+
+#include "ble/common/BLETypes.h"
+
+#include <cstddef>
+
+namespace ble {
+
+/**
+ * Connection Table
+ *
+ * @par purpose
+ * Fixed capacity map from connection handles to per-connection state, for services that need to
+ * keep state scoped to each connection without allocating from the heap.
+ *
+ * @par usage
+ * Insert an entry when a connection completes, look it up with find() in GATT callbacks and erase it when
+ * the connection is lost. The table uses open addressing with linear probing; controllers hand out small
+ * consecutive connection handles so lookups are usually resolved by the first slot probed.
+ *
+ * @tparam T Per-connection state, must be default constructible and copy assignable.
+ * @tparam MaxConnections Maximum number of connections tracked.
+ */
+template<typename T, size_t MaxConnections>
+class ConnectionTable {
+    static_assert(MaxConnections > 0, "A connection table must hold at least one connection");
+
+public:
+    /**
+     * @return The state of @p connection_handle or nullptr if the connection is not in the table.
+     */
+    T *find(connection_handle_t connection_handle)
+    {
+        size_t index = find_index(connection_handle);
+
+        return (index == MaxConnections) ? nullptr : &_slots[index].value;
+    }
+
+    /**
+     * Add @p connection_handle to the table with a default constructed state.
+     *
+     * @return The state of @p connection_handle, existing if it was already present, or nullptr if
+     * the table is full.
+     */
+    T *insert(connection_handle_t connection_handle)
+    {
+        T *existing = find(connection_handle);
+        if (existing) {
+            return existing;
+        }
+
+        if (_size == MaxConnections) {
+            return nullptr;
+        }
+
+        size_t index = home(connection_handle);
+        while (_slots[index].used) {
+            index = next(index);
+        }
+
+        Slot &slot = _slots[index];
+        slot.used = true;
+        slot.connection_handle = connection_handle;
+        slot.value = T();
+        _size++;
+
+        return &slot.value;
+    }
+
+    /**
+     * Remove @p connection_handle from the table.
+     *
+     * @return true if the connection was in the table.
+     */
+    bool erase(connection_handle_t connection_handle)
+    {
+        size_t hole = find_index(connection_handle);
+        if (hole == MaxConnections) {
+            return false;
+        }
+
+        _slots[hole].used = false;
+        _size--;
+
+        /* shift back the entries that were displaced past the freed slot so that lookups stay correct */
+        size_t index = hole;
+        while (true) {
+            index = next(index);
+            if (!_slots[index].used) {
+                break;
+            }
+
+            size_t slot_home = home(_slots[index].connection_handle);
+            bool in_place = (hole <= index) ?
+                            ((hole < slot_home) && (slot_home <= index)) :
+                            ((hole < slot_home) || (slot_home <= index));
+
+            if (!in_place) {
+                _slots[hole] = _slots[index];
+                _slots[index].used = false;
+                hole = index;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Call @p f with the connection handle and state of every connection in the table.
+     *
+     * @note The table must not be modified from within @p f.
+     */
+    template<typename F>
+    void for_each(F f)
+    {
+        for (Slot &slot : _slots) {
+            if (slot.used) {
+                f(slot.connection_handle, slot.value);
+            }
+        }
+    }
+
+    void clear()
+    {
+        for (Slot &slot : _slots) {
+            slot.used = false;
+        }
+        _size = 0;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    bool full() const
+    {
+        return _size == MaxConnections;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return MaxConnections;
+    }
+
+private:
+    struct Slot {
+        bool used = false;
+        connection_handle_t connection_handle = 0;
+        T value{};
+    };
+
+    static size_t home(connection_handle_t connection_handle)
+    {
+        return connection_handle % MaxConnections;
+    }
+
+    static size_t next(size_t index)
+    {
+        return (index + 1 == MaxConnections) ? 0 : index + 1;
+    }
+
+    /* index of the slot holding connection_handle or MaxConnections if it is not in the table */
+    size_t find_index(connection_handle_t connection_handle) const
+    {
+        size_t index = home(connection_handle);
+
+        for (size_t probe = 0; probe < MaxConnections; probe++) {
+            const Slot &slot = _slots[index];
+            if (!slot.used) {
+                break;
+            }
+            if (slot.connection_handle == connection_handle) {
+                return index;
+            }
+            index = next(index);
+        }
+
+        return MaxConnections;
+    }
+
+    Slot _slots[MaxConnections];
+    size_t _size = 0;
+};
+
+} // namespace ble
+
+#endif // BLE_COMMON_CONNECTION_TABLE_H
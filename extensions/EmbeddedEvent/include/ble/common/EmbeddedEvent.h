@@ -0,0 +1,97 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_COMMON_EMBEDDED_EVENT_H
+#define BLE_COMMON_EMBEDDED_EVENT_H
+
+#include "events/EventQueue.h"
+#include "events/UserAllocatedEvent.h"
+#include "platform/Callback.h"
+
+#include <chrono>
+
+namespace ble {
+
+/**
+ * Embedded Event
+ *
+ * @par purpose
+ * Event owned by its user and posted to an event queue without allocating from the pool of the queue.
+ * Posting cannot fail: timeouts and periodic updates do not compete with the application for event memory
+ * and are not lost when the pool is exhausted.
+ *
+ * @par usage
+ * Embed an EmbeddedEvent in the object that needs to be called back and post it with post(). Posting a
+ * pending event moves it. A periodic event keeps being dispatched until it is cancelled, including from
+ * its own handler.
+ *
+ * @attention A one-shot event must not be posted again from its own handler, give it a period instead.
+ */
+class EmbeddedEvent {
+public:
+    /**
+     * Constructor
+     *
+     * @param event_queue EventQueue object the event is dispatched from
+     * @param handler Function called from the event queue
+     */
+    EmbeddedEvent(events::EventQueue &event_queue, mbed::Callback<void()> handler);
+
+    /**
+     * Destructor
+     *
+     * Cancel the event if it is pending.
+     */
+    ~EmbeddedEvent();
+
+    EmbeddedEvent(const EmbeddedEvent&) = delete;
+    EmbeddedEvent &operator=(const EmbeddedEvent&) = delete;
+
+    /**
+     * Dispatch the handler after @p delay then, if @p period is positive, every @p period.
+     * If the event is pending it is cancelled first.
+     */
+    void post(std::chrono::milliseconds delay, std::chrono::milliseconds period = std::chrono::milliseconds(0));
+
+    /**
+     * Cancel the event
+     *
+     * @return true if the event was pending
+     */
+    bool cancel();
+
+    /**
+     * @return true if the event is posted and, unless it is periodic, has not been dispatched yet
+     */
+    bool pending() const
+    {
+        return _pending;
+    }
+
+private:
+    void dispatch();
+
+    mbed::Callback<void()> _handler;
+    std::chrono::milliseconds _period{0};
+    bool _pending = false;
+
+    events::UserAllocatedEvent<mbed::Callback<void()>, void()> _event;
+};
+
+} // namespace ble
+
+#endif // BLE_COMMON_EMBEDDED_EVENT_H
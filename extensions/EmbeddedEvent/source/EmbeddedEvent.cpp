@@ -0,0 +1,66 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/common/EmbeddedEvent.h"
+
+namespace ble {
+
+EmbeddedEvent::EmbeddedEvent(events::EventQueue &event_queue, mbed::Callback<void()> handler) :
+    _handler(handler),
+    _event(&event_queue, mbed::callback(this, &EmbeddedEvent::dispatch))
+{
+}
+
+EmbeddedEvent::~EmbeddedEvent()
+{
+    cancel();
+}
+
+void EmbeddedEvent::post(std::chrono::milliseconds delay, std::chrono::milliseconds period)
+{
+    cancel();
+
+    _period = period;
+    _pending = true;
+
+    _event.delay(delay.count());
+    _event.period((period > std::chrono::milliseconds(0)) ? period.count() : -1);
+    /* the memory of the event is ours, posting it cannot fail */
+    _event.call();
+}
+
+bool EmbeddedEvent::cancel()
+{
+    if (!_pending) {
+        return false;
+    }
+
+    _event.cancel();
+    _pending = false;
+    return true;
+}
+
+void EmbeddedEvent::dispatch()
+{
+    if (_period <= std::chrono::milliseconds(0)) {
+        _pending = false;
+    }
+
+    _handler();
+}
+
+} // namespace ble
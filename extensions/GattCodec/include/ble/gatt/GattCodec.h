@@ -0,0 +1,273 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_GATT_GATT_CODEC_H
+#define BLE_GATT_GATT_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace ble {
+
+/**
+ * GATT Codec
+ *
+ * @par purpose
+ * Encoders and decoders for the formats used by SIG characteristic values. Values are read from and
+ * written to the attribute buffer in place, independently of the byte order of the host, and every
+ * function is constexpr.
+ *
+ * @par usage
+ * Each format is a type exposing its encoded size, the type of a decoded value and static decode() and
+ * encode() functions working on a raw pointer. Use Format::size to check the length of received data
+ * before decoding it. When the buffer is an array, prefer codec::decode() and codec::encode(): the offset
+ * is a template parameter and accesses past the end of the array fail to compile.
+ *
+ * @code
+ * uint8_t value[7];
+ * codec::encode<codec::uint8>(value, 0x01);
+ * codec::encode<codec::uint16_le, 1>(value, vendor_id);
+ * @endcode
+ *
+ * @note The formats are defined in the GATT Specification Supplement, available at
+ * https://www.bluetooth.com/specifications/specs/
+ */
+namespace codec {
+
+/**
+ * Unsigned little endian integer of @p Size bytes, decoded to the smallest standard type that holds it.
+ * When encoding, the bits of the value above Size bytes are ignored.
+ */
+template<size_t Size>
+struct uint_le {
+    static_assert(Size > 0 && Size <= 8, "Unsigned integers are 1 to 8 bytes long");
+
+    static constexpr size_t size = Size;
+
+    using value_type =
+        typename std::conditional<(Size <= 1), uint8_t,
+        typename std::conditional<(Size <= 2), uint16_t,
+        typename std::conditional<(Size <= 4), uint32_t, uint64_t>::type>::type>::type;
+
+    /** Largest value of the format */
+    static constexpr value_type max = static_cast<value_type>(
+        (Size == sizeof(value_type)) ? std::numeric_limits<value_type>::max() :
+        ((static_cast<uint64_t>(1) << (8 * Size)) - 1)
+    );
+
+    static constexpr value_type decode(const uint8_t *data)
+    {
+        value_type value = 0;
+        for (size_t i = 0; i < Size; i++) {
+            value |= static_cast<value_type>(static_cast<value_type>(data[i]) << (8 * i));
+        }
+        return value;
+    }
+
+    static constexpr void encode(uint8_t *data, value_type value)
+    {
+        for (size_t i = 0; i < Size; i++) {
+            data[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+};
+
+template<size_t Size>
+constexpr size_t uint_le<Size>::size;
+template<size_t Size>
+constexpr typename uint_le<Size>::value_type uint_le<Size>::max;
+
+using uint8     = uint_le<1>;
+using uint16_le = uint_le<2>;
+using uint24_le = uint_le<3>;
+using uint32_le = uint_le<4>;
+using uint40_le = uint_le<5>;
+using uint48_le = uint_le<6>;
+
+/** Date Time characteristic format, the time of day in the Gregorian calendar */
+struct date_time {
+    static constexpr size_t size = 7;
+
+    struct value_type {
+        /** Year, 1582 to 9999, 0 if unknown */
+        uint16_t year;
+        /** Month of the year, 1 (January) to 12 (December), 0 if unknown */
+        uint8_t month;
+        /** Day of the month, 1 to 31, 0 if unknown */
+        uint8_t day;
+        /** Number of hours past midnight, 0 to 23 */
+        uint8_t hours;
+        /** Number of minutes since the start of the hour, 0 to 59 */
+        uint8_t minutes;
+        /** Number of seconds since the start of the minute, 0 to 59 */
+        uint8_t seconds;
+    };
+
+    static constexpr value_type decode(const uint8_t *data)
+    {
+        return value_type{
+            uint16_le::decode(data),
+            data[2],
+            data[3],
+            data[4],
+            data[5],
+            data[6]
+        };
+    }
+
+    static constexpr void encode(uint8_t *data, const value_type &value)
+    {
+        uint16_le::encode(data, value.year);
+        data[2] = value.month;
+        data[3] = value.day;
+        data[4] = value.hours;
+        data[5] = value.minutes;
+        data[6] = value.seconds;
+    }
+};
+
+/**
+ * IEEE 11073-20601 floating point number: mantissa * 10^exponent.
+ *
+ * @tparam Raw Format of the encoded number
+ * @tparam MantissaBits Number of bits of the two's complement mantissa, the exponent uses the remaining bits
+ * @tparam Mantissa Signed type holding the decoded mantissa
+ */
+template<typename Raw, uint8_t MantissaBits, typename Mantissa>
+struct ieee11073_float {
+    static constexpr size_t size = Raw::size;
+
+    struct value_type {
+        Mantissa mantissa;
+        int8_t exponent;
+    };
+
+    /* special values are encoded with a zero exponent and the mantissas below */
+    static constexpr Mantissa MANTISSA_MAX    = (1L << (MantissaBits - 1)) - 3;
+    static constexpr Mantissa NAN_MANTISSA    = (1L << (MantissaBits - 1)) - 1;
+    static constexpr Mantissa NRES_MANTISSA   = -(1L << (MantissaBits - 1));
+    static constexpr Mantissa PLUS_INFINITY_MANTISSA  = (1L << (MantissaBits - 1)) - 2;
+    static constexpr Mantissa MINUS_INFINITY_MANTISSA = -(1L << (MantissaBits - 1)) + 2;
+
+    static constexpr value_type NaN            = { NAN_MANTISSA, 0 };
+    /** Not at this resolution */
+    static constexpr value_type NRes           = { NRES_MANTISSA, 0 };
+    static constexpr value_type PLUS_INFINITY  = { PLUS_INFINITY_MANTISSA, 0 };
+    static constexpr value_type MINUS_INFINITY = { MINUS_INFINITY_MANTISSA, 0 };
+
+    /**
+     * @return true if @p value is one of the special values, NaN, NRes, +INFINITY, -INFINITY or reserved
+     */
+    static constexpr bool is_special(const value_type &value)
+    {
+        return (value.exponent == 0) && ((value.mantissa > MANTISSA_MAX) || (value.mantissa < -MANTISSA_MAX));
+    }
+
+    static constexpr value_type decode(const uint8_t *data)
+    {
+        const uint32_t raw = Raw::decode(data);
+
+        /* sign extend both fields by moving them to the top of a 32-bit word */
+        const int32_t mantissa = static_cast<int32_t>(raw << (32 - MantissaBits)) >> (32 - MantissaBits);
+        const int32_t exponent = static_cast<int32_t>(raw << (32 - 8 * Raw::size)) >> (32 - EXPONENT_BITS);
+
+        return value_type{ static_cast<Mantissa>(mantissa), static_cast<int8_t>(exponent) };
+    }
+
+    /**
+     * Encode @p value. The mantissa and exponent must fit in their fields.
+     */
+    static constexpr void encode(uint8_t *data, const value_type &value)
+    {
+        Raw::encode(data, static_cast<typename Raw::value_type>(
+            ((static_cast<uint32_t>(value.exponent) << MantissaBits) & ~MANTISSA_MASK) |
+            (static_cast<uint32_t>(value.mantissa) & MANTISSA_MASK)
+        ));
+    }
+
+    /**
+     * @return @p value as a float, NaN for NaN, NRes and reserved values
+     */
+    static constexpr float to_float(const value_type &value)
+    {
+        if (is_special(value)) {
+            return (value.mantissa == PLUS_INFINITY_MANTISSA) ? std::numeric_limits<float>::infinity() :
+                   (value.mantissa == MINUS_INFINITY_MANTISSA) ? -std::numeric_limits<float>::infinity() :
+                   std::numeric_limits<float>::quiet_NaN();
+        }
+
+        float result = value.mantissa;
+        for (int8_t exponent = value.exponent; exponent > 0; exponent--) {
+            result *= 10;
+        }
+        for (int8_t exponent = value.exponent; exponent < 0; exponent++) {
+            result /= 10;
+        }
+        return result;
+    }
+
+private:
+    static constexpr uint8_t EXPONENT_BITS = (8 * Raw::size) - MantissaBits;
+    static constexpr uint32_t MANTISSA_MASK = (1UL << MantissaBits) - 1;
+};
+
+template<typename Raw, uint8_t MantissaBits, typename Mantissa>
+constexpr size_t ieee11073_float<Raw, MantissaBits, Mantissa>::size;
+template<typename Raw, uint8_t MantissaBits, typename Mantissa>
+constexpr Mantissa ieee11073_float<Raw, MantissaBits, Mantissa>::MANTISSA_MAX;
+template<typename Raw, uint8_t MantissaBits, typename Mantissa>
+constexpr typename ieee11073_float<Raw, MantissaBits, Mantissa>::value_type ieee11073_float<Raw, MantissaBits, Mantissa>::NaN;
+template<typename Raw, uint8_t MantissaBits, typename Mantissa>
+constexpr typename ieee11073_float<Raw, MantissaBits, Mantissa>::value_type ieee11073_float<Raw, MantissaBits, Mantissa>::NRes;
+template<typename Raw, uint8_t MantissaBits, typename Mantissa>
+constexpr typename ieee11073_float<Raw, MantissaBits, Mantissa>::value_type ieee11073_float<Raw, MantissaBits, Mantissa>::PLUS_INFINITY;
+template<typename Raw, uint8_t MantissaBits, typename Mantissa>
+constexpr typename ieee11073_float<Raw, MantissaBits, Mantissa>::value_type ieee11073_float<Raw, MantissaBits, Mantissa>::MINUS_INFINITY;
+
+/** 16-bit SFLOAT: 4-bit exponent and 12-bit mantissa */
+using sfloat = ieee11073_float<uint16_le, 12, int16_t>;
+
+/** 32-bit FLOAT: 8-bit exponent and 24-bit mantissa */
+using float32 = ieee11073_float<uint32_le, 24, int32_t>;
+
+/**
+ * Decode the value in @p Format at @p Offset of @p data.
+ */
+template<typename Format, size_t Offset = 0, size_t N>
+constexpr typename Format::value_type decode(const uint8_t (&data)[N])
+{
+    static_assert(Offset + Format::size <= N, "Value out of the bounds of the buffer");
+    return Format::decode(data + Offset);
+}
+
+/**
+ * Encode @p value in @p Format at @p Offset of @p data.
+ */
+template<typename Format, size_t Offset = 0, size_t N>
+constexpr void encode(uint8_t (&data)[N], const typename Format::value_type &value)
+{
+    static_assert(Offset + Format::size <= N, "Value out of the bounds of the buffer");
+    Format::encode(data + Offset, value);
+}
+
+} // namespace codec
+
+} // namespace ble
+
+#endif // BLE_GATT_GATT_CODEC_H
@@ -0,0 +1,133 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_COMMON_COMMAND_MAILBOX_H
+#define BLE_COMMON_COMMAND_MAILBOX_H
+
+#include "ble/common/MpscRing.h"
+#include "events/EventQueue.h"
+#include "events/UserAllocatedEvent.h"
+#include "platform/Callback.h"
+#include "platform/mbed_atomic.h"
+
+#include <cstddef>
+
+namespace ble {
+
+/**
+ * Command Mailbox
+ *
+ * @par purpose
+ * Fixed size queue of commands posted from any thread or interrupt handler and handled from an event queue.
+ * A service whose state belongs to the thread dispatching the event queue takes commands from the rest of
+ * the application through a command mailbox: posting neither locks, blocks nor allocates.
+ *
+ * @par usage
+ * Post commands with post(), it returns false if the mailbox is full. They are handled in the order they were
+ * posted, all those pending at once, from the event queue.
+ *
+ * The first command posted after the mailbox is drained posts one of two events owned by the mailbox, the
+ * others find it already scheduled. The events alternate because an event cannot be posted again while it is
+ * being dispatched, which is when a command posted during the drain schedules the next one.
+ *
+ * @note The event queue double of the unit tests is not thread-safe: commands posted from several threads
+ * must be dispatched once the threads are joined.
+ *
+ * @tparam T Type of the commands, copied into the mailbox
+ * @tparam Capacity Number of commands the mailbox holds, a power of two
+ */
+template<typename T, size_t Capacity>
+class CommandMailbox {
+public:
+    /**
+     * Constructor
+     *
+     * @param event_queue EventQueue object the commands are handled from
+     * @param handler Function called from the event queue with each command
+     */
+    CommandMailbox(events::EventQueue &event_queue, mbed::Callback<void(const T &)> handler) :
+        _handler(handler),
+        _events{
+            {&event_queue, mbed::callback(this, &CommandMailbox::dispatch)},
+            {&event_queue, mbed::callback(this, &CommandMailbox::dispatch)}
+        }
+    {
+    }
+
+    /**
+     * Destructor
+     *
+     * Cancel the dispatch of the commands pending, they are dropped.
+     */
+    ~CommandMailbox()
+    {
+        _events[0].cancel();
+        _events[1].cancel();
+    }
+
+    CommandMailbox(const CommandMailbox&) = delete;
+    CommandMailbox &operator=(const CommandMailbox&) = delete;
+
+    /**
+     * Post @p command, to be handled from the event queue. Callable from any thread or interrupt handler.
+     *
+     * @return false if the mailbox is full, the command is dropped
+     */
+    bool post(const T &command)
+    {
+        if (!_commands.push(command)) {
+            return false;
+        }
+
+        /* the producer finding the mailbox drained schedules the dispatch, the others rely on it */
+        if (!core_util_atomic_exchange_bool(&_scheduled, true)) {
+            schedule();
+        }
+
+        return true;
+    }
+
+private:
+    void schedule()
+    {
+        /* only the producer that set _scheduled gets here until the next drain, _next is not shared */
+        _next ^= 1;
+        /* the memory of the event is ours and it is not in the queue, posting it cannot fail */
+        _events[_next].call();
+    }
+
+    void dispatch()
+    {
+        /* cleared before draining: a command published after the drain stopped schedules another */
+        core_util_atomic_exchange_bool(&_scheduled, false);
+
+        T command;
+        while (_commands.pop(command)) {
+            _handler(command);
+        }
+    }
+
+    mbed::Callback<void(const T &)> _handler;
+    MpscRing<T, Capacity> _commands;
+    volatile bool _scheduled = false;
+    events::UserAllocatedEvent<mbed::Callback<void()>, void()> _events[2];
+    uint8_t _next = 0;
+};
+
+} // namespace ble
+
+#endif // BLE_COMMON_COMMAND_MAILBOX_H
@@ -0,0 +1,152 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_COMMON_MAILBOX_H
+#define BLE_COMMON_MAILBOX_H
+
+#include "ble/common/EmbeddedEvent.h"
+#include "events/EventQueue.h"
+#include "platform/Callback.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ble {
+
+/**
+ * Mailbox
+ *
+ * @par purpose
+ * Fixed size queue of messages handled later from an event queue. A service posts the events of its user
+ * to a mailbox instead of calling the user's handlers from the stack callbacks: however slow the handlers,
+ * the stack finishes processing the event, or replies to the request of the peer, in a bounded time.
+ *
+ * @par usage
+ * Post messages with post(), from the thread dispatching the event queue, which is also the one processing
+ * the BLE events in most applications. They are handled in order, all at once, by a single embedded event:
+ * posting never allocates and never calls the handler.
+ *
+ * If the mailbox is full, the message posted is dropped and counted by dropped(). Size the mailbox for the
+ * events raised between two dispatches of the event queue.
+ *
+ * @tparam T Type of the messages, copied into the mailbox
+ * @tparam Capacity Number of messages the mailbox holds
+ */
+template<typename T, size_t Capacity>
+class Mailbox {
+    static_assert(Capacity > 0, "A mailbox holds at least one message");
+
+public:
+    /**
+     * Constructor
+     *
+     * @param event_queue EventQueue object the messages are handled from
+     * @param handler Function called from the event queue with each message
+     */
+    Mailbox(events::EventQueue &event_queue, mbed::Callback<void(const T &)> handler) :
+        _handler(handler),
+        _event(event_queue, mbed::callback(this, &Mailbox::dispatch))
+    {
+    }
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox &operator=(const Mailbox&) = delete;
+
+    /**
+     * Post @p message, to be handled from the event queue.
+     *
+     * @return false if the mailbox is full, the message is dropped
+     */
+    bool post(const T &message)
+    {
+        if (_count == Capacity) {
+            _dropped++;
+            return false;
+        }
+
+        _messages[(_first + _count) % Capacity] = message;
+        _count++;
+
+        /* a mailbox being dispatched handles the messages posted by the handler before returning */
+        if (!_dispatching && !_event.pending()) {
+            _event.post(std::chrono::milliseconds(0));
+        }
+
+        return true;
+    }
+
+    /**
+     * Handle the messages pending now, from the caller.
+     */
+    void flush()
+    {
+        while (_count) {
+            const T message = _messages[_first];
+            _first = (_first + 1) % Capacity;
+            _count--;
+
+            _handler(message);
+        }
+    }
+
+    /**
+     * Drop the messages pending.
+     */
+    void clear()
+    {
+        _first = 0;
+        _count = 0;
+        _event.cancel();
+    }
+
+    /**
+     * @return Number of messages pending
+     */
+    size_t size() const
+    {
+        return _count;
+    }
+
+    /**
+     * @return Number of messages dropped because the mailbox was full
+     */
+    uint32_t dropped() const
+    {
+        return _dropped;
+    }
+
+private:
+    void dispatch()
+    {
+        _dispatching = true;
+        flush();
+        _dispatching = false;
+    }
+
+    mbed::Callback<void(const T &)> _handler;
+    T _messages[Capacity] = {};
+    size_t _first = 0;
+    size_t _count = 0;
+    uint32_t _dropped = 0;
+    bool _dispatching = false;
+    EmbeddedEvent _event;
+};
+
+} // namespace ble
+
+#endif // BLE_COMMON_MAILBOX_H
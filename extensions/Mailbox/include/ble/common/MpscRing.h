@@ -0,0 +1,138 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_COMMON_MPSC_RING_H
+#define BLE_COMMON_MPSC_RING_H
+
+#include "platform/mbed_atomic.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ble {
+
+/**
+ * Multiple Producer Single Consumer Ring
+ *
+ * @par purpose
+ * Fixed size queue that any number of threads and interrupt handlers push to, and a single thread pops from,
+ * without locking, blocking or allocating.
+ *
+ * @par usage
+ * Push with push() from anywhere, it returns false if the ring is full. Pop with pop() from one thread only.
+ *
+ * Each cell carries a sequence number telling whether it is free for the producer of a given position or
+ * holds the value of that position for the consumer. Producers claim a position by incrementing the tail,
+ * then publish the value by advancing the sequence of its cell. A producer interrupted between the two holds
+ * back the consumer at its cell: the values pushed after it are popped once it has published its own.
+ *
+ * The indexes are accessed with the atomic functions of mbed-os rather than std::atomic, whose compare and
+ * exchange is not lock-free on the cores without exclusive access instructions, such as Cortex-M0.
+ *
+ * @tparam T Type of the values, copied into the ring
+ * @tparam Capacity Number of values the ring holds, a power of two
+ */
+template<typename T, size_t Capacity>
+class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "The capacity of a ring is a power of two");
+
+public:
+    MpscRing()
+    {
+        for (size_t i = 0; i < Capacity; i++) {
+            _cells[i].sequence = static_cast<uint32_t>(i);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing &operator=(const MpscRing&) = delete;
+
+    /**
+     * Push @p value, from any thread or interrupt handler.
+     *
+     * @return false if the ring is full
+     */
+    bool push(const T &value)
+    {
+        uint32_t position = core_util_atomic_load_u32(&_tail);
+        Cell *cell;
+
+        for (;;) {
+            cell = &_cells[position & MASK];
+            const int32_t lag = static_cast<int32_t>(core_util_atomic_load_u32(&cell->sequence) - position);
+
+            if (lag == 0) {
+                /* the cell is free for this position, claim it unless another producer did first */
+                if (core_util_atomic_cas_u32(&_tail, &position, position + 1)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                /* the cell still holds the value of the previous lap */
+                return false;
+            } else {
+                position = core_util_atomic_load_u32(&_tail);
+            }
+        }
+
+        cell->value = value;
+        core_util_atomic_store_u32(&cell->sequence, position + 1);
+        return true;
+    }
+
+    /**
+     * Pop the oldest value published, from the consumer thread only.
+     *
+     * @return false if the ring is empty or its oldest position is still being written
+     */
+    bool pop(T &value)
+    {
+        Cell &cell = _cells[_head & MASK];
+
+        if (core_util_atomic_load_u32(&cell.sequence) != _head + 1) {
+            return false;
+        }
+
+        value = cell.value;
+        core_util_atomic_store_u32(&cell.sequence, _head + Capacity);
+        _head++;
+        return true;
+    }
+
+    /**
+     * @return true if no value is pushed, or the oldest one is still being written, as seen by the consumer
+     */
+    bool empty() const
+    {
+        return core_util_atomic_load_u32(&_cells[_head & MASK].sequence) != _head + 1;
+    }
+
+private:
+    static constexpr uint32_t MASK = Capacity - 1;
+
+    struct Cell {
+        volatile uint32_t sequence;
+        T value;
+    };
+
+    Cell _cells[Capacity];
+    volatile uint32_t _tail = 0;
+    uint32_t _head = 0;
+};
+
+} // namespace ble
+
+#endif // BLE_COMMON_MPSC_RING_H
@@ -0,0 +1,151 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_COMMON_TIMER_WHEEL_H
+#define BLE_COMMON_TIMER_WHEEL_H
+
+#include "ble/common/EmbeddedEvent.h"
+#include "events/EventQueue.h"
+#include "platform/Callback.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ble {
+
+/**
+ * Timer Wheel
+ *
+ * @par purpose
+ * Hierarchical timer wheel multiplexing any number of timeouts onto a single event queue event.
+ * Arming and cancelling a timer is O(1) and does not allocate: timers are owned by the caller.
+ *
+ * @par usage
+ * Embed a TimerWheel::Timer in the state that needs a timeout and arm it with arm(). The wheel ticks
+ * at the resolution given to the constructor, and only while at least one timer is armed.
+ * Timeouts are rounded up to whole ticks; a timer fires between its timeout and its timeout plus
+ * one resolution period after being armed. Timeouts longer than MAX_TICKS ticks are clamped.
+ * The tick is an EmbeddedEvent: arming a timer never fails, however full the event queue is.
+ *
+ * @attention An armed timer must be cancelled before it is destroyed.
+ */
+class TimerWheel {
+public:
+    /** Number of bits of the tick count resolved by each level of the wheel */
+    static const uint8_t SLOT_BITS = 4;
+    /** Number of levels of the wheel */
+    static const uint8_t LEVELS = 5;
+    /** Number of slots in each level */
+    static const uint32_t SLOTS = 1 << SLOT_BITS;
+    /** Longest timeout, in ticks */
+    static const uint32_t MAX_TICKS = (1UL << (SLOT_BITS * LEVELS)) - 1;
+
+    class Timer {
+    public:
+        Timer() = default;
+
+        Timer(const Timer&) = delete;
+        Timer &operator=(const Timer&) = delete;
+
+        /**
+         * @return true if the timer is armed and has not fired yet
+         */
+        bool armed() const
+        {
+            return _pprev != nullptr;
+        }
+
+    private:
+        friend class TimerWheel;
+
+        Timer *_next = nullptr;
+        Timer **_pprev = nullptr;
+        uint32_t _expiry = 0;
+        mbed::Callback<void()> _callback;
+    };
+
+    /**
+     * Constructor
+     *
+     * @param event_queue EventQueue object used to tick the wheel
+     * @param resolution Period of a tick
+     */
+    TimerWheel(events::EventQueue &event_queue, std::chrono::milliseconds resolution);
+
+    /**
+     * Destructor
+     *
+     * Cancel the pending tick. Timers still armed are not called.
+     */
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel &operator=(const TimerWheel&) = delete;
+
+    /**
+     * Arm @p timer to call @p callback after @p timeout. If the timer is already armed it is re-armed.
+     *
+     * @param timer Timer to arm
+     * @param timeout Time after which @p callback is called
+     * @param callback Function called from the event queue when the timer expires
+     */
+    void arm(Timer &timer, std::chrono::milliseconds timeout, mbed::Callback<void()> callback);
+
+    /**
+     * Cancel @p timer
+     *
+     * @return true if the timer was armed
+     */
+    bool cancel(Timer &timer);
+
+    /**
+     * @return Number of armed timers
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    std::chrono::milliseconds get_resolution() const
+    {
+        return _resolution;
+    }
+
+private:
+    void tick();
+
+    void stop_ticking();
+
+    void insert(Timer &timer);
+
+    static void unlink(Timer &timer);
+
+    void cascade(uint8_t level);
+
+    std::chrono::milliseconds _resolution;
+    EmbeddedEvent _tick_event;
+
+    Timer *_slots[LEVELS][SLOTS] = {};
+    uint32_t _now = 0;
+    size_t _size = 0;
+    bool _ticking = false;
+};
+
+} // namespace ble
+
+#endif // BLE_COMMON_TIMER_WHEEL_H
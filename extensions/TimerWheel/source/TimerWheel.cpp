@@ -0,0 +1,153 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/common/TimerWheel.h"
+
+namespace ble {
+
+TimerWheel::TimerWheel(events::EventQueue &event_queue, std::chrono::milliseconds resolution) :
+    _resolution(resolution),
+    _tick_event(event_queue, mbed::callback(this, &TimerWheel::tick))
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+    _tick_event.cancel();
+}
+
+void TimerWheel::arm(Timer &timer, std::chrono::milliseconds timeout, mbed::Callback<void()> callback)
+{
+    cancel(timer);
+
+    /* round up to whole ticks, a timer never fires in the tick it is armed in */
+    uint32_t ticks = 1;
+    if (timeout > _resolution) {
+        auto rounded = (timeout + _resolution - std::chrono::milliseconds(1)) / _resolution;
+        ticks = (rounded > MAX_TICKS) ? MAX_TICKS : static_cast<uint32_t>(rounded);
+    }
+
+    timer._expiry = _now + ticks;
+    timer._callback = callback;
+    insert(timer);
+    _size++;
+
+    if (!_tick_event.pending()) {
+        _tick_event.post(_resolution, _resolution);
+    }
+}
+
+bool TimerWheel::cancel(Timer &timer)
+{
+    if (!timer.armed()) {
+        return false;
+    }
+
+    unlink(timer);
+    _size--;
+
+    stop_ticking();
+
+    return true;
+}
+
+void TimerWheel::stop_ticking()
+{
+    /* a timer may be armed again later in the same tick, which decides when it ends */
+    if (_size == 0 && !_ticking) {
+        _tick_event.cancel();
+    }
+}
+
+void TimerWheel::insert(Timer &timer)
+{
+    uint32_t delta = timer._expiry - _now;
+
+    /* the level is the first one whose span covers the remaining ticks */
+    uint8_t level = 0;
+    while ((level < LEVELS - 1) && (delta >= (1UL << (SLOT_BITS * (level + 1))))) {
+        level++;
+    }
+
+    Timer *&head = _slots[level][(timer._expiry >> (SLOT_BITS * level)) & (SLOTS - 1)];
+
+    timer._next = head;
+    timer._pprev = &head;
+    if (head) {
+        head->_pprev = &timer._next;
+    }
+    head = &timer;
+}
+
+void TimerWheel::unlink(Timer &timer)
+{
+    *timer._pprev = timer._next;
+    if (timer._next) {
+        timer._next->_pprev = timer._pprev;
+    }
+    timer._next = nullptr;
+    timer._pprev = nullptr;
+}
+
+void TimerWheel::cascade(uint8_t level)
+{
+    Timer *&head = _slots[level][(_now >> (SLOT_BITS * level)) & (SLOTS - 1)];
+
+    Timer *timer = head;
+    head = nullptr;
+
+    /* the timers of this slot now expire within the span of a lower level */
+    while (timer) {
+        Timer *next = timer->_next;
+        insert(*timer);
+        timer = next;
+    }
+}
+
+void TimerWheel::tick()
+{
+    _ticking = true;
+    _now++;
+
+    for (uint8_t level = 1; level < LEVELS; level++) {
+        if ((_now & ((1UL << (SLOT_BITS * level)) - 1)) != 0) {
+            break;
+        }
+        cascade(level);
+    }
+
+    /* detach the expired timers so that callbacks can safely arm and cancel timers */
+    Timer *&head = _slots[0][_now & (SLOTS - 1)];
+    Timer *expired = head;
+    head = nullptr;
+    if (expired) {
+        expired->_pprev = &expired;
+    }
+
+    while (expired) {
+        Timer &timer = *expired;
+        unlink(timer);
+        _size--;
+        timer._callback();
+    }
+
+    /* the tick is periodic, it only has to stop when there is nothing left to wait for */
+    _ticking = false;
+    stop_ticking();
+}
+
+} // namespace ble
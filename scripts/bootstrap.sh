@@ -31,12 +31,21 @@ fi
 
 # Add symlinks
 symlink dependencies/mbed-os       tests/UNITTESTS/mbed-os
+symlink dependencies/mbed-os       tests/BENCHMARKS/mbed-os
+symlink dependencies/mbed-os       tests/SIMULATION/mbed-os
 
 symlink dependencies/mbed-os       tests/TESTS/LinkLoss/device/mbed-os
 symlink services/LinkLoss          tests/TESTS/LinkLoss/device/LinkLoss
+symlink extensions/ConnectionTable tests/TESTS/LinkLoss/device/ConnectionTable
+symlink extensions/EmbeddedEvent   tests/TESTS/LinkLoss/device/EmbeddedEvent
+symlink extensions/TimerWheel      tests/TESTS/LinkLoss/device/TimerWheel
+symlink extensions/GattCodec       tests/TESTS/LinkLoss/device/GattCodec
+symlink extensions/Mailbox         tests/TESTS/LinkLoss/device/Mailbox
+symlink extensions/AlertDispatcher tests/TESTS/LinkLoss/device/AlertDispatcher
 
 symlink dependencies/mbed-os       tests/TESTS/DeviceInformation/device/mbed-os
 symlink services/DeviceInformation tests/TESTS/DeviceInformation/device/DeviceInformation
+symlink extensions/GattCodec       tests/TESTS/DeviceInformation/device/GattCodec
 
 # Create mbed-os.lib for CMake builds
 echo "https://github.com/ARMmbed/mbed-os" > tests/TESTS/LinkLoss/device/mbed-os.lib
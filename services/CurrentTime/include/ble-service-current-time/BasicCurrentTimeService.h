@@ -0,0 +1,1530 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASIC_CURRENT_TIME_SERVICE_H
+#define BASIC_CURRENT_TIME_SERVICE_H
+
+#include "ble/BLE.h"
+
+#ifdef BLE_FEATURE_GATT_SERVER
+
+#include "ble/Gap.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+#include "events/EventQueue.h"
+#include "mbed_rtc_time.h"
+#include "rtos/Kernel.h"
+
+#include "ble-service-current-time/CivilCalendar.h"
+#include "ble-service-current-time/ClockDiscipline.h"
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+#include "ble-service-current-time/DstTable.h"
+#endif
+#include "ble-service-current-time/WallClock.h"
+#include "ble/common/ConnectionTable.h"
+#include "ble/common/EmbeddedEvent.h"
+#include "ble/gatt/CachedValue.h"
+#include "ble/gatt/GattCodec.h"
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+#include "ble/common/Mailbox.h"
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_COMMAND_MAILBOX
+#include "ble/common/CommandMailbox.h"
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+#include "kvstore_global_api/kvstore_global_api.h"
+#include "platform/mbed_error.h"
+#endif
+
+#include <ctime>
+
+/* updates are written to each subscriber on its own rather than once for all of them */
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_INDICATIONS || MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+#define BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION 1
+#else
+#define BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION 0
+#endif
+
+/**
+ * Current Time Service with static dispatch of its events
+ *
+ * @par purpose
+ * Implementation of the current time service calling its event handler at compile time. The handler
+ * is inlined in the time write path and a handler left empty compiles away: there is no vtable,
+ * no indirect call and no null check.
+ *
+ * @par usage
+ * Derive your handler from BasicCurrentTimeService<YourHandler> and hide on_current_time_changed() with your
+ * own function. It may be private if BasicCurrentTimeService<YourHandler> is a friend.
+ *
+ * @code
+ * class Clock : public BasicCurrentTimeService<Clock> {
+ * public:
+ *     using BasicCurrentTimeService<Clock>::BasicCurrentTimeService;
+ *
+ *     void on_current_time_changed(time_t current_time, uint8_t adjust_reason) { synchronised = true; }
+ *
+ *     bool synchronised = false;
+ * };
+ * @endcode
+ *
+ * Everything else behaves as described for CurrentTimeService, which is the instance of this template
+ * forwarding the event to a run-time EventHandler.
+ *
+ * @tparam Derived Class deriving from this template and handling its events
+ */
+template<typename Derived>
+class BasicCurrentTimeService : private ble::Gap::EventHandler, private ble::GattServer::EventHandler {
+public:
+    static const uint8_t MANUAL_TIME_UPDATE             = 1 << 0;
+    static const uint8_t EXTERNAL_REFERENCE_TIME_UPDATE = 1 << 1;
+    static const uint8_t CHANGE_OF_TIME_ZONE            = 1 << 2;
+    static const uint8_t CHANGE_OF_DST                  = 1 << 3;
+
+    /* period of the updates, sent while a client is subscribed and aligned on minute boundaries */
+    static constexpr std::chrono::seconds UPDATE_TIME_PERIOD = std::chrono::seconds(60);
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+    /* sources of the Reference Time Information characteristic */
+    static const uint8_t TIME_SOURCE_UNKNOWN = 0;
+    static const uint8_t TIME_SOURCE_MANUAL  = 4;
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+    /* DST offset of the Local Time Information characteristic if it is not known */
+    static const uint8_t DST_OFFSET_UNKNOWN = 255;
+#endif
+
+    /**
+     * Initialize the internal BLE object to @p ble and configure the current time characteristic
+     * with the appropriate UUID.
+     *
+     * @param ble BLE object to host the current time service
+     * @param event_queue EventQueue object to configure events and, if persist is enabled, save the time
+     * @param chainable_gap_event_handler ChainableGapEventHandler object to register multiple Gap events
+     * @param chainable_gatt_server_event_handler ChainableGattServerEventHandler object to register multiple
+     * GattServer events
+     *
+     * @attention The Initializer must be called after instantiating a current time service.
+     */
+    BasicCurrentTimeService(BLE &ble, events::EventQueue &event_queue,
+                            ChainableGapEventHandler &chainable_gap_event_handler,
+                            ChainableGattServerEventHandler &chainable_gatt_server_event_handler);
+
+    /**
+     * Cancel the pending periodic update
+     */
+    ~BasicCurrentTimeService();
+
+    BasicCurrentTimeService(const BasicCurrentTimeService&) = delete;
+    BasicCurrentTimeService &operator=(const BasicCurrentTimeService&) = delete;
+
+    /**
+     * Set the onCurrentTimeRead() and onCurrentTimeWritten() functions as the read authorization callback
+     * and write authorization callback, respectively for the current time characteristic.
+     * Add the current time service to the BLE device and chains of GAP and GattServer event handlers.
+     *
+     * If the persist configuration option is enabled, the time saved before the last reset is restored first.
+     *
+     * @return BLE_ERROR_NONE if the service was successfully added.
+     */
+    ble_error_t init();
+
+    /**
+     * Get the time in seconds since 00:00 January 1, 1970 plus a configurable offset.
+     *
+     * The real time clock is read once, when the service is constructed, then the time follows the kernel clock
+     * to the millisecond: setting the real time clock afterwards, with ::set_time() of mbed_rtc_time.h, does not
+     * change it. The drift of the local clock estimated from the times set so far is corrected.
+     *
+     * @return Time in seconds.
+     */
+    time_t get_time() const;
+
+    /**
+     * Get the time in seconds since 00:00 January 1, 1970 plus a configurable offset, and the fraction of
+     * the current second.
+     *
+     * @param fractions256 Set to the number of 1/256 fractions of a second elapsed since the returned time.
+     * @return Time in seconds.
+     */
+    time_t get_time(uint8_t &fractions256) const;
+
+    /**
+     * Set the time offset, i.e. the time in seconds beyond Epoch time.
+     *
+     * Unless @p adjust_reason includes MANUAL_TIME_UPDATE, CHANGE_OF_TIME_ZONE or CHANGE_OF_DST, the difference
+     * between @p host_time and the time predicted for now is measured as drift of the real time clock.
+     *
+     * The time changes at once. The subscribers are notified at the end of the update coalescing window, once for
+     * all the times set within it and with their adjust reasons merged.
+     *
+     * @param host_time Time in seconds according to your host.
+     * @param adjust_reason Bitmask using a combination of MANUAL_TIME_UPDATE, EXTERNAL_REFERENCE_TIME_UPDATE,
+     * CHANGE_OF_TIME_ZONE and CHANGE_OF_DST representing the reason for setting the time or zero if reason is unknown.
+     */
+    void set_time(time_t host_time, uint8_t adjust_reason);
+
+    /**
+     * Set the time offset to a time known to 1/256 of a second.
+     *
+     * @param host_time Time in seconds according to your host.
+     * @param fractions256 Number of 1/256 fractions of a second elapsed since @p host_time.
+     * @param adjust_reason Same as for set_time(time_t, uint8_t).
+     */
+    void set_time(time_t host_time, uint8_t fractions256, uint8_t adjust_reason);
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_COMMAND_MAILBOX
+    /**
+     * Same as set_time(time_t, uint8_t), from any thread or interrupt handler. The time is set from the event
+     * queue, advanced by the time the command waited there.
+     *
+     * @return false if the command mailbox is full, the time is left unchanged
+     */
+    bool post_set_time(time_t host_time, uint8_t adjust_reason);
+
+    /**
+     * Same as set_time(time_t, uint8_t, uint8_t), from any thread or interrupt handler.
+     *
+     * @return false if the command mailbox is full, the time is left unchanged
+     */
+    bool post_set_time(time_t host_time, uint8_t fractions256, uint8_t adjust_reason);
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+    /**
+     * @return Number of time changes never reported to the event handler because deferred-events-capacity of
+     * them were already waiting for the event queue
+     */
+    uint32_t get_dropped_event_count() const;
+#endif
+
+    /**
+     * @return Largest expected error of get_time(), growing with the time elapsed since the time was last set,
+     * or std::chrono::milliseconds::max() if the time was never set
+     */
+    std::chrono::milliseconds get_time_error_bound() const;
+
+    /**
+     * Set how long the notification of a time set waits for the following ones, the update-coalescing-window
+     * configuration option by default. Times set in a burst, for instance a change of time zone and of daylight
+     * saving time, are then notified once and the periodic update is re-armed once.
+     *
+     * @param window Coalescing window, zero to notify each time set immediately
+     */
+    void set_update_coalescing_window(std::chrono::milliseconds window)
+    {
+        _update_coalescing_window = window;
+    }
+
+    /**
+     * @return Conversion of kernel clock ticks to the time of get_time(), usable from any thread or interrupt
+     * handler without locking, for instance to stamp samples taken at a high rate
+     */
+    const WallClock &get_wall_clock() const
+    {
+        return _wall_clock;
+    }
+
+    /**
+     * @return Estimated drift of the real time clock in parts per billion, positive if the clock is slow
+     */
+    int32_t get_drift() const
+    {
+        return _clock.drift();
+    }
+
+    /**
+     * @return Reason of the last time adjustment, restored in init() if the persist configuration option is enabled
+     */
+    uint8_t get_adjust_reason() const
+    {
+        return _adjust_reason;
+    }
+
+    /**
+     * @return Number of updates of the current time characteristic sent to the subscribers
+     */
+    uint32_t get_update_count() const
+    {
+        return _current_time_value.writes();
+    }
+
+    /**
+     * @return Number of updates of the current time characteristic skipped because its value had not changed
+     */
+    uint32_t get_suppressed_update_count() const
+    {
+        return _current_time_value.suppressed_writes();
+    }
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+    /**
+     * @return Offset of the time zone from UTC in 15 minutes increments, the time-zone configuration option
+     */
+    static constexpr int8_t get_time_zone()
+    {
+        return MBED_CONF_BLE_SERVICE_CURRENT_TIME_TIME_ZONE;
+    }
+
+    /**
+     * @return Daylight saving time offset in 15 minutes increments at the time of get_time(), or
+     * DST_OFFSET_UNKNOWN if the time is out of the daylight saving time table
+     */
+    uint8_t get_dst_offset() const;
+#endif
+
+    /**
+     * Called if the current time characteristic is changed by the client. Hide it in Derived.
+     */
+    void on_current_time_changed(time_t current_time, uint8_t adjust_reason) { }
+
+private:
+    static constexpr uint16_t CURRENT_TIME_CHAR_VALUE_SIZE = 10;
+    /* resolutions of a time in whole seconds and of one in 1/256 fractions of a second, in milliseconds */
+    static constexpr int32_t SECONDS_RESOLUTION_MS = 1000;
+    static constexpr int32_t FRACTIONS256_RESOLUTION_MS = 4;
+
+    /**
+     * @return Local time in milliseconds: the real time clock read at construction, advanced by the kernel clock.
+     * Later changes of the real time clock are not followed.
+     */
+    int64_t local_time_ms() const
+    {
+        return _rtc_base_ms + (rtos::Kernel::Clock::now() - _tick_base).count();
+    }
+
+    /**
+     * @return Time in milliseconds since 00:00 January 1, 1970 plus the offset
+     */
+    int64_t get_time_ms() const;
+
+    void set_time_ms(int64_t host_time_ms, int32_t resolution, uint8_t adjust_reason);
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_COMMAND_MAILBOX
+    struct SetTimeCommand {
+        int64_t host_time_ms;
+        int32_t resolution;
+        uint8_t adjust_reason;
+        /* kernel clock when the command was posted, the host time was read then */
+        rtos::Kernel::Clock::time_point posted;
+    };
+
+    void execute(const SetTimeCommand &command);
+#endif
+
+    /**
+     * Publish the conversion of the clock discipline to the wall clock, in kernel clock ticks.
+     */
+    void publish_time();
+
+    Derived &derived()
+    {
+        return static_cast<Derived &>(*this);
+    }
+
+    void onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event) override;
+
+    void onUpdatesEnabled(const GattUpdatesEnabledCallbackParams &params) override;
+
+    void onUpdatesDisabled(const GattUpdatesDisabledCallbackParams &params) override;
+
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+    void onDataSent(const GattDataSentCallbackParams &params) override;
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_INDICATIONS
+    void onConfirmationReceived(const GattConfirmationReceivedCallbackParams &params) override;
+#endif
+
+    void onCurrentTimeRead(GattReadAuthCallbackParams *read_request);
+
+    void onCurrentTimeWritten(GattWriteAuthCallbackParams *write_request);
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+    struct TimeChange {
+        time_t current_time;
+        uint8_t adjust_reason;
+    };
+
+    void dispatch_time_change(const TimeChange &time_change);
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+    void onLocalTimeInformationRead(GattReadAuthCallbackParams *read_request);
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+    void onReferenceTimeInformationRead(GattReadAuthCallbackParams *read_request);
+#endif
+
+    void update_current_time_value(uint8_t adjust_reason);
+
+    /**
+     * Notify the time set and move the periodic update to the new minute boundary, now or at the end of the
+     * coalescing window
+     */
+    void time_update(uint8_t adjust_reason);
+
+    void coalesced_time_update();
+
+    /**
+     * Schedule the next update at the start of the next minute if there is at least one subscriber.
+     */
+    void start_periodic_time_update();
+
+    void periodic_time_update();
+
+    void stop_periodic_time_update();
+
+    void add_subscriber(ble::connection_handle_t connection_handle);
+
+    /**
+     * @param disconnected true if the connection is lost, false if the client only disabled the updates
+     */
+    void remove_subscriber(ble::connection_handle_t connection_handle, bool disconnected);
+
+    struct Subscriber {
+        /* false while an update sent before the client disabled the updates is still in flight */
+        bool subscribed = false;
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+        /* an update was sent and is neither confirmed nor acknowledged by onDataSent yet */
+        bool in_flight = false;
+        /* an update is waiting for the one in flight, its turn in the fan-out or the retry of a failed write */
+        bool pending = false;
+        /* reasons of the updates merged into the pending one */
+        uint8_t adjust_reason = 0;
+#endif
+    };
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+    /**
+     * Record saved in KVStore, its layout changes with its version
+     */
+    struct PersistedTime {
+        static const uint8_t VERSION = 2;
+
+        uint8_t version;
+        uint8_t adjust_reason;
+        /* ClockDiscipline state, in milliseconds and parts per billion */
+        int64_t anchor;
+        int64_t time_offset;
+        int32_t drift;
+        int32_t drift_uncertainty;
+    };
+
+    void restore_time();
+
+    /**
+     * Save the time from the event queue or, if it was saved less than persist-interval ago, at the end of the
+     * interval
+     */
+    void persist_time();
+
+    void save_time();
+
+    void persist_interval_end();
+#endif // MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+
+private:
+    MBED_PACKED(struct) CurrentTime {
+        CurrentTime() = default;
+
+        CurrentTime(const uint8_t *data);
+        CurrentTime(const CivilCalendar::DateTime &date_time);
+
+        bool valid();
+
+        /**
+         * @return Time in seconds since 00:00 January 1, 1970 represented by this value
+         */
+        time_t to_time();
+
+        /**
+         * @return Year in host byte order
+         */
+        uint16_t get_year() const {
+            return ble::codec::uint16_le::decode(year);
+        }
+
+        void set_year(uint16_t value) {
+            ble::codec::uint16_le::encode(year, value);
+        }
+
+        /**
+         * Year as defined by the Gregorian calendar, little endian.
+         * Valid range 1582 to 9999.
+         */
+        uint8_t  year[ble::codec::uint16_le::size];
+        /**
+         * Month of the year as defined by the Gregorian calendar.
+         * Valid range 1 (January) to 12 (December).
+         */
+        uint8_t  month;
+        /**
+         * Day of the month as defined by the Gregorian calendar.
+         * Valid range 1 to 31.
+         */
+        uint8_t  day;
+        /**
+         * Number of hours past midnight.
+         * Valid range 0 to 23.
+         */
+        uint8_t  hours;
+        /**
+         * Number of minutes since the start of the hour.
+         * Valid range 0 to 59.
+         */
+        uint8_t  minutes;
+        /**
+         * Number of seconds since the start of the minute.
+         * Valid range 0 to 59.
+         */
+        uint8_t  seconds;
+        /**
+         * Days of a seven-day week as specified in ISO 8601.
+         * Valid range from Monday (1) to Sunday (7)
+         */
+        uint8_t  weekday;
+        /**
+         * The number of 1/25 fractions of a second.
+         * Valid range 0-255
+         */
+        uint8_t  fractions256;
+        /**
+         * Reason(s) for adjusting the time.
+         */
+        uint8_t  adjust_reason;
+    };
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+    MBED_PACKED(struct) LocalTimeInformation {
+        /**
+         * Offset from UTC in number of 15 minutes increments.
+         * Valid range -48 to 56, -128 if unknown.
+         */
+        int8_t  time_zone;
+        /**
+         * Daylight saving time offset in number of 15 minutes increments.
+         * Valid values 0, 2, 4 and 8, 255 if unknown.
+         */
+        uint8_t dst_offset;
+    };
+
+    /* transitions from 2021 to 2099, generated at compile time */
+    using DstTableType = DstTable<2021, (DstRules::MBED_CONF_BLE_SERVICE_CURRENT_TIME_DST_RULES.save_minutes ? 79 : 1)>;
+
+    static constexpr DstTableType DST_TABLE{
+        DstRules::MBED_CONF_BLE_SERVICE_CURRENT_TIME_DST_RULES,
+        MBED_CONF_BLE_SERVICE_CURRENT_TIME_TIME_ZONE * 15
+    };
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+    MBED_PACKED(struct) ReferenceTimeInformation {
+        /**
+         * Source of the last time update.
+         */
+        uint8_t time_source;
+        /**
+         * Drift of the time since the last update in steps of 1/8 of a second.
+         * Valid range 0 to 253, 254 if larger, 255 if unknown.
+         */
+        uint8_t accuracy;
+        /**
+         * Days since the last update, 255 if 255 days or more.
+         */
+        uint8_t days_since_update;
+        /**
+         * Hours since the last update in addition to the days, 255 if 255 days or more.
+         */
+        uint8_t hours_since_update;
+    };
+#endif
+
+    /**
+     * Convert @p local_time to a CurrentTime value.
+     *
+     * The last conversion is cached; if @p local_time is less than a day ahead of it the cached
+     * value is advanced instead of being converted from scratch.
+     */
+    CurrentTime to_current_time(time_t local_time);
+
+    /**
+     * Convert @p local_time_ms to a CurrentTime value including the fraction of the second.
+     */
+    CurrentTime to_current_time_ms(int64_t local_time_ms);
+
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+    /**
+     * Send the newest time to @p connection_handle alone, with the adjust reasons of its pending updates
+     *
+     * @return true if the stack took the update, false if it stays pending
+     */
+    bool send_pending_current_time(ble::connection_handle_t connection_handle, Subscriber &subscriber);
+
+    /**
+     * Send the pending updates that are not behind one in flight: all of them, or the next one if the updates
+     * are fanned out. Schedule the remaining ones.
+     */
+    void send_pending_updates();
+
+    void end_of_transmission(ble::connection_handle_t connection_handle);
+#endif
+
+    BLE &_ble;
+    /* owned by the service, the update never competes with the application for event queue memory */
+    ble::EmbeddedEvent _periodic_update;
+    /* pending during the coalescing window, the adjust reasons of the times set meanwhile are accumulated */
+    ble::EmbeddedEvent _coalesced_update;
+    std::chrono::milliseconds _update_coalescing_window{MBED_CONF_BLE_SERVICE_CURRENT_TIME_UPDATE_COALESCING_WINDOW};
+    uint8_t _coalesced_adjust_reason = 0;
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+    /* periodic while updates wait for their turn in the fan-out or could not be written for lack of resources */
+    ble::EmbeddedEvent _pending_updates;
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+    /* updates the fan-out may still send before onDataSent acknowledges the ones in flight */
+    uint8_t _fan_out_credits = MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_CREDITS;
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+    /* pending while the last save is more recent than persist-interval, saves are deferred to its end */
+    ble::EmbeddedEvent _persist_interval;
+    bool _persist_deferred = false;
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+    /* the times written by clients, reported to the application from the event queue */
+    ble::Mailbox<TimeChange, MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS_CAPACITY> _time_changes;
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_COMMAND_MAILBOX
+    /* the times set by other threads and interrupt handlers, applied from the event queue */
+    ble::CommandMailbox<SetTimeCommand, MBED_CONF_BLE_SERVICE_CURRENT_TIME_COMMAND_MAILBOX_CAPACITY> _commands;
+#endif
+    ChainableGapEventHandler &_chainable_gap_event_handler;
+    ChainableGattServerEventHandler &_chainable_gatt_server_event_handler;
+
+    /* the kernel clock keeps running in sleep and, unlike a Timer, does not prevent deep sleep */
+    const int64_t _rtc_base_ms;
+    const rtos::Kernel::Clock::time_point _tick_base;
+
+    CurrentTime _current_time;
+    CivilCalendar::DateTime _calendar_cache{};
+    time_t _calendar_cache_time = 0;
+    bool _calendar_cache_valid = false;
+    ReadWriteGattCharacteristic<CurrentTime> _current_time_char;
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+    LocalTimeInformation _local_time_information{};
+    ReadOnlyGattCharacteristic<LocalTimeInformation> _local_time_information_char;
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+    ReferenceTimeInformation _reference_time_information{};
+    ReadOnlyGattCharacteristic<ReferenceTimeInformation> _reference_time_information_char;
+#endif
+    /* last value sent to the subscribers, an unchanged value is not sent again */
+    ble::CachedValue<CURRENT_TIME_CHAR_VALUE_SIZE> _current_time_value;
+    ClockDiscipline<MBED_CONF_BLE_SERVICE_CURRENT_TIME_DRIFT_HISTORY> _clock;
+    /* read by the application, written by the service each time _clock changes */
+    WallClock _wall_clock;
+    uint8_t _adjust_reason = 0;
+
+    ble::ConnectionTable<Subscriber, MBED_CONF_BLE_SERVICE_CURRENT_TIME_MAX_SUBSCRIBERS> _subscribers;
+    uint8_t _subscriber_count = 0;
+};
+
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::MANUAL_TIME_UPDATE;
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::EXTERNAL_REFERENCE_TIME_UPDATE;
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::CHANGE_OF_TIME_ZONE;
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::CHANGE_OF_DST;
+template<typename Derived>
+constexpr std::chrono::seconds BasicCurrentTimeService<Derived>::UPDATE_TIME_PERIOD;
+template<typename Derived>
+constexpr uint16_t BasicCurrentTimeService<Derived>::CURRENT_TIME_CHAR_VALUE_SIZE;
+template<typename Derived>
+constexpr int32_t BasicCurrentTimeService<Derived>::SECONDS_RESOLUTION_MS;
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::TIME_SOURCE_UNKNOWN;
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::TIME_SOURCE_MANUAL;
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::DST_OFFSET_UNKNOWN;
+template<typename Derived>
+constexpr typename BasicCurrentTimeService<Derived>::DstTableType BasicCurrentTimeService<Derived>::DST_TABLE;
+#endif
+template<typename Derived>
+constexpr int32_t BasicCurrentTimeService<Derived>::FRACTIONS256_RESOLUTION_MS;
+
+template<typename Derived>
+BasicCurrentTimeService<Derived>::BasicCurrentTimeService(BLE &ble, events::EventQueue &event_queue,
+                                                          ChainableGapEventHandler &chainable_gap_event_handler,
+                                                          ChainableGattServerEventHandler &chainable_gatt_server_event_handler) :
+    _ble(ble),
+    _periodic_update(event_queue, mbed::callback(this, &BasicCurrentTimeService::periodic_time_update)),
+    _coalesced_update(event_queue, mbed::callback(this, &BasicCurrentTimeService::coalesced_time_update)),
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+    _pending_updates(event_queue, mbed::callback(this, &BasicCurrentTimeService::send_pending_updates)),
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+    _persist_interval(event_queue, mbed::callback(this, &BasicCurrentTimeService::persist_interval_end)),
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+    _time_changes(event_queue, mbed::callback(this, &BasicCurrentTimeService::dispatch_time_change)),
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_COMMAND_MAILBOX
+    _commands(event_queue, mbed::callback(this, &BasicCurrentTimeService::execute)),
+#endif
+    _chainable_gap_event_handler(chainable_gap_event_handler),
+    _chainable_gatt_server_event_handler(chainable_gatt_server_event_handler),
+    _rtc_base_ms(static_cast<int64_t>(time(nullptr)) * 1000),
+    _tick_base(rtos::Kernel::Clock::now()),
+    _current_time_char(
+        GattCharacteristic::UUID_CURRENT_TIME_CHAR,
+        &_current_time,
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_INDICATIONS
+        GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY | GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE
+#else
+        GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY
+#endif
+    ),
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+    _local_time_information_char(GattCharacteristic::UUID_LOCAL_TIME_INFORMATION_CHAR, &_local_time_information),
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+    _reference_time_information_char(GattCharacteristic::UUID_REFERENCE_TIME_INFORMATION_CHAR, &_reference_time_information),
+#endif
+    _clock(MBED_CONF_BLE_SERVICE_CURRENT_TIME_MAX_DRIFT_PPM * 1000)
+{
+    publish_time();
+}
+
+template<typename Derived>
+BasicCurrentTimeService<Derived>::~BasicCurrentTimeService()
+{
+    stop_periodic_time_update();
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+    if (_persist_deferred) {
+        save_time();
+    }
+#endif
+}
+
+template<typename Derived>
+ble_error_t BasicCurrentTimeService<Derived>::init()
+{
+    GattCharacteristic *charTable[] = {
+        &_current_time_char,
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+        &_local_time_information_char,
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+        &_reference_time_information_char,
+#endif
+    };
+    GattService currentTimeService(GattService::UUID_CURRENT_TIME_SERVICE, charTable,
+                                   sizeof(charTable) / sizeof(charTable[0]));
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+    restore_time();
+#endif
+
+    _current_time_char.setReadAuthorizationCallback (this, &BasicCurrentTimeService::onCurrentTimeRead);
+    _current_time_char.setWriteAuthorizationCallback(this, &BasicCurrentTimeService::onCurrentTimeWritten);
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+    _local_time_information_char.setReadAuthorizationCallback(this, &BasicCurrentTimeService::onLocalTimeInformationRead);
+#endif
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+    _reference_time_information_char.setReadAuthorizationCallback(
+        this, &BasicCurrentTimeService::onReferenceTimeInformationRead
+    );
+#endif
+
+    ble_error_t bleError = _ble.gattServer().addService(currentTimeService);
+
+    if (bleError == BLE_ERROR_NONE) {
+        _chainable_gap_event_handler.addEventHandler(this);
+        _chainable_gatt_server_event_handler.addEventHandler(this);
+    }
+
+    MBED_STATIC_ASSERT(sizeof(_current_time) == CURRENT_TIME_CHAR_VALUE_SIZE, "Current time characteristic value size = 10");
+
+    return bleError;
+}
+
+template<typename Derived>
+time_t BasicCurrentTimeService<Derived>::get_time() const
+{
+    int64_t time_ms = get_time_ms();
+
+    /* round down to the second, also before 1970 */
+    return static_cast<time_t>((time_ms >= 0) ? (time_ms / 1000) : ((time_ms - 999) / 1000));
+}
+
+template<typename Derived>
+time_t BasicCurrentTimeService<Derived>::get_time(uint8_t &fractions256) const
+{
+    int64_t time_ms = get_time_ms();
+    int64_t seconds = (time_ms >= 0) ? (time_ms / 1000) : ((time_ms - 999) / 1000);
+
+    fractions256 = static_cast<uint8_t>(((time_ms - seconds * 1000) * 256) / 1000);
+
+    return static_cast<time_t>(seconds);
+}
+
+template<typename Derived>
+int64_t BasicCurrentTimeService<Derived>::get_time_ms() const
+{
+    return _wall_clock.to_ms(rtos::Kernel::Clock::now());
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::set_time(time_t host_time, uint8_t adjust_reason)
+{
+    set_time_ms(static_cast<int64_t>(host_time) * 1000, SECONDS_RESOLUTION_MS, adjust_reason);
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::set_time(time_t host_time, uint8_t fractions256, uint8_t adjust_reason)
+{
+    /* rounded up to the millisecond so that the same fractions are read back */
+    int64_t host_time_ms = static_cast<int64_t>(host_time) * 1000 + (fractions256 * 1000 + 255) / 256;
+
+    set_time_ms(host_time_ms, FRACTIONS256_RESOLUTION_MS, adjust_reason);
+}
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_COMMAND_MAILBOX
+template<typename Derived>
+bool BasicCurrentTimeService<Derived>::post_set_time(time_t host_time, uint8_t adjust_reason)
+{
+    return _commands.post(SetTimeCommand{
+        static_cast<int64_t>(host_time) * 1000, SECONDS_RESOLUTION_MS, adjust_reason, rtos::Kernel::Clock::now()
+    });
+}
+
+template<typename Derived>
+bool BasicCurrentTimeService<Derived>::post_set_time(time_t host_time, uint8_t fractions256, uint8_t adjust_reason)
+{
+    /* rounded up as set_time() does */
+    int64_t host_time_ms = static_cast<int64_t>(host_time) * 1000 + (fractions256 * 1000 + 255) / 256;
+
+    return _commands.post(SetTimeCommand{
+        host_time_ms, FRACTIONS256_RESOLUTION_MS, adjust_reason, rtos::Kernel::Clock::now()
+    });
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::execute(const SetTimeCommand &command)
+{
+    /* the host time was right when posted, not after waiting for the event queue */
+    const int64_t waited_ms = (rtos::Kernel::Clock::now() - command.posted).count();
+
+    set_time_ms(command.host_time_ms + waited_ms, command.resolution, command.adjust_reason);
+}
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+template<typename Derived>
+uint32_t BasicCurrentTimeService<Derived>::get_dropped_event_count() const
+{
+    return _time_changes.dropped();
+}
+#endif
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::set_time_ms(int64_t host_time_ms, int32_t resolution, uint8_t adjust_reason)
+{
+    int64_t local = local_time_ms();
+
+    /* a time entered by hand or a shift of the local time are deliberate jumps, not drift */
+    if (adjust_reason & (MANUAL_TIME_UPDATE | CHANGE_OF_TIME_ZONE | CHANGE_OF_DST)) {
+        _clock.step(local, host_time_ms, resolution);
+    } else {
+        _clock.synchronise(local, host_time_ms, resolution);
+    }
+    _adjust_reason = adjust_reason;
+
+    publish_time();
+
+    time_update(adjust_reason);
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+    persist_time();
+#endif
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::publish_time()
+{
+    /* local time of the kernel clock tick zero */
+    const int64_t tick_origin = _rtc_base_ms - _tick_base.time_since_epoch().count();
+
+    if (_clock.synchronised()) {
+        _wall_clock.publish(_clock.anchor() - tick_origin, _clock.offset() + tick_origin, _clock.drift());
+    } else {
+        _wall_clock.publish(0, tick_origin, 0);
+    }
+}
+
+template<typename Derived>
+std::chrono::milliseconds BasicCurrentTimeService<Derived>::get_time_error_bound() const
+{
+    if (!_clock.synchronised()) {
+        return std::chrono::milliseconds::max();
+    }
+
+    return std::chrono::milliseconds(_clock.error_bound(local_time_ms()));
+}
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+
+template<typename Derived>
+const uint8_t BasicCurrentTimeService<Derived>::PersistedTime::VERSION;
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::restore_time()
+{
+    PersistedTime persisted_time;
+    size_t size = 0;
+
+    int error = kv_get(MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST_KEY, &persisted_time, sizeof(persisted_time), &size);
+
+    /* a missing, truncated or older record leaves the time unset */
+    if (error != MBED_SUCCESS || size != sizeof(persisted_time) || persisted_time.version != PersistedTime::VERSION) {
+        return;
+    }
+
+    /* the local clock restarts from the real time clock, which only counts whole seconds */
+    _clock.restore(persisted_time.anchor, persisted_time.time_offset,
+                   persisted_time.drift, persisted_time.drift_uncertainty, SECONDS_RESOLUTION_MS);
+    publish_time();
+    _adjust_reason = persisted_time.adjust_reason;
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::persist_time()
+{
+    /* flash wear is bounded by saving at most once per interval, the last time set wins */
+    if (_persist_interval.pending()) {
+        _persist_deferred = true;
+        return;
+    }
+
+    /*
+     * saved from the event queue, writing the flash would hold up the reply to a client writing the time;
+     * periodic while the saves keep coming: an event cannot be posted again from its own handler
+     */
+    _persist_deferred = true;
+    _persist_interval.post(std::chrono::milliseconds(0),
+                           std::chrono::seconds(MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST_INTERVAL));
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::save_time()
+{
+    PersistedTime persisted_time{};
+    persisted_time.version = PersistedTime::VERSION;
+    persisted_time.adjust_reason = _adjust_reason;
+    persisted_time.anchor = _clock.anchor();
+    persisted_time.time_offset = _clock.offset();
+    persisted_time.drift = _clock.drift();
+    persisted_time.drift_uncertainty = _clock.drift_uncertainty();
+
+    int error = kv_set(MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST_KEY, &persisted_time, sizeof(persisted_time), 0);
+
+    /* a failed save stays deferred, it is retried at the end of each interval until the store accepts it */
+    _persist_deferred = (error != MBED_SUCCESS);
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::persist_interval_end()
+{
+    if (_persist_deferred) {
+        save_time();
+    } else {
+        _persist_interval.cancel();
+    }
+}
+
+#endif // MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::update_current_time_value(const uint8_t adjust_reason) {
+    /* reads are served by the authorization callback so the value only needs pushing if someone is listening */
+    if (_subscriber_count == 0) {
+        return;
+    }
+
+    CurrentTime current_time = to_current_time_ms(get_time_ms());
+
+    current_time.adjust_reason = adjust_reason;
+
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+    const uint8_t *value = reinterpret_cast<const uint8_t *>(&current_time);
+    bool changed = _current_time_value.changed(value);
+
+    /* the stack only holds the value, each subscriber is sent it on its own */
+    _current_time_value.write(_ble.gattServer(), _current_time_char.getValueHandle(), value, true);
+
+    if (!changed) {
+        return;
+    }
+
+    /* a slow client only ever has the newest time pending, not a backlog of stale ones */
+    _subscribers.for_each([adjust_reason](ble::connection_handle_t, Subscriber &subscriber) {
+        if (subscriber.subscribed) {
+            subscriber.pending = true;
+            subscriber.adjust_reason |= adjust_reason;
+        }
+    });
+
+    /* otherwise the updates are already being fanned out or retried, they are sent in turn */
+    if (!_pending_updates.pending()) {
+        send_pending_updates();
+    }
+#else
+    _current_time_value.write(_ble.gattServer(), _current_time_char.getValueHandle(),
+                              reinterpret_cast<const uint8_t *>(&current_time));
+#endif
+}
+
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+
+template<typename Derived>
+bool BasicCurrentTimeService<Derived>::send_pending_current_time(ble::connection_handle_t connection_handle,
+                                                                 Subscriber &subscriber)
+{
+    CurrentTime current_time = to_current_time_ms(get_time_ms());
+    current_time.adjust_reason = subscriber.adjust_reason;
+
+    ble_error_t error = _ble.gattServer().write(connection_handle, _current_time_char.getValueHandle(),
+                                                reinterpret_cast<const uint8_t *>(&current_time),
+                                                CURRENT_TIME_CHAR_VALUE_SIZE);
+
+    /* most likely out of buffers, the update stays pending until some have been freed */
+    if (error != BLE_ERROR_NONE) {
+        return false;
+    }
+
+    subscriber.in_flight = true;
+    subscriber.pending = false;
+    subscriber.adjust_reason = 0;
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+    _fan_out_credits--;
+#endif
+
+    return true;
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::send_pending_updates()
+{
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+    /* one subscriber per step so that the subscribers are not all sent their update in the same connection events */
+    size_t sends = 1;
+#else
+    size_t sends = _subscribers.capacity();
+#endif
+    bool waiting = false;
+
+    _subscribers.for_each([&](ble::connection_handle_t connection_handle, Subscriber &subscriber) {
+        /* an update behind one in flight is sent when the one in flight completes */
+        if (!subscriber.pending || subscriber.in_flight) {
+            return;
+        }
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+        if (_fan_out_credits == 0) {
+            waiting = true;
+            return;
+        }
+#endif
+
+        if (sends == 0 || !send_pending_current_time(connection_handle, subscriber)) {
+            waiting = true;
+            return;
+        }
+
+        sends--;
+    });
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+    /* without credits the fan-out is resumed by onDataSent rather than polling */
+    if (!waiting || _fan_out_credits == 0) {
+        _pending_updates.cancel();
+    } else if (!_pending_updates.pending()) {
+        /* the steps spread the subscribers over the window */
+        std::chrono::milliseconds step(MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW / _subscriber_count);
+        if (step < std::chrono::milliseconds(1)) {
+            step = std::chrono::milliseconds(1);
+        }
+        _pending_updates.post(step, step);
+    }
+#else
+    if (!waiting) {
+        _pending_updates.cancel();
+    } else if (!_pending_updates.pending()) {
+        const std::chrono::milliseconds interval(MBED_CONF_BLE_SERVICE_CURRENT_TIME_INDICATION_RETRY_INTERVAL);
+        _pending_updates.post(interval, interval);
+    }
+#endif
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::end_of_transmission(ble::connection_handle_t connection_handle)
+{
+    Subscriber *subscriber = _subscribers.find(connection_handle);
+
+    if (!subscriber || !subscriber->in_flight) {
+        return;
+    }
+
+    subscriber->in_flight = false;
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+    _fan_out_credits++;
+#endif
+
+    if (!subscriber->subscribed) {
+        _subscribers.erase(connection_handle);
+        subscriber = nullptr;
+    }
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+
+    /* the update of this subscriber takes its turn, resume the fan-out if it ran out of credits */
+    if (!_pending_updates.pending()) {
+        send_pending_updates();
+    }
+#else
+    if (subscriber && subscriber->pending && !send_pending_current_time(connection_handle, *subscriber)) {
+        send_pending_updates();
+    }
+#endif
+}
+
+#endif // BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::time_update(uint8_t adjust_reason)
+{
+    if (_subscriber_count == 0) {
+        return;
+    }
+
+    if (_update_coalescing_window <= std::chrono::milliseconds(0)) {
+        update_current_time_value(adjust_reason);
+
+        /* the minute boundary moves with the offset */
+        stop_periodic_time_update();
+        start_periodic_time_update();
+        return;
+    }
+
+    _coalesced_adjust_reason |= adjust_reason;
+
+    /* the window starts with the first time set, a steady stream of times set is still notified */
+    if (!_coalesced_update.pending()) {
+        /* the boundary is about to move, the update due meanwhile would be superseded */
+        stop_periodic_time_update();
+        _coalesced_update.post(_update_coalescing_window);
+    }
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::coalesced_time_update()
+{
+    uint8_t adjust_reason = _coalesced_adjust_reason;
+    _coalesced_adjust_reason = 0;
+
+    update_current_time_value(adjust_reason);
+    start_periodic_time_update();
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::start_periodic_time_update() {
+    if (!_periodic_update.pending() && !_coalesced_update.pending() && _subscriber_count != 0) {
+        /* the first update coincides with the minutes field changing, the following ones stay on the boundary */
+        const int64_t period_ms = std::chrono::milliseconds(UPDATE_TIME_PERIOD).count();
+        int64_t elapsed_ms = get_time_ms() % period_ms;
+        if (elapsed_ms < 0) {
+            elapsed_ms += period_ms;
+        }
+
+        _periodic_update.post(std::chrono::milliseconds(period_ms - elapsed_ms), UPDATE_TIME_PERIOD);
+    }
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::periodic_time_update() {
+    update_current_time_value(EXTERNAL_REFERENCE_TIME_UPDATE);
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::stop_periodic_time_update() {
+    _periodic_update.cancel();
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::add_subscriber(ble::connection_handle_t connection_handle)
+{
+    Subscriber *subscriber = _subscribers.find(connection_handle);
+    if (!subscriber) {
+        subscriber = _subscribers.insert(connection_handle);
+    }
+
+    if (!subscriber || subscriber->subscribed) {
+        return;
+    }
+
+    subscriber->subscribed = true;
+    _subscriber_count++;
+
+    /* the new subscriber has not been sent the current value */
+    _current_time_value.invalidate();
+
+    start_periodic_time_update();
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::remove_subscriber(ble::connection_handle_t connection_handle, bool disconnected)
+{
+    Subscriber *subscriber = _subscribers.find(connection_handle);
+    if (!subscriber) {
+        return;
+    }
+
+    if (subscriber->subscribed) {
+        subscriber->subscribed = false;
+        _subscriber_count--;
+    }
+
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+    subscriber->pending = false;
+    subscriber->adjust_reason = 0;
+
+    /* the stack still holds the update in flight, the entry is erased once it is acknowledged */
+    if (subscriber->in_flight && !disconnected) {
+        subscriber = nullptr;
+    }
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW
+    /* the acknowledgement of an update in flight on a lost connection will not come */
+    if (subscriber && subscriber->in_flight) {
+        _fan_out_credits++;
+    }
+#endif
+#else
+    /* without updates in flight, a subscriber is erased whether its connection is lost or not */
+    (void) disconnected;
+#endif
+
+    if (subscriber) {
+        _subscribers.erase(connection_handle);
+    }
+
+    if (_subscriber_count == 0) {
+        stop_periodic_time_update();
+        _coalesced_update.cancel();
+        _coalesced_adjust_reason = 0;
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+        _pending_updates.cancel();
+#endif
+    }
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event)
+{
+    remove_subscriber(event.getConnectionHandle(), true);
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onUpdatesEnabled(const GattUpdatesEnabledCallbackParams &params)
+{
+    if (params.charHandle == _current_time_char.getValueHandle()) {
+        add_subscriber(params.connHandle);
+    }
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onUpdatesDisabled(const GattUpdatesDisabledCallbackParams &params)
+{
+    if (params.charHandle == _current_time_char.getValueHandle()) {
+        remove_subscriber(params.connHandle, false);
+    }
+}
+
+#if BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onDataSent(const GattDataSentCallbackParams &params)
+{
+    /* a notification is not confirmed, it is done once sent */
+    if (params.attHandle == _current_time_char.getValueHandle()) {
+        end_of_transmission(params.connHandle);
+    }
+}
+
+#endif // BLE_SERVICE_CURRENT_TIME_UPDATES_PER_CONNECTION
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_INDICATIONS
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onConfirmationReceived(const GattConfirmationReceivedCallbackParams &params)
+{
+    if (params.attHandle == _current_time_char.getValueHandle()) {
+        end_of_transmission(params.connHandle);
+    }
+}
+
+#endif // MBED_CONF_BLE_SERVICE_CURRENT_TIME_INDICATIONS
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onCurrentTimeRead(GattReadAuthCallbackParams *read_request)
+{
+    CurrentTime local_current_time = to_current_time_ms(get_time_ms());
+
+    if (local_current_time.valid()) {
+        _current_time = local_current_time;
+        read_request->data = reinterpret_cast<uint8_t *>(&_current_time);
+        read_request->len  = CURRENT_TIME_CHAR_VALUE_SIZE;
+        read_request->authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+    } else {
+        read_request->authorizationReply = AUTH_CALLBACK_REPLY_ATTERR_UNLIKELY_ERROR;
+    }
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onCurrentTimeWritten(GattWriteAuthCallbackParams *write_request)
+{
+    /* checked before decoding, a shorter value would be read past its end */
+    if (write_request->len != CURRENT_TIME_CHAR_VALUE_SIZE) {
+        write_request->authorizationReply = AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH;
+        return;
+    }
+
+    CurrentTime input_time(write_request->data);
+
+    if (!input_time.valid()) {
+        write_request->authorizationReply = AUTH_CALLBACK_REPLY_ATTERR_OUT_OF_RANGE;
+        return;
+    }
+
+    time_t remote_time = input_time.to_time();
+
+    /* a client without a sub-second clock leaves the fractions at zero, the time is then only known to the second */
+    if (input_time.fractions256) {
+        set_time(remote_time, input_time.fractions256, input_time.adjust_reason);
+    } else {
+        set_time(remote_time, input_time.adjust_reason);
+    }
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+    _time_changes.post(TimeChange{remote_time, input_time.adjust_reason});
+#else
+    derived().on_current_time_changed(remote_time, input_time.adjust_reason);
+#endif
+
+    write_request->authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+}
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_DEFERRED_EVENTS
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::dispatch_time_change(const TimeChange &time_change)
+{
+    derived().on_current_time_changed(time_change.current_time, time_change.adjust_reason);
+}
+#endif
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+
+template<typename Derived>
+uint8_t BasicCurrentTimeService<Derived>::get_dst_offset() const
+{
+    constexpr uint8_t save = DstRules::MBED_CONF_BLE_SERVICE_CURRENT_TIME_DST_RULES.save_minutes / 15;
+
+    switch (DST_TABLE.local_state(get_time())) {
+        case DstTableType::DAYLIGHT:
+            return save;
+        case DstTableType::STANDARD:
+            return 0;
+        default:
+            return DST_OFFSET_UNKNOWN;
+    }
+}
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onLocalTimeInformationRead(GattReadAuthCallbackParams *read_request)
+{
+    _local_time_information.time_zone = get_time_zone();
+    _local_time_information.dst_offset = get_dst_offset();
+
+    read_request->data = reinterpret_cast<uint8_t *>(&_local_time_information);
+    read_request->len  = sizeof(_local_time_information);
+    read_request->authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+}
+
+#endif // MBED_CONF_BLE_SERVICE_CURRENT_TIME_LOCAL_TIME_INFORMATION
+
+#if MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+
+template<typename Derived>
+void BasicCurrentTimeService<Derived>::onReferenceTimeInformationRead(GattReadAuthCallbackParams *read_request)
+{
+    ReferenceTimeInformation &information = _reference_time_information;
+
+    if (!_clock.synchronised()) {
+        information.time_source = TIME_SOURCE_UNKNOWN;
+        information.accuracy = 255;
+        information.days_since_update = 255;
+        information.hours_since_update = 255;
+    } else {
+        /* the client only tells whether the time was entered by hand */
+        information.time_source = (_adjust_reason & MANUAL_TIME_UPDATE) ? TIME_SOURCE_MANUAL : TIME_SOURCE_UNKNOWN;
+
+        int64_t steps = (_clock.error_bound(local_time_ms()) + 124) / 125;
+        information.accuracy = (steps > 253) ? 254 : static_cast<uint8_t>(steps);
+
+        int64_t hours = (local_time_ms() - _clock.anchor()) / (CivilCalendar::SECONDS_PER_HOUR * 1000LL);
+        if (hours >= 255 * 24) {
+            information.days_since_update = 255;
+            information.hours_since_update = 255;
+        } else {
+            information.days_since_update = static_cast<uint8_t>(hours / 24);
+            information.hours_since_update = static_cast<uint8_t>(hours % 24);
+        }
+    }
+
+    read_request->data = reinterpret_cast<uint8_t *>(&information);
+    read_request->len  = sizeof(information);
+    read_request->authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+}
+
+#endif // MBED_CONF_BLE_SERVICE_CURRENT_TIME_REFERENCE_TIME_INFORMATION
+
+template<typename Derived>
+typename BasicCurrentTimeService<Derived>::CurrentTime BasicCurrentTimeService<Derived>::to_current_time(time_t local_time)
+{
+    if (_calendar_cache_valid &&
+        (local_time >= _calendar_cache_time) &&
+        (local_time - _calendar_cache_time < CivilCalendar::SECONDS_PER_DAY)) {
+        _calendar_cache = CivilCalendar::advance(_calendar_cache, local_time - _calendar_cache_time);
+    } else {
+        _calendar_cache = CivilCalendar::date_time_from_seconds(local_time);
+        _calendar_cache_valid = true;
+    }
+    _calendar_cache_time = local_time;
+
+    return CurrentTime(_calendar_cache);
+}
+
+template<typename Derived>
+typename BasicCurrentTimeService<Derived>::CurrentTime BasicCurrentTimeService<Derived>::to_current_time_ms(int64_t local_time_ms)
+{
+    int64_t seconds = (local_time_ms >= 0) ? (local_time_ms / 1000) : ((local_time_ms - 999) / 1000);
+
+    CurrentTime current_time = to_current_time(static_cast<time_t>(seconds));
+    current_time.fractions256 = static_cast<uint8_t>(((local_time_ms - seconds * 1000) * 256) / 1000);
+
+    return current_time;
+}
+
+template<typename Derived>
+BasicCurrentTimeService<Derived>::CurrentTime::CurrentTime(const uint8_t *data)
+{
+    const ble::codec::date_time::value_type date_time = ble::codec::date_time::decode(data);
+    data += ble::codec::date_time::size;
+
+    set_year(date_time.year);
+    month         = date_time.month;
+    day           = date_time.day;
+    hours         = date_time.hours;
+    minutes       = date_time.minutes;
+    seconds       = date_time.seconds;
+    weekday       = *data++;
+    fractions256  = *data++;
+    adjust_reason = *data;
+}
+
+template<typename Derived>
+BasicCurrentTimeService<Derived>::CurrentTime::CurrentTime(const CivilCalendar::DateTime &date_time)
+{
+    set_year(date_time.year);
+    month         = date_time.month;
+    day           = date_time.day;
+    hours         = date_time.hours;
+    minutes       = date_time.minutes;
+    seconds       = date_time.seconds;
+    weekday       = date_time.weekday;
+    fractions256  = 0;
+    adjust_reason = 0;
+}
+
+template<typename Derived>
+bool BasicCurrentTimeService<Derived>::CurrentTime::valid()
+{
+    if ((get_year() < 1582) || (get_year() > 9999)) {
+        return false;
+    }
+    if ((month   <    1) || (month   >   12)) {
+        return false;
+    }
+    if ((day     <    1) || (day     >   31)) {
+        return false;
+    }
+    if ( hours   >   23) {
+        return false;
+    }
+    if ( minutes >   59) {
+        return false;
+    }
+    if ( seconds >   59) {
+        return false;
+    }
+    if ((weekday <    1) || (weekday >    7)) {
+        return false;
+    }
+
+    return true;
+}
+
+template<typename Derived>
+time_t BasicCurrentTimeService<Derived>::CurrentTime::to_time()
+{
+    CivilCalendar::DateTime date_time{};
+    date_time.year    = get_year();
+    date_time.month   = month;
+    date_time.day     = day;
+    date_time.hours   = hours;
+    date_time.minutes = minutes;
+    date_time.seconds = seconds;
+
+    return static_cast<time_t>(CivilCalendar::seconds_from_date_time(date_time));
+}
+
+#endif // BLE_FEATURE_GATT_SERVER
+
+#endif // BASIC_CURRENT_TIME_SERVICE_H
@@ -0,0 +1,191 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CIVIL_CALENDAR_H
+#define CIVIL_CALENDAR_H
+
+#include <cstdint>
+
+/**
+ * Civil Calendar
+ *
+ * @par purpose
+ * Conversions between seconds since 00:00 January 1, 1970 and the proleptic Gregorian calendar
+ * without going through localtime()/mktime(). All conversions are constexpr so they can be
+ * checked at compile time and are reentrant.
+ *
+ * @par usage
+ * Use date_time_from_seconds() and seconds_from_date_time() for full conversions. When the time
+ * only moves forward by less than a day, advance() updates a previously converted value
+ * field by field, which avoids the divisions of a full conversion.
+ *
+ * @note The day counting algorithms are described in
+ * http://howardhinnant.github.io/date_algorithms.html
+ */
+class CivilCalendar {
+public:
+    static constexpr int32_t SECONDS_PER_MINUTE = 60;
+    static constexpr int32_t SECONDS_PER_HOUR   = 60 * SECONDS_PER_MINUTE;
+    static constexpr int32_t SECONDS_PER_DAY    = 24 * SECONDS_PER_HOUR;
+
+    /** Broken-down time using the same conventions as the Current Time characteristic */
+    struct DateTime {
+        /** Year as defined by the Gregorian calendar */
+        int32_t year;
+        /** Month of the year, 1 (January) to 12 (December) */
+        uint8_t month;
+        /** Day of the month, 1 to 31 */
+        uint8_t day;
+        /** Number of hours past midnight, 0 to 23 */
+        uint8_t hours;
+        /** Number of minutes since the start of the hour, 0 to 59 */
+        uint8_t minutes;
+        /** Number of seconds since the start of the minute, 0 to 59 */
+        uint8_t seconds;
+        /** Day of the week as specified in ISO 8601, Monday (1) to Sunday (7) */
+        uint8_t weekday;
+    };
+
+    static constexpr bool is_leap_year(int32_t year)
+    {
+        return (year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0));
+    }
+
+    /**
+     * @return Number of days in @p month of @p year
+     */
+    static constexpr uint8_t days_in_month(int32_t year, uint8_t month)
+    {
+        return (month == 2) ? (is_leap_year(year) ? 29 : 28) :
+               ((month == 4) || (month == 6) || (month == 9) || (month == 11)) ? 30 : 31;
+    }
+
+    /**
+     * @return Number of days between 1970-01-01 and the given date (negative before 1970)
+     */
+    static constexpr int32_t days_from_civil(int32_t year, uint8_t month, uint8_t day)
+    {
+        const int32_t y   = year - (month <= 2 ? 1 : 0);
+        const int32_t era = (y >= 0 ? y : y - 399) / 400;
+        const int32_t yoe = y - era * 400;
+        const int32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    /**
+     * @return ISO 8601 day of the week, Monday (1) to Sunday (7), of the day @p days after 1970-01-01
+     */
+    static constexpr uint8_t weekday_from_days(int32_t days)
+    {
+        /* 1970-01-01 was a Thursday (4) */
+        return static_cast<uint8_t>(((days % 7) + 7 + 3) % 7 + 1);
+    }
+
+    /**
+     * @return Date, at midnight, of the day @p days after 1970-01-01
+     */
+    static constexpr DateTime civil_from_days(int32_t days)
+    {
+        const int32_t z   = days + 719468;
+        const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const int32_t doe = z - era * 146097;
+        const int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int32_t mp  = (5 * doy + 2) / 153;
+        const int32_t m   = mp < 10 ? mp + 3 : mp - 9;
+
+        DateTime date_time{};
+        date_time.year    = yoe + era * 400 + (m <= 2 ? 1 : 0);
+        date_time.month   = static_cast<uint8_t>(m);
+        date_time.day     = static_cast<uint8_t>(doy - (153 * mp + 2) / 5 + 1);
+        date_time.weekday = weekday_from_days(days);
+        return date_time;
+    }
+
+    /**
+     * @return Broken-down representation of @p seconds since 00:00 January 1, 1970
+     */
+    static constexpr DateTime date_time_from_seconds(int64_t seconds)
+    {
+        int64_t days = seconds / SECONDS_PER_DAY;
+        int64_t rem  = seconds % SECONDS_PER_DAY;
+        if (rem < 0) {
+            rem  += SECONDS_PER_DAY;
+            days -= 1;
+        }
+
+        DateTime date_time = civil_from_days(static_cast<int32_t>(days));
+        date_time.hours    = static_cast<uint8_t>(rem / SECONDS_PER_HOUR);
+        date_time.minutes  = static_cast<uint8_t>((rem % SECONDS_PER_HOUR) / SECONDS_PER_MINUTE);
+        date_time.seconds  = static_cast<uint8_t>(rem % SECONDS_PER_MINUTE);
+        return date_time;
+    }
+
+    /**
+     * @return Seconds since 00:00 January 1, 1970 of @p date_time; the weekday field is ignored
+     */
+    static constexpr int64_t seconds_from_date_time(const DateTime &date_time)
+    {
+        return static_cast<int64_t>(days_from_civil(date_time.year, date_time.month, date_time.day)) * SECONDS_PER_DAY +
+               date_time.hours * SECONDS_PER_HOUR + date_time.minutes * SECONDS_PER_MINUTE + date_time.seconds;
+    }
+
+    /**
+     * Move @p date_time forward by @p seconds.
+     *
+     * @param date_time A valid broken-down time
+     * @param seconds Number of seconds to advance by, must be less than SECONDS_PER_DAY
+     *
+     * @return The advanced broken-down time
+     */
+    static constexpr DateTime advance(DateTime date_time, uint32_t seconds)
+    {
+        uint32_t total = date_time.seconds + seconds;
+        date_time.seconds = static_cast<uint8_t>(total % SECONDS_PER_MINUTE);
+
+        total = date_time.minutes + total / SECONDS_PER_MINUTE;
+        date_time.minutes = static_cast<uint8_t>(total % 60);
+
+        total = date_time.hours + total / 60;
+        date_time.hours = static_cast<uint8_t>(total % 24);
+
+        /* less than a day was added so at most one day boundary was crossed */
+        if (total >= 24) {
+            date_time.weekday = (date_time.weekday == 7) ? 1 : date_time.weekday + 1;
+            if (date_time.day < days_in_month(date_time.year, date_time.month)) {
+                date_time.day++;
+            } else {
+                date_time.day = 1;
+                if (date_time.month < 12) {
+                    date_time.month++;
+                } else {
+                    date_time.month = 1;
+                    date_time.year++;
+                }
+            }
+        }
+
+        return date_time;
+    }
+
+private:
+    CivilCalendar() = delete;
+    ~CivilCalendar() = delete;
+};
+
+#endif // CIVIL_CALENDAR_H
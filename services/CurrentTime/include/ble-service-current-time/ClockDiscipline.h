@@ -0,0 +1,312 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CLOCK_DISCIPLINE_H
+#define CLOCK_DISCIPLINE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * Clock Discipline
+ *
+ * @par purpose
+ * Keeps a local clock in step with a reference clock that is only sampled now and then, such as the time
+ * written by a client of the current time service. Between two samples the local clock drifts by its
+ * frequency error; the error is estimated from the history of samples and the correction is slewed in
+ * continuously instead of waiting for the next sample to step the time.
+ *
+ * @par usage
+ * Times are counted in milliseconds. Pass every sample of the reference clock to synchronise() together
+ * with the local time it was taken at and its resolution, or to step() if the reference jumped on purpose
+ * (time zone change, time entered by hand) and must not be taken for drift. reference() converts a local
+ * time to the reference time scale and error_bound() tells how far off that conversion may be.
+ *
+ * The drift is the least squares slope of the offset between both clocks over the last @p HistorySize
+ * samples. It is only trusted once the samples span long enough for their resolution to be small against
+ * it: until then, the drift is assumed to be anywhere within the maximum drift.
+ *
+ * @note Samples are rare so the estimate uses floating point. Conversions only use integer arithmetic.
+ *
+ * @tparam HistorySize Number of samples the drift is estimated from, at least 2
+ */
+template<size_t HistorySize>
+class ClockDiscipline {
+    static_assert(HistorySize >= 2, "At least two samples are needed to estimate a drift");
+
+public:
+    static constexpr int32_t PPB = 1000000000;
+
+    /**
+     * @param max_drift Largest drift of the local clock in parts per billion, estimates beyond it are clamped
+     */
+    explicit ClockDiscipline(int32_t max_drift) :
+        _max_drift(max_drift),
+        _drift_uncertainty(max_drift)
+    {
+    }
+
+    /**
+     * @return true once a reference time is known
+     */
+    bool synchronised() const
+    {
+        return _synchronised;
+    }
+
+    /**
+     * Take the reference time @p reference sampled at the local time @p local as a new sample of the drift.
+     *
+     * The reference time becomes exact at @p local. A sample too far from the current estimate to be explained
+     * by the drift is taken as a step instead.
+     *
+     * @param resolution Resolution of the sample in milliseconds, the larger of both clocks'
+     */
+    void synchronise(int64_t local, int64_t reference, int32_t resolution)
+    {
+        if (!_synchronised || !plausible(local, reference, resolution)) {
+            step(local, reference, resolution);
+            return;
+        }
+
+        add_sample(local, reference - local, resolution);
+        estimate_drift();
+
+        _anchor = local;
+        _offset = reference - local;
+        _resolution = resolution;
+    }
+
+    /**
+     * Make the reference time @p reference at the local time @p local without measuring the drift across it.
+     *
+     * Samples taken before the step are forgotten and the step is the first sample of a new history. The drift
+     * estimated from the forgotten samples is kept until the samples taken after the step give a better one.
+     */
+    void step(int64_t local, int64_t reference, int32_t resolution)
+    {
+        _sample_count = 0;
+        _next_sample = 0;
+        _fitted = false;
+        _jitter = 0;
+
+        add_sample(local, reference - local, resolution);
+
+        _anchor = local;
+        _offset = reference - local;
+        _resolution = resolution;
+        _synchronised = true;
+    }
+
+    /**
+     * Restore a state saved with anchor(), offset(), drift() and drift_uncertainty().
+     *
+     * The local clock must have kept running since the state was saved. The saved anchor is the first sample,
+     * the saved drift is kept until the following samples give a better one.
+     *
+     * @param resolution Resolution of the restored offset in milliseconds, including the error of the local
+     * clock across the save and restore
+     */
+    void restore(int64_t anchor, int64_t offset, int32_t drift, int32_t drift_uncertainty, int32_t resolution)
+    {
+        _sample_count = 0;
+        _next_sample = 0;
+        _fitted = false;
+        _jitter = 0;
+
+        _anchor = anchor;
+        _offset = offset;
+        _drift = clamp(drift);
+        _drift_uncertainty = (drift_uncertainty > 0 && drift_uncertainty < _max_drift) ? drift_uncertainty : _max_drift;
+        _resolution = resolution;
+        _synchronised = true;
+
+        add_sample(anchor, offset, resolution);
+    }
+
+    /**
+     * @return Reference time at the local time @p local
+     */
+    int64_t reference(int64_t local) const
+    {
+        return local + _offset + slew(local - _anchor, _drift);
+    }
+
+    /**
+     * @return Largest expected difference between reference(@p local) and the reference clock, in milliseconds,
+     * or the largest int64_t value if the reference time is unknown
+     */
+    int64_t error_bound(int64_t local) const
+    {
+        if (!_synchronised) {
+            return std::numeric_limits<int64_t>::max();
+        }
+
+        int64_t elapsed = (local >= _anchor) ? (local - _anchor) : (_anchor - local);
+
+        return _resolution + _jitter + slew(elapsed, _drift_uncertainty);
+    }
+
+    /**
+     * @return Estimated drift of the local clock in parts per billion, positive if the local clock is slow
+     */
+    int32_t drift() const
+    {
+        return _drift;
+    }
+
+    /**
+     * @return Uncertainty of the estimated drift in parts per billion
+     */
+    int32_t drift_uncertainty() const
+    {
+        return _drift_uncertainty;
+    }
+
+    /**
+     * @return Local time of the last sample or step
+     */
+    int64_t anchor() const
+    {
+        return _anchor;
+    }
+
+    /**
+     * @return Offset between the reference and local clocks at anchor()
+     */
+    int64_t offset() const
+    {
+        return _offset;
+    }
+
+private:
+    struct Sample {
+        int64_t local;
+        int64_t offset;
+        int32_t resolution;
+    };
+
+    static int64_t slew(int64_t elapsed, int32_t drift)
+    {
+        /* exact for elapsed times of years at any drift below a few percent */
+        return (elapsed * drift) / PPB;
+    }
+
+    int32_t clamp(int32_t drift) const
+    {
+        return (drift > _max_drift) ? _max_drift : (drift < -_max_drift) ? -_max_drift : drift;
+    }
+
+    bool plausible(int64_t local, int64_t reference, int32_t resolution) const
+    {
+        int64_t error = reference - this->reference(local);
+        int64_t elapsed = (local >= _anchor) ? (local - _anchor) : (_anchor - local);
+
+        /* both samples are rounded by up to their resolution */
+        int64_t tolerance = _resolution + resolution + _jitter + slew(elapsed, _max_drift + (_drift >= 0 ? _drift : -_drift));
+
+        return (error <= tolerance) && (error >= -tolerance);
+    }
+
+    void add_sample(int64_t local, int64_t offset, int32_t resolution)
+    {
+        _samples[_next_sample] = Sample{local, offset, resolution};
+        _next_sample = (_next_sample + 1) % HistorySize;
+        if (_sample_count < HistorySize) {
+            _sample_count++;
+        }
+    }
+
+    void estimate_drift()
+    {
+        /* relative to the newest sample so that the sums stay small */
+        const Sample &origin = _samples[(_next_sample + HistorySize - 1) % HistorySize];
+
+        double sum_x = 0;
+        double sum_y = 0;
+        int32_t resolution = 0;
+        for (size_t i = 0; i < _sample_count; i++) {
+            sum_x += static_cast<double>(_samples[i].local - origin.local);
+            sum_y += static_cast<double>(_samples[i].offset - origin.offset);
+            resolution = (_samples[i].resolution > resolution) ? _samples[i].resolution : resolution;
+        }
+        double mean_x = sum_x / _sample_count;
+        double mean_y = sum_y / _sample_count;
+
+        double sxx = 0;
+        double sxy = 0;
+        for (size_t i = 0; i < _sample_count; i++) {
+            double dx = static_cast<double>(_samples[i].local - origin.local) - mean_x;
+            double dy = static_cast<double>(_samples[i].offset - origin.offset) - mean_y;
+            sxx += dx * dx;
+            sxy += dx * dy;
+        }
+
+        if (sxx <= 0) {
+            return;
+        }
+
+        double slope = sxy / sxx;
+
+        double max_residual = 0;
+        for (size_t i = 0; i < _sample_count; i++) {
+            double dx = static_cast<double>(_samples[i].local - origin.local) - mean_x;
+            double dy = static_cast<double>(_samples[i].offset - origin.offset) - mean_y;
+            max_residual = std::fmax(max_residual, std::fabs(dy - slope * dx));
+        }
+
+        /* the slope is off by at most the rounding and noise of the offsets over the spread of the samples */
+        double uncertainty = std::ceil(PPB * (resolution + max_residual) / std::sqrt(sxx));
+
+        if (uncertainty >= _max_drift) {
+            return;
+        }
+
+        /* an estimate carried over a step is kept until the samples since the step do better */
+        if (!_fitted && uncertainty > _drift_uncertainty) {
+            return;
+        }
+
+        _drift = clamp(static_cast<int32_t>(std::lround(slope * PPB)));
+        _drift_uncertainty = static_cast<int32_t>(uncertainty);
+        _jitter = static_cast<int64_t>(std::ceil(max_residual));
+        _fitted = true;
+    }
+
+    const int32_t _max_drift;
+
+    Sample _samples[HistorySize] = {};
+    size_t _sample_count = 0;
+    size_t _next_sample = 0;
+
+    int64_t _anchor = 0;
+    int64_t _offset = 0;
+    /* of the sample at _anchor */
+    int32_t _resolution = 0;
+    int32_t _drift = 0;
+    int32_t _drift_uncertainty;
+    int64_t _jitter = 0;
+    bool _fitted = false;
+    bool _synchronised = false;
+};
+
+template<size_t HistorySize>
+constexpr int32_t ClockDiscipline<HistorySize>::PPB;
+
+#endif // CLOCK_DISCIPLINE_H
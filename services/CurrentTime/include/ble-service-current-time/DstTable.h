@@ -0,0 +1,208 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DST_TABLE_H
+#define DST_TABLE_H
+
+#include "ble-service-current-time/CivilCalendar.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Daylight saving time rule
+ *
+ * Daylight saving time starts and ends on a given weekday of a month every year, for instance the last
+ * Sunday of March. The rules of a few regions are provided in DstRules.
+ */
+struct DstRule {
+    struct Transition {
+        /** Month of the year, 1 (January) to 12 (December) */
+        uint8_t month;
+        /** Occurrence of the weekday in the month, 1 to 4, or 5 for the last one */
+        uint8_t week;
+        /** Day of the week as specified in ISO 8601, Monday (1) to Sunday (7) */
+        uint8_t weekday;
+        /** Minutes past midnight when the clocks change */
+        int16_t minutes;
+        /** true if minutes are counted in UTC, false if in the local time in effect before the change */
+        bool utc;
+    };
+
+    Transition start;
+    Transition end;
+    /** Minutes the clocks go forward while daylight saving time is in effect, 0 if it is never in effect */
+    int16_t save_minutes;
+};
+
+/**
+ * Daylight saving time rules of some regions, selected by the dst-rules configuration option
+ */
+namespace DstRules {
+/** No daylight saving time */
+constexpr DstRule NONE = { {1, 1, 7, 0, true}, {1, 1, 7, 0, true}, 0 };
+/** European Union: last Sunday of March to last Sunday of October, at 01:00 UTC */
+constexpr DstRule EU = { {3, 5, 7, 60, true}, {10, 5, 7, 60, true}, 60 };
+/** United States and Canada: second Sunday of March to first Sunday of November, at 02:00 local time */
+constexpr DstRule US = { {3, 2, 7, 120, false}, {11, 1, 7, 120, false}, 60 };
+/** South eastern Australia: first Sunday of October to first Sunday of April, at 02:00 standard time */
+constexpr DstRule AU = { {10, 1, 7, 120, false}, {4, 1, 7, 180, false}, 60 };
+} // namespace DstRules
+
+/**
+ * Daylight Saving Time Table
+ *
+ * @par purpose
+ * Instants at which daylight saving time starts and ends in a time zone, computed when the program is
+ * compiled. Telling whether daylight saving time is in effect is a binary search in the table rather than
+ * the evaluation of the rule, or the parsing of a TZ string by the C library.
+ *
+ * @par usage
+ * Declare the table constexpr with the rule and the offset of the time zone from UTC. The table covers
+ * @p Years years from 00:00 January 1st of @p FirstYear, UTC; out of that range daylight saving time is unknown.
+ * A rule without daylight saving time still needs one year.
+ *
+ * @tparam FirstYear First year covered by the table
+ * @tparam Years Number of years covered by the table
+ */
+template<int32_t FirstYear, size_t Years>
+class DstTable {
+    static_assert(Years > 0, "A table covers at least one year");
+    static_assert(FirstYear >= 1970 && FirstYear + Years <= 2106, "Instants are stored as 32 bit unsigned seconds");
+
+public:
+    /** Daylight saving time state of an instant */
+    enum State : int8_t {
+        UNKNOWN  = -1,
+        STANDARD =  0,
+        DAYLIGHT =  1
+    };
+
+    /**
+     * @param rule Daylight saving time rule of the time zone
+     * @param time_zone_minutes Offset of the standard time of the time zone from UTC, in minutes
+     */
+    constexpr DstTable(const DstRule &rule, int32_t time_zone_minutes) :
+        _save(rule.save_minutes * CivilCalendar::SECONDS_PER_MINUTE),
+        _time_zone(time_zone_minutes * CivilCalendar::SECONDS_PER_MINUTE),
+        /* the southern hemisphere ends daylight saving time earlier in the year than it starts it */
+        _end_first(rule.end.month < rule.start.month),
+        _first(CivilCalendar::days_from_civil(FirstYear, 1, 1) * static_cast<int64_t>(CivilCalendar::SECONDS_PER_DAY)),
+        _last(CivilCalendar::days_from_civil(FirstYear + Years, 1, 1) * static_cast<int64_t>(CivilCalendar::SECONDS_PER_DAY))
+    {
+        for (size_t i = 0; i < Years; i++) {
+            const int32_t year = FirstYear + static_cast<int32_t>(i);
+            const int64_t start = transition_time(year, rule.start, 0);
+            /* the end is given in daylight saving time */
+            const int64_t end = transition_time(year, rule.end, _save);
+
+            _transitions[2 * i]     = static_cast<uint32_t>(_end_first ? end : start);
+            _transitions[2 * i + 1] = static_cast<uint32_t>(_end_first ? start : end);
+        }
+    }
+
+    /**
+     * @return State of daylight saving time at @p utc seconds since 00:00 January 1, 1970 UTC
+     */
+    constexpr State state(int64_t utc) const
+    {
+        if (_save == 0) {
+            return STANDARD;
+        }
+
+        if (utc < _first || utc >= _last) {
+            return UNKNOWN;
+        }
+
+        /* number of transitions up to utc */
+        size_t low = 0;
+        size_t high = 2 * Years;
+        while (low < high) {
+            size_t middle = (low + high) / 2;
+            if (_transitions[middle] <= utc) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        return ((low % 2 == 1) != _end_first) ? DAYLIGHT : STANDARD;
+    }
+
+    /**
+     * State of daylight saving time at @p local seconds since 00:00 January 1, 1970 in the local time of the
+     * time zone. The local times repeated when the clocks go back are in daylight saving time, the ones skipped
+     * when they go forward too.
+     */
+    constexpr State local_state(int64_t local) const
+    {
+        /* the instant if daylight saving time is in effect, and the later one if it is not */
+        const State daylight = state(local - _time_zone - _save);
+        const State standard = state(local - _time_zone);
+
+        if (daylight == UNKNOWN || standard == UNKNOWN) {
+            return UNKNOWN;
+        }
+
+        return (daylight == DAYLIGHT || standard == DAYLIGHT) ? DAYLIGHT : STANDARD;
+    }
+
+    /**
+     * @return Seconds since 00:00 January 1, 1970 UTC of the @p index th transition, starts and ends alternate
+     */
+    constexpr int64_t transition(size_t index) const
+    {
+        return _transitions[index];
+    }
+
+    /**
+     * @return true if the first transition of each year is the end of daylight saving time
+     */
+    constexpr bool end_first() const
+    {
+        return _end_first;
+    }
+
+private:
+    constexpr int64_t transition_time(int32_t year, const DstRule::Transition &rule, int32_t save) const
+    {
+        int32_t days = 0;
+
+        if (rule.week == 5) {
+            const int32_t last =
+                CivilCalendar::days_from_civil(year, rule.month, CivilCalendar::days_in_month(year, rule.month));
+            days = last - (CivilCalendar::weekday_from_days(last) + 7 - rule.weekday) % 7;
+        } else {
+            const int32_t first = CivilCalendar::days_from_civil(year, rule.month, 1);
+            days = first + (rule.weekday + 7 - CivilCalendar::weekday_from_days(first)) % 7 + 7 * (rule.week - 1);
+        }
+
+        int64_t seconds = days * static_cast<int64_t>(CivilCalendar::SECONDS_PER_DAY) +
+                          rule.minutes * CivilCalendar::SECONDS_PER_MINUTE;
+
+        return rule.utc ? seconds : (seconds - _time_zone - save);
+    }
+
+    int32_t _save;
+    int32_t _time_zone;
+    bool _end_first;
+    int64_t _first;
+    int64_t _last;
+    uint32_t _transitions[2 * Years] = {};
+};
+
+#endif // DST_TABLE_H
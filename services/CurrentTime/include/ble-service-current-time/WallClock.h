@@ -0,0 +1,155 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WALL_CLOCK_H
+#define WALL_CLOCK_H
+
+#include "rtos/Kernel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * Wall Clock
+ *
+ * @par purpose
+ * Converts kernel clock ticks to the time of day without locking, so that samples taken at a high rate can be
+ * stamped from any thread or interrupt handler. The conversion is the one of the current time service,
+ * including its drift correction, published each time the service time changes.
+ *
+ * @par usage
+ * Take the ticks with rtos::Kernel::Clock::now() when the samples are taken, which is interrupt safe, and
+ * convert them with stamp() whenever convenient. The array form of stamp() reads the conversion once for
+ * the whole batch.
+ *
+ * A single writer, the current time service, calls publish(). Readers never wait for it: the conversion is
+ * double buffered and a reader only retries in the unlikely case the writer completed one publication and
+ * started the next while the reader was copying, which cannot happen in an interrupt handler preempting
+ * the writer.
+ */
+class WallClock {
+public:
+    using time_point = rtos::Kernel::Clock::time_point;
+
+    /** Time of day in the format of the Current Time characteristic */
+    struct Timestamp {
+        /** Seconds since 00:00 January 1, 1970 */
+        time_t seconds;
+        /** Number of 1/256 fractions of a second */
+        uint8_t fractions256;
+    };
+
+    static constexpr int32_t PPB = 1000000000;
+
+    /**
+     * @return Time of day of @p tick
+     */
+    Timestamp stamp(time_point tick) const
+    {
+        return to_timestamp(read().to_ms(tick.time_since_epoch().count()));
+    }
+
+    /**
+     * @return Time of day now
+     */
+    Timestamp stamp() const
+    {
+        return stamp(rtos::Kernel::Clock::now());
+    }
+
+    /**
+     * Convert @p count ticks to times of day with the same conversion.
+     */
+    void stamp(const time_point *ticks, Timestamp *timestamps, size_t count) const
+    {
+        const Conversion conversion = read();
+
+        for (size_t i = 0; i < count; i++) {
+            timestamps[i] = to_timestamp(conversion.to_ms(ticks[i].time_since_epoch().count()));
+        }
+    }
+
+    /**
+     * @return Time of day of @p tick in milliseconds since 00:00 January 1, 1970
+     */
+    int64_t to_ms(time_point tick) const
+    {
+        return read().to_ms(tick.time_since_epoch().count());
+    }
+
+    /**
+     * Make the time of day @p offset milliseconds ahead of the kernel clock at @p anchor, running @p drift
+     * parts per billion faster than the kernel clock. Only one thread may publish.
+     */
+    void publish(int64_t anchor, int64_t offset, int32_t drift)
+    {
+        /* odd while the next conversion is written, even once it is complete */
+        uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        _conversions[(sequence / 2 + 1) & 1] = Conversion{anchor, offset, drift};
+
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    struct Conversion {
+        int64_t anchor;
+        int64_t offset;
+        int32_t drift;
+
+        int64_t to_ms(int64_t tick) const
+        {
+            return tick + offset + ((tick - anchor) * drift) / PPB;
+        }
+    };
+
+    Conversion read() const
+    {
+        Conversion conversion;
+        uint32_t published;
+
+        do {
+            /* the last complete conversion, also while the next one is written to the other buffer */
+            published = _sequence.load(std::memory_order_acquire) & ~1u;
+            conversion = _conversions[(published / 2) & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            /* the buffer read is only written again by the publication after the next one */
+        } while (_sequence.load(std::memory_order_relaxed) - published >= 3);
+
+        return conversion;
+    }
+
+    static Timestamp to_timestamp(int64_t ms)
+    {
+        int64_t seconds = (ms >= 0) ? (ms / 1000) : ((ms - 999) / 1000);
+
+        return Timestamp{
+            static_cast<time_t>(seconds),
+            static_cast<uint8_t>(((ms - seconds * 1000) * 256) / 1000)
+        };
+    }
+
+    Conversion _conversions[2] = {};
+    std::atomic<uint32_t> _sequence{0};
+};
+
+#endif // WALL_CLOCK_H
@@ -22,11 +22,31 @@
 
 #if BLE_FEATURE_GATT_SERVER
 
+#include "ble/gatt/GattCodec.h"
+
+#include <cstring>
+#include <type_traits>
+
 /** The Device Information Service exposes manufacturer and/or vendor information about a device.
  *
  * The characteristics added are read only and written once. Do no construct this class.
  * Use the static method add_service to add the chosen Device Information Service characteristics to the server.
  *
+ * When the characteristics are known at compile time, pass them to add_service as typed values instead of
+ * pointers, for example:
+ *
+ * @code
+ * DeviceInformationService::add_service(
+ *     ble,
+ *     DeviceInformationService::manufacturers_name_t{"ARM"},
+ *     DeviceInformationService::pnp_id_t{0x01, 0x0822, 0x0001, 0x0100}
+ * );
+ * @endcode
+ *
+ * Only the characteristics passed are compiled in. Their packed values and the characteristic table are kept
+ * in static storage dedicated to that combination of characteristics and registration does not allocate
+ * from the heap. Characteristics absent from the call cost neither RAM nor code.
+ *
  * You can read the specification of the service on the bluetooth website, currently at:
  * https://www.bluetooth.com/specifications/specs/
  * Otherwise search the website for "Device Information Service".
@@ -70,6 +90,40 @@ public:
         const uint8_t *data;
     };
 
+    /** String characteristic, identified by its UUID.
+     *
+     * @attention The string is not copied and must outlive the service, use a string literal. */
+    template<uint16_t Uuid>
+    struct string_t {
+        const char *value;
+    };
+
+    using manufacturers_name_t = string_t<GattCharacteristic::UUID_MANUFACTURER_NAME_STRING_CHAR>;
+    using model_number_t       = string_t<GattCharacteristic::UUID_MODEL_NUMBER_STRING_CHAR>;
+    using serial_number_t      = string_t<GattCharacteristic::UUID_SERIAL_NUMBER_STRING_CHAR>;
+    using hardware_revision_t  = string_t<GattCharacteristic::UUID_HARDWARE_REVISION_STRING_CHAR>;
+    using firmware_revision_t  = string_t<GattCharacteristic::UUID_FIRMWARE_REVISION_STRING_CHAR>;
+    using software_revision_t  = string_t<GattCharacteristic::UUID_SOFTWARE_REVISION_STRING_CHAR>;
+
+private:
+    template<typename Characteristic>
+    class CharacteristicStorage;
+
+    template<typename... Characteristics>
+    class ServiceStorage;
+
+    template<typename Characteristic>
+    struct is_characteristic : std::false_type { };
+
+    template<typename... Characteristics>
+    struct all_characteristics;
+
+    template<typename Characteristic, typename... Characteristics>
+    struct count_of;
+
+    template<typename... Characteristics>
+    struct unique_characteristics;
+
 public:
     /** Adds device-specific information into the BLE stack. This must only be called once.
      *
@@ -100,9 +154,173 @@ public:
         const pnp_id_t *pnp_id           = nullptr
     );
 
+    /** Adds device-specific information selected at compile time into the BLE stack. This must only be called once.
+     *
+     * The characteristics are registered in the order of the arguments. Each type of characteristic may only
+     * be passed once.
+     *
+     * @param[in] ble A reference to a BLE object for the underlying controller.
+     * @param[in] characteristics Values of the characteristics present in the service, any of
+     * manufacturers_name_t, model_number_t, serial_number_t, hardware_revision_t, firmware_revision_t,
+     * software_revision_t, system_id_t, regulatory_cert_data_list_t and pnp_id_t.
+     *
+     * @note Do not call more than once. Calling this multiple times will create multiple
+     * instances of the service which is against the spec.
+     */
+    template<
+        typename... Characteristics,
+        typename std::enable_if<all_characteristics<Characteristics...>::value, int>::type = 0
+    >
+    static ble_error_t add_service(BLE &ble, const Characteristics &... characteristics)
+    {
+        static_assert(unique_characteristics<Characteristics...>::value,
+                      "Each characteristic may only be added to the service once");
+
+        /* one instance per combination of characteristics, constructed on the first call */
+        static ServiceStorage<Characteristics...> storage(characteristics...);
+
+        GattService deviceInformationService(
+            GattService::UUID_DEVICE_INFORMATION_SERVICE,
+            storage.table,
+            sizeof...(Characteristics)
+        );
+
+        return ble.gattServer().addService(deviceInformationService);
+    }
+
 private:
     DeviceInformationService() = delete;
     ~DeviceInformationService() = delete;
+
+    /* manufacturer defined identifier followed by the organizationally unique identifier */
+    static const size_t SYSTEM_ID_SIZE = ble::codec::uint40_le::size + ble::codec::uint24_le::size;
+    /* vendor id source, vendor id, product id and product version */
+    static const size_t PNP_ID_SIZE = ble::codec::uint8::size + 3 * ble::codec::uint16_le::size;
+
+    static void pack_system_id(const system_id_t &system_id, uint8_t (&value)[SYSTEM_ID_SIZE]);
+
+    static void pack_pnp_id(const pnp_id_t &pnp_id, uint8_t (&value)[PNP_ID_SIZE]);
+};
+
+template<uint16_t Uuid>
+struct DeviceInformationService::is_characteristic<DeviceInformationService::string_t<Uuid>> : std::true_type { };
+
+template<>
+struct DeviceInformationService::is_characteristic<DeviceInformationService::system_id_t> : std::true_type { };
+
+template<>
+struct DeviceInformationService::is_characteristic<DeviceInformationService::regulatory_cert_data_list_t> : std::true_type { };
+
+template<>
+struct DeviceInformationService::is_characteristic<DeviceInformationService::pnp_id_t> : std::true_type { };
+
+template<>
+struct DeviceInformationService::all_characteristics<> : std::true_type { };
+
+template<typename Characteristic, typename... Characteristics>
+struct DeviceInformationService::all_characteristics<Characteristic, Characteristics...> :
+    std::integral_constant<bool, is_characteristic<Characteristic>::value &&
+                                 all_characteristics<Characteristics...>::value> { };
+
+template<typename Characteristic>
+struct DeviceInformationService::count_of<Characteristic> : std::integral_constant<size_t, 0> { };
+
+template<typename Characteristic, typename First, typename... Characteristics>
+struct DeviceInformationService::count_of<Characteristic, First, Characteristics...> :
+    std::integral_constant<size_t, (std::is_same<Characteristic, First>::value ? 1 : 0) +
+                                   count_of<Characteristic, Characteristics...>::value> { };
+
+template<>
+struct DeviceInformationService::unique_characteristics<> : std::true_type { };
+
+template<typename Characteristic, typename... Characteristics>
+struct DeviceInformationService::unique_characteristics<Characteristic, Characteristics...> :
+    std::integral_constant<bool, count_of<Characteristic, Characteristics...>::value == 0 &&
+                                 unique_characteristics<Characteristics...>::value> { };
+
+template<uint16_t Uuid>
+class DeviceInformationService::CharacteristicStorage<DeviceInformationService::string_t<Uuid>> {
+public:
+    explicit CharacteristicStorage(const string_t<Uuid> &string) :
+        characteristic(
+            Uuid,
+            (uint8_t *)string.value,
+            strlen(string.value), /* Min length */
+            strlen(string.value), /* Max length */
+            GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ
+        )
+    {
+    }
+
+    GattCharacteristic characteristic;
+};
+
+template<>
+class DeviceInformationService::CharacteristicStorage<DeviceInformationService::system_id_t> {
+public:
+    explicit CharacteristicStorage(const system_id_t &system_id) :
+        characteristic(
+            GattCharacteristic::UUID_SYSTEM_ID_CHAR,
+            value,
+            SYSTEM_ID_SIZE, /* Min length */
+            SYSTEM_ID_SIZE, /* Max length */
+            GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ
+        )
+    {
+        pack_system_id(system_id, value);
+    }
+
+    uint8_t value[SYSTEM_ID_SIZE];
+    GattCharacteristic characteristic;
+};
+
+template<>
+class DeviceInformationService::CharacteristicStorage<DeviceInformationService::regulatory_cert_data_list_t> {
+public:
+    explicit CharacteristicStorage(const regulatory_cert_data_list_t &cert_data_list) :
+        characteristic(
+            GattCharacteristic::UUID_IEEE_REGULATORY_CERTIFICATION_DATA_LIST_CHAR,
+            (uint8_t *)cert_data_list.data,
+            cert_data_list.data[0] + 1, /* Min length */
+            cert_data_list.data[0] + 1, /* Max length */
+            GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ
+        )
+    {
+    }
+
+    GattCharacteristic characteristic;
+};
+
+template<>
+class DeviceInformationService::CharacteristicStorage<DeviceInformationService::pnp_id_t> {
+public:
+    explicit CharacteristicStorage(const pnp_id_t &pnp_id) :
+        characteristic(
+            GattCharacteristic::UUID_PNP_ID_CHAR,
+            value,
+            PNP_ID_SIZE, /* Min length */
+            PNP_ID_SIZE, /* Max length */
+            GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ
+        )
+    {
+        pack_pnp_id(pnp_id, value);
+    }
+
+    uint8_t value[PNP_ID_SIZE];
+    GattCharacteristic characteristic;
+};
+
+/* the characteristics of the service and the table handed to the GattServer */
+template<typename... Characteristics>
+class DeviceInformationService::ServiceStorage : private CharacteristicStorage<Characteristics>... {
+public:
+    explicit ServiceStorage(const Characteristics &... characteristics) :
+        CharacteristicStorage<Characteristics>(characteristics)...,
+        table{ &static_cast<CharacteristicStorage<Characteristics> &>(*this).characteristic... }
+    {
+    }
+
+    GattCharacteristic *table[sizeof...(Characteristics)];
 };
 
 #endif // BLE_FEATURE_GATT_SERVER
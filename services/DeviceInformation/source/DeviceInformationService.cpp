@@ -17,6 +17,8 @@
 
 #include "ble-service-device-information/DeviceInformationService.h"
 
+#include <new>
+
 #if BLE_FEATURE_GATT_SERVER
 
 ble_error_t DeviceInformationService::add_service(
@@ -62,10 +64,12 @@ ble_error_t DeviceInformationService::add_service(
         param_string_uuids[param_index++] = GattCharacteristic::UUID_SOFTWARE_REVISION_STRING_CHAR;
     }
 
+    /* the characteristics only need to live until the service is registered, keep them on the stack */
+    alignas(GattCharacteristic) uint8_t param_chars_storage[9][sizeof(GattCharacteristic)];
     GattCharacteristic* param_chars[9];
 
-    for (int i = 0; i < param_index; i++) {
-        param_chars[i] = new GattCharacteristic(
+    for (size_t i = 0; i < param_index; i++) {
+        param_chars[i] = new (param_chars_storage[i]) GattCharacteristic(
             param_string_uuids[i],
             (uint8_t *)param_strings[i],
             strlen(param_strings[i]), /* Min length */
@@ -74,66 +78,74 @@ ble_error_t DeviceInformationService::add_service(
         );
     }
 
-    uint8_t system_id_value[8];
+    uint8_t system_id_value[SYSTEM_ID_SIZE];
 
     if (system_id) {
-        /* pack the values */
-        for (int i = 0; i < 5; i++) {
-            system_id_value[i] = system_id->manufacturer_defined_identifier >> (i * 8);
-        }
-        for (int i = 0; i < 3; i++) {
-            system_id_value[5 + i] = system_id->organizationally_unique_identifier >> (i * 8);
-        }
-
-        param_chars[param_index++] = new GattCharacteristic(
+        pack_system_id(*system_id, system_id_value);
+
+        param_chars[param_index] = new (param_chars_storage[param_index]) GattCharacteristic(
             GattCharacteristic::UUID_SYSTEM_ID_CHAR,
             system_id_value,
-            8, /* Min length */
-            8, /* Max length */
+            SYSTEM_ID_SIZE, /* Min length */
+            SYSTEM_ID_SIZE, /* Max length */
             GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ
         );
+        param_index++;
     }
 
     if (cert_data_list && cert_data_list->data) {
-        param_chars[param_index++] = new GattCharacteristic(
+        param_chars[param_index] = new (param_chars_storage[param_index]) GattCharacteristic(
             GattCharacteristic::UUID_IEEE_REGULATORY_CERTIFICATION_DATA_LIST_CHAR,
             (uint8_t*)cert_data_list->data,
             cert_data_list->data[0] + 1, /* Min length */
             cert_data_list->data[0] + 1, /* Max length */
             GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ
         );
+        param_index++;
     }
 
-    uint8_t pnp_value[7];
+    uint8_t pnp_value[PNP_ID_SIZE];
 
     if (pnp_id) {
-        /* pack the values */
-        pnp_value[0] = pnp_id->vendor_id_source;
-        pnp_value[1] = pnp_id->vendor_id;
-        pnp_value[2] = pnp_id->vendor_id >> 8;
-        pnp_value[3] = pnp_id->product_id;
-        pnp_value[4] = pnp_id->product_id >> 8;
-        pnp_value[5] = pnp_id->product_version;
-        pnp_value[6] = pnp_id->product_version >> 8;
-
-        param_chars[param_index++] = new GattCharacteristic(
+        pack_pnp_id(*pnp_id, pnp_value);
+
+        param_chars[param_index] = new (param_chars_storage[param_index]) GattCharacteristic(
             GattCharacteristic::UUID_PNP_ID_CHAR,
             pnp_value,
-            7, /* Min length */
-            7, /* Max length */
+            PNP_ID_SIZE, /* Min length */
+            PNP_ID_SIZE, /* Max length */
             GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ
         );
+        param_index++;
     }
 
     GattService deviceInformationService(GattService::UUID_DEVICE_INFORMATION_SERVICE, param_chars, param_index);
 
     ble_error_t status = ble.gattServer().addService(deviceInformationService);
 
-    for (int i = 0; i < param_index; i++) {
-        delete param_chars[i];
+    for (size_t i = 0; i < param_index; i++) {
+        param_chars[i]->~GattCharacteristic();
     }
 
     return status;
 }
 
+void DeviceInformationService::pack_system_id(const system_id_t &system_id, uint8_t (&value)[SYSTEM_ID_SIZE])
+{
+    using namespace ble;
+
+    codec::encode<codec::uint40_le>(value, system_id.manufacturer_defined_identifier);
+    codec::encode<codec::uint24_le, codec::uint40_le::size>(value, system_id.organizationally_unique_identifier);
+}
+
+void DeviceInformationService::pack_pnp_id(const pnp_id_t &pnp_id, uint8_t (&value)[PNP_ID_SIZE])
+{
+    using namespace ble;
+
+    codec::encode<codec::uint8>(value, pnp_id.vendor_id_source);
+    codec::encode<codec::uint16_le, 1>(value, pnp_id.vendor_id);
+    codec::encode<codec::uint16_le, 3>(value, pnp_id.product_id);
+    codec::encode<codec::uint16_le, 5>(value, pnp_id.product_version);
+}
+
 #endif // BLE_FEATURE_GATT_SERVER
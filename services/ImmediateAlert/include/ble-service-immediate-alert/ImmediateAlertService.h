@@ -0,0 +1,144 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IMMEDIATE_ALERT_SERVICE_H
+#define IMMEDIATE_ALERT_SERVICE_H
+
+#include "ble/BLE.h"
+
+#if BLE_FEATURE_GATT_SERVER
+
+#include "ble/Gap.h"
+#include "events/EventQueue.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/common/AlertDispatcher.h"
+#include "ble/common/EmbeddedEvent.h"
+#include "ble/gatt/GattCodec.h"
+
+#include <chrono>
+
+/**
+ * Immediate Alert Service
+ *
+ * @par purpose
+ * The immediate alert service uses the Alert Level characteristic, as defined in
+ * https://www.bluetooth.com/specifications/assigned-numbers/, to let a client cause an alert in the device
+ * right away, for instance a phone looking for a key ring.
+ *
+ * @par usage
+ * The service has no event handler of its own: the alert level written by the clients is requested from the
+ * AlertDispatcher passed to the constructor, as the AlertDispatcher::IMMEDIATE_ALERT source, and the application
+ * handles the alerts of every source in one place. Pass the same dispatcher to LinkLossService to build a
+ * proximity tag.
+ *
+ * The alert level is shared by the clients, the last one written is in effect. The alert ends when a client
+ * writes "No Alert", when the connection of the client that requested it is disconnected, after the
+ * alert-timeout configuration option or set_alert_timeout() if not zero, or when the application calls
+ * stop_alert(), for instance from a button.
+ *
+ * This service requires access to gap events. Please register a ChainableGapEventHandler with Gap and pass it
+ * to this service.
+ *
+ * @note The specification for the immediate alert service can be found here:
+ * https://www.bluetooth.com/specifications/gatt
+ *
+ * @attention The user should not instantiate more than a single immediate alert service
+ */
+class ImmediateAlertService : private ble::Gap::EventHandler {
+public:
+    using AlertLevel = ble::AlertLevel;
+
+    /**
+     * Constructor
+     *
+     * @param ble BLE object to host the immediate alert service
+     * @param event_queue EventQueue object to configure events
+     * @param chainable_gap_event_handler ChainableGapEventHandler object to register multiple Gap events
+     * @param alert_dispatcher AlertDispatcher object the alerts are requested from, it must outlive the service
+     *
+     * @attention The Initializer must be called after instantiating an immediate alert service.
+     */
+    ImmediateAlertService(BLE &ble, events::EventQueue &event_queue,
+                          ChainableGapEventHandler &chainable_gap_event_handler,
+                          ble::AlertDispatcher &alert_dispatcher);
+
+    /**
+     * Destructor
+     *
+     * End the alert in progress and stop listening to gap events
+     */
+    ~ImmediateAlertService();
+
+    ImmediateAlertService(const ImmediateAlertService&) = delete;
+    ImmediateAlertService &operator=(const ImmediateAlertService&) = delete;
+
+    /**
+     * Initializer
+     *
+     * @return BLE_ERROR_NONE if the initialisation process completed successfully.
+     */
+    ble_error_t init();
+
+    /**
+     * @return Alert level in effect, NO_ALERT once the alert has ended
+     */
+    AlertLevel get_alert_level() const
+    {
+        return _alert_level;
+    }
+
+    /**
+     * Set alert timeout
+     *
+     * The alert in progress is re-armed to end @p timeout from now.
+     *
+     * @param timeout Alert timeout measured in ms, 0 to keep alerting until the alert is ended
+     */
+    void set_alert_timeout(std::chrono::milliseconds timeout);
+
+    /**
+     * Stop alert
+     *
+     * End the alert in progress, a client writing the alert level again starts a new one
+     */
+    void stop_alert();
+
+private:
+    void onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event) override;
+
+    void onDataWritten(GattWriteAuthCallbackParams *write_request);
+
+    void set_alert_level(AlertLevel level);
+
+    BLE &_ble;
+    ChainableGapEventHandler &_chainable_gap_event_handler;
+    ble::AlertDispatcher &_alert_dispatcher;
+
+    uint8_t _alert_level_value = 0;
+    WriteOnlyGattCharacteristic<uint8_t> _alert_level_char;
+
+    AlertLevel _alert_level = AlertLevel::NO_ALERT;
+    /* connection of the client that requested the alert in progress */
+    ble::connection_handle_t _alert_connection = 0;
+
+    std::chrono::milliseconds _alert_timeout{MBED_CONF_BLE_SERVICE_IMMEDIATE_ALERT_ALERT_TIMEOUT};
+    ble::EmbeddedEvent _alert_timeout_event;
+};
+
+#endif // BLE_FEATURE_GATT_SERVER
+
+#endif // IMMEDIATE_ALERT_SERVICE_H
@@ -0,0 +1,117 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble-service-immediate-alert/ImmediateAlertService.h"
+
+#if BLE_FEATURE_GATT_SERVER
+
+ImmediateAlertService::ImmediateAlertService(BLE &ble, events::EventQueue &event_queue,
+                                             ChainableGapEventHandler &chainable_gap_event_handler,
+                                             ble::AlertDispatcher &alert_dispatcher) :
+    _ble(ble),
+    _chainable_gap_event_handler(chainable_gap_event_handler),
+    _alert_dispatcher(alert_dispatcher),
+    _alert_level_char(GattCharacteristic::UUID_ALERT_LEVEL_CHAR, &_alert_level_value),
+    _alert_timeout_event(event_queue, mbed::callback(this, &ImmediateAlertService::stop_alert))
+{
+}
+
+ImmediateAlertService::~ImmediateAlertService()
+{
+    stop_alert();
+    _chainable_gap_event_handler.removeEventHandler(this);
+}
+
+ble_error_t ImmediateAlertService::init()
+{
+    GattCharacteristic *charTable[] = { &_alert_level_char };
+    GattService         immediateAlertService(GattService::UUID_IMMEDIATE_ALERT_SERVICE, charTable, 1);
+
+    _alert_level_char.setWriteAuthorizationCallback(this, &ImmediateAlertService::onDataWritten);
+
+    ble_error_t error = _ble.gattServer().addService(immediateAlertService);
+
+    if (error == BLE_ERROR_NONE) {
+        _chainable_gap_event_handler.addEventHandler(this);
+    }
+
+    return error;
+}
+
+void ImmediateAlertService::set_alert_timeout(std::chrono::milliseconds timeout)
+{
+    _alert_timeout = timeout;
+
+    if (_alert_level == AlertLevel::NO_ALERT) {
+        return;
+    }
+
+    if (_alert_timeout > std::chrono::milliseconds(0)) {
+        _alert_timeout_event.post(_alert_timeout);
+    } else {
+        _alert_timeout_event.cancel();
+    }
+}
+
+void ImmediateAlertService::stop_alert()
+{
+    set_alert_level(AlertLevel::NO_ALERT);
+}
+
+void ImmediateAlertService::set_alert_level(AlertLevel level)
+{
+    _alert_timeout_event.cancel();
+
+    if (level != AlertLevel::NO_ALERT && _alert_timeout > std::chrono::milliseconds(0)) {
+        _alert_timeout_event.post(_alert_timeout);
+    }
+
+    if (level == _alert_level) {
+        return;
+    }
+
+    _alert_level = level;
+    _alert_dispatcher.request(ble::AlertDispatcher::IMMEDIATE_ALERT, level);
+}
+
+void ImmediateAlertService::onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event)
+{
+    /* the client that requested the alert can no longer end it */
+    if (_alert_level != AlertLevel::NO_ALERT && event.getConnectionHandle() == _alert_connection) {
+        stop_alert();
+    }
+}
+
+void ImmediateAlertService::onDataWritten(GattWriteAuthCallbackParams *write_request)
+{
+    if (write_request->len != ble::codec::uint8::size) {
+        write_request->authorizationReply = GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH;
+        return;
+    }
+
+    const uint8_t level = ble::codec::uint8::decode(write_request->data);
+
+    if (level > (uint8_t)(AlertLevel::HIGH_ALERT)) {
+        write_request->authorizationReply = GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_OUT_OF_RANGE;
+        return;
+    }
+
+    _alert_connection = write_request->connHandle;
+    set_alert_level((AlertLevel) level);
+}
+
+#endif // BLE_FEATURE_GATT_SERVER
@@ -0,0 +1,1001 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASIC_LINK_LOSS_SERVICE_H
+#define BASIC_LINK_LOSS_SERVICE_H
+
+#include "ble/BLE.h"
+
+#if BLE_FEATURE_GATT_SERVER
+
+#include "ble/Gap.h"
+#include "events/EventQueue.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/common/AlertDispatcher.h"
+#include "ble/common/ConnectionTable.h"
+#include "ble/common/TimerWheel.h"
+#include "ble/gatt/GattCodec.h"
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+#include "ble-service-link-loss/RssiDetector.h"
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_DEFERRED_EVENTS
+#include "ble/common/EmbeddedEvent.h"
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX
+#include "ble/common/CommandMailbox.h"
+#endif
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Link Loss Service with static dispatch of its events
+ *
+ * @par purpose
+ * Implementation of the link loss service calling its event handlers at compile time. The handlers
+ * are inlined in the disconnection and timeout paths and a handler left empty compiles away: there is
+ * no vtable, no indirect call and no null check.
+ *
+ * @par usage
+ * Derive your handler from BasicLinkLossService<YourHandler> and hide on_alert_requested() and on_alert_end()
+ * with your own functions. With the early-warning option, hide on_pre_alert_requested() and on_pre_alert_end()
+ * as well. They may be private if BasicLinkLossService<YourHandler> is a friend.
+ *
+ * @code
+ * class Alarm : public BasicLinkLossService<Alarm> {
+ * public:
+ *     using BasicLinkLossService<Alarm>::BasicLinkLossService;
+ *
+ *     void on_alert_requested(AlertLevel level) { led = 1; }
+ *     void on_alert_end() { led = 0; }
+ * };
+ * @endcode
+ *
+ * Everything else behaves as described for LinkLossService, which is the instance of this template forwarding
+ * the events to a run-time EventHandler.
+ *
+ * @tparam Derived Class deriving from this template and handling its events
+ */
+template<typename Derived>
+class BasicLinkLossService : private ble::Gap::EventHandler {
+public:
+    using AlertLevel = ble::AlertLevel;
+
+    /**
+     * Constructor
+     *
+     * @param ble BLE object to host the link loss service
+     * @param event_queue EventQueue object to configure events
+     * @param chainable_gap_event_handler ChainableGapEventHandler object to register multiple Gap events
+     *
+     * @attention The Initializer must be called after instantiating a link loss service.
+     */
+    BasicLinkLossService(BLE &ble, events::EventQueue &event_queue, ChainableGapEventHandler &chainable_gap_event_handler);
+
+    /**
+     * Destructor
+     *
+     * Cancel the pending alert timeouts
+     */
+    ~BasicLinkLossService();
+
+    BasicLinkLossService(const BasicLinkLossService&) = delete;
+    BasicLinkLossService &operator=(const BasicLinkLossService&) = delete;
+
+    /**
+     * Initializer
+     *
+     * @return BLE_ERROR_NONE if the initialisation process completed successfully.
+     */
+    ble_error_t init();
+
+    /**
+     * Set alert level
+     *
+     * @param level New alert level, used for connections established from now on until their client
+     * writes the alert level characteristic
+     */
+    void set_alert_level(AlertLevel level);
+
+    /**
+     * Set alert timeout
+     *
+     * Alerts in progress are re-armed to end @p timeout from now. The timeouts are rounded up to the
+     * alert-timeout-resolution configuration option.
+     *
+     * @param timeout Alert timeout measured in ms, 0 to keep alerting until stop_alert() is called
+     */
+    void set_alert_timeout(std::chrono::milliseconds timeout);
+
+    /**
+     * Get alert level
+     *
+     * @return AlertLevel The alert level used for new connections
+     */
+    AlertLevel get_alert_level();
+
+    /**
+     * Get alert level of a connection
+     *
+     * @param connection_handle Handle of the connection
+     *
+     * @return AlertLevel The alert level of the connection or the alert level used for new connections
+     * if the connection is not tracked
+     */
+    AlertLevel get_alert_level(ble::connection_handle_t connection_handle);
+
+    /**
+     * Stop alert
+     *
+     * Stop all the alerts in progress and cancel their pending timeouts
+     */
+    void stop_alert();
+
+    /**
+     * Set alert dispatcher
+     *
+     * Request the alerts, and the pre-alerts with the early-warning option, from @p alert_dispatcher as well
+     * as from the event handlers, as the AlertDispatcher::LINK_LOSS and AlertDispatcher::OUT_OF_RANGE sources.
+     * The highest level of the alerts in progress is requested at once.
+     *
+     * @param alert_dispatcher AlertDispatcher object shared with the other sources of alert, nullptr to stop
+     * requesting from the one set before
+     */
+    void set_alert_dispatcher(ble::AlertDispatcher *alert_dispatcher);
+
+    /**
+     * Get overflow count
+     *
+     * The service tracks up to max-connections links and as many alerts. A link established while the table of
+     * connections is full is not monitored and its loss raises no alert. A link lost while max-connections alerts
+     * are in progress ends the oldest of them to make room for its own.
+     *
+     * @return Number of links not monitored and of alerts ended early, since the service was constructed
+     */
+    uint32_t get_overflow_count() const;
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+    /**
+     * Add RSSI sample
+     *
+     * Feed the early warning of a connection. A pre-alert is requested once the average RSSI of a link with an
+     * alert level stays below early-warning-rssi-threshold for early-warning-samples samples, and ends once it
+     * is back early-warning-hysteresis dB above the threshold.
+     *
+     * @param connection_handle Handle of the connection
+     * @param rssi RSSI of the link in dBm, as measured by the controller
+     */
+    void add_rssi_sample(ble::connection_handle_t connection_handle, int8_t rssi);
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX
+    /**
+     * Post set alert level
+     *
+     * Same as set_alert_level(), from any thread or interrupt handler. The level is set from the event queue.
+     *
+     * @return false if the command mailbox is full, the level is left unchanged
+     */
+    bool post_set_alert_level(AlertLevel level);
+
+    /**
+     * Post set alert timeout
+     *
+     * Same as set_alert_timeout(), from any thread or interrupt handler. The timeout is set from the event queue.
+     *
+     * @return false if the command mailbox is full, the timeout is left unchanged
+     */
+    bool post_set_alert_timeout(std::chrono::milliseconds timeout);
+
+    /**
+     * Post stop alert
+     *
+     * Same as stop_alert(), from any thread or interrupt handler. The alerts are stopped from the event queue.
+     *
+     * @return false if the command mailbox is full, the alerts go on
+     */
+    bool post_stop_alert();
+#endif
+
+    /**
+     * On alert requested
+     *
+     * Called if a client disconnects ungracefully, once for each link lost, with the alert level of that
+     * link. Hide it in Derived.
+     */
+    void on_alert_requested(AlertLevel) { }
+
+    /**
+     * On alert end
+     *
+     * Called if an alert is stopped, once for each alert requested. Hide it in Derived.
+     *
+     * An alert ends when its timeout expires, when stop_alert() is called or when the lost peer reconnects.
+     * The alerts of the links whose peer address is unknown, written to before the service listened to Gap,
+     * end with any reconnection.
+     */
+    void on_alert_end() { }
+
+    /**
+     * On pre-alert requested
+     *
+     * Called if the signal of a link with an alert level fades, before the link is lost. Hide it in Derived.
+     */
+    void on_pre_alert_requested(AlertLevel) { }
+
+    /**
+     * On pre-alert end
+     *
+     * Called once for each pre-alert requested, when the signal recovers or the link is disconnected, before
+     * the alert if the link is lost. Hide it in Derived.
+     */
+    void on_pre_alert_end() { }
+
+private:
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+    struct ConnectionParameters {
+        ble::conn_interval_t min_interval;
+        ble::conn_interval_t max_interval;
+        ble::slave_latency_t latency;
+        ble::supervision_timeout_t supervision_timeout;
+    };
+
+    /* the peer must miss more than two connection events, latency included, before the link is lost */
+    static_assert(MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_SUPERVISION_TIMEOUT >
+                  2 * (1 + MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_PERIPHERAL_LATENCY) *
+                  MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_CONNECTION_INTERVAL_MAX,
+                  "The alert supervision timeout is too short for the alert connection interval and latency");
+    static_assert(MBED_CONF_BLE_SERVICE_LINK_LOSS_IDLE_SUPERVISION_TIMEOUT >
+                  2 * (1 + MBED_CONF_BLE_SERVICE_LINK_LOSS_IDLE_PERIPHERAL_LATENCY) *
+                  MBED_CONF_BLE_SERVICE_LINK_LOSS_IDLE_CONNECTION_INTERVAL_MAX,
+                  "The idle supervision timeout is too short for the idle connection interval and latency");
+#endif
+
+    struct ConnectionState {
+        AlertLevel alert_level;
+        ble::peer_address_type_t peer_address_type;
+        ble::address_t peer_address;
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+        RssiDetector<
+            MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING_RSSI_THRESHOLD,
+            MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING_HYSTERESIS,
+            MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING_SMOOTHING,
+            MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING_SAMPLES
+        > rssi;
+        bool pre_alert = false;
+        /* level the pre-alert was requested with, its end cancels that request if it is still deferred */
+        AlertLevel pre_alert_level = AlertLevel::NO_ALERT;
+#endif
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+        ConnectionParameters parameters;
+        /* the alert parameters are the target, rather than the idle ones */
+        bool alert_parameters = false;
+        bool parameters_update_pending = false;
+        /* requests made for the current target */
+        uint8_t parameters_requests = 0;
+#endif
+    };
+
+    struct Event {
+        enum Type : uint8_t {
+            ALERT_REQUESTED,
+            ALERT_END,
+            PRE_ALERT_REQUESTED,
+            PRE_ALERT_END
+        };
+
+        Type type;
+        AlertLevel level;
+    };
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX
+    struct Command {
+        enum Type : uint8_t {
+            SET_ALERT_LEVEL,
+            SET_ALERT_TIMEOUT,
+            STOP_ALERT
+        };
+
+        Type type;
+        AlertLevel level;
+        uint32_t timeout_ms;
+    };
+#endif
+
+    struct Alert {
+        bool active = false;
+        AlertLevel level = AlertLevel::NO_ALERT;
+        /* order the alert was started in, the oldest one makes room for a new one when all are in progress */
+        uint32_t order = 0;
+        ble::peer_address_type_t peer_address_type;
+        ble::address_t peer_address;
+        ble::TimerWheel::Timer timeout;
+    };
+
+    Derived &derived()
+    {
+        return static_cast<Derived &>(*this);
+    }
+
+    void onConnectionComplete(const ble::ConnectionCompleteEvent &event) override;
+
+    void onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event) override;
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+    void onConnectionParametersUpdateComplete(const ble::ConnectionParametersUpdateCompleteEvent &event) override;
+#endif
+
+    void onDataRead(GattReadAuthCallbackParams *read_request);
+
+    void onDataWritten(GattWriteAuthCallbackParams *write_request);
+
+    void raise(typename Event::Type type, AlertLevel level = AlertLevel::NO_ALERT);
+
+    void dispatch(const Event &event);
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_DEFERRED_EVENTS
+    void defer(const Event &event);
+
+    void dispatch_deferred_events();
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX
+    void execute(const Command &command);
+#endif
+
+    void start_alert(const ConnectionState &connection);
+
+    static bool same_peer(const Alert &alert, ble::peer_address_type_t peer_address_type,
+                          const ble::address_t &peer_address);
+
+    void arm_alert_timeout(Alert &alert);
+
+    void end_alert(Alert &alert);
+
+    void request_dispatched_alerts();
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+    void update_pre_alert(ConnectionState &connection);
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+    static ConnectionParameters target_parameters(bool alert);
+
+    void apply_connection_parameter_policy(ble::connection_handle_t connection_handle, ConnectionState &connection);
+#endif
+
+    BLE &_ble;
+    ChainableGapEventHandler &_chainable_gap_event_handler;
+
+    ReadWriteGattCharacteristic<AlertLevel> _alert_level_char;
+    AlertLevel _alert_level = AlertLevel::NO_ALERT;
+    std::chrono::milliseconds _alert_timeout = std::chrono::milliseconds(0);
+
+    ble::ConnectionTable<ConnectionState, MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS> _connections;
+    Alert _alerts[MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS];
+    uint32_t _alerts_started = 0;
+    uint32_t _overflows = 0;
+    ble::TimerWheel _alert_timeouts;
+
+    ble::AlertDispatcher *_alert_dispatcher = nullptr;
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_DEFERRED_EVENTS
+    /*
+     * Events not dispatched yet, coalesced into counts rather than queued: an end cancels the request of its
+     * level if the handlers were not told of it yet. Pending requests are for alerts still in progress and
+     * pending ends for alerts already dispatched, neither outnumbers the links tracked.
+     */
+    struct DeferredEvents {
+        uint8_t requested[3] = {};
+        uint8_t ended = 0;
+    };
+
+    static_assert(MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS <= UINT8_MAX,
+                  "The deferred events of every link are counted on a byte");
+
+    DeferredEvents _deferred_alerts;
+    DeferredEvents _deferred_pre_alerts;
+    bool _dispatching = false;
+    ble::EmbeddedEvent _deferred_events;
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX
+    ble::CommandMailbox<Command, MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX_CAPACITY> _commands;
+#endif
+};
+
+template<typename Derived>
+BasicLinkLossService<Derived>::BasicLinkLossService(BLE &ble, events::EventQueue &event_queue,
+                                                    ChainableGapEventHandler &chainable_gap_event_handler) :
+    _ble(ble),
+    _chainable_gap_event_handler(chainable_gap_event_handler),
+    _alert_level_char(GattCharacteristic::UUID_ALERT_LEVEL_CHAR, &_alert_level),
+    _alert_timeouts(event_queue, std::chrono::milliseconds(MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_TIMEOUT_RESOLUTION))
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_DEFERRED_EVENTS
+    , _deferred_events(event_queue, mbed::callback(this, &BasicLinkLossService::dispatch_deferred_events))
+#endif
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX
+    , _commands(event_queue, mbed::callback(this, &BasicLinkLossService::execute))
+#endif
+{
+}
+
+template<typename Derived>
+BasicLinkLossService<Derived>::~BasicLinkLossService()
+{
+    for (Alert &alert : _alerts) {
+        _alert_timeouts.cancel(alert.timeout);
+    }
+}
+
+template<typename Derived>
+ble_error_t BasicLinkLossService<Derived>::init()
+{
+    GattCharacteristic *charTable[] = { &_alert_level_char };
+    GattService         linkLossService(GattService::UUID_LINK_LOSS_SERVICE, charTable, 1);
+
+    _alert_level_char.setReadAuthorizationCallback(this, &BasicLinkLossService::onDataRead);
+    _alert_level_char.setWriteAuthorizationCallback(this, &BasicLinkLossService::onDataWritten);
+
+    ble_error_t error = _ble.gattServer().addService(linkLossService);
+
+    if (error == BLE_ERROR_NONE) {
+        _chainable_gap_event_handler.addEventHandler(this);
+    }
+
+    return error;
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::set_alert_level(AlertLevel level)
+{
+    _alert_level = level;
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::set_alert_timeout(std::chrono::milliseconds timeout)
+{
+    _alert_timeout = timeout;
+
+    for (Alert &alert : _alerts) {
+        if (alert.active) {
+            arm_alert_timeout(alert);
+        }
+    }
+}
+
+template<typename Derived>
+typename BasicLinkLossService<Derived>::AlertLevel BasicLinkLossService<Derived>::get_alert_level()
+{
+    return _alert_level;
+}
+
+template<typename Derived>
+typename BasicLinkLossService<Derived>::AlertLevel
+BasicLinkLossService<Derived>::get_alert_level(ble::connection_handle_t connection_handle)
+{
+    ConnectionState *connection = _connections.find(connection_handle);
+
+    return connection ? connection->alert_level : _alert_level;
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::stop_alert()
+{
+    for (Alert &alert : _alerts) {
+        if (alert.active) {
+            end_alert(alert);
+        }
+    }
+}
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+template<typename Derived>
+void BasicLinkLossService<Derived>::add_rssi_sample(ble::connection_handle_t connection_handle, int8_t rssi)
+{
+    ConnectionState *connection = _connections.find(connection_handle);
+    if (!connection) {
+        return;
+    }
+
+    connection->rssi.add_sample(rssi);
+
+    update_pre_alert(*connection);
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::update_pre_alert(ConnectionState &connection)
+{
+    /* a link without alert level is not worth a pre-alert */
+    const bool pre_alert = connection.rssi.warning() && connection.alert_level != AlertLevel::NO_ALERT;
+
+    if (pre_alert == connection.pre_alert) {
+        return;
+    }
+
+    connection.pre_alert = pre_alert;
+
+    if (pre_alert) {
+        connection.pre_alert_level = connection.alert_level;
+        raise(Event::PRE_ALERT_REQUESTED, connection.pre_alert_level);
+    } else {
+        raise(Event::PRE_ALERT_END, connection.pre_alert_level);
+    }
+}
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_COMMAND_MAILBOX
+template<typename Derived>
+bool BasicLinkLossService<Derived>::post_set_alert_level(AlertLevel level)
+{
+    return _commands.post(Command{Command::SET_ALERT_LEVEL, level, 0});
+}
+
+template<typename Derived>
+bool BasicLinkLossService<Derived>::post_set_alert_timeout(std::chrono::milliseconds timeout)
+{
+    return _commands.post(Command{Command::SET_ALERT_TIMEOUT, AlertLevel::NO_ALERT,
+                                  static_cast<uint32_t>(timeout.count())});
+}
+
+template<typename Derived>
+bool BasicLinkLossService<Derived>::post_stop_alert()
+{
+    return _commands.post(Command{Command::STOP_ALERT, AlertLevel::NO_ALERT, 0});
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::execute(const Command &command)
+{
+    switch (command.type) {
+        case Command::SET_ALERT_LEVEL:
+            set_alert_level(command.level);
+            break;
+        case Command::SET_ALERT_TIMEOUT:
+            set_alert_timeout(std::chrono::milliseconds(command.timeout_ms));
+            break;
+        case Command::STOP_ALERT:
+            stop_alert();
+            break;
+    }
+}
+#endif
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::set_alert_dispatcher(ble::AlertDispatcher *alert_dispatcher)
+{
+    if (_alert_dispatcher) {
+        _alert_dispatcher->request(ble::AlertDispatcher::LINK_LOSS, AlertLevel::NO_ALERT);
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+        _alert_dispatcher->request(ble::AlertDispatcher::OUT_OF_RANGE, AlertLevel::NO_ALERT);
+#endif
+    }
+
+    _alert_dispatcher = alert_dispatcher;
+
+    request_dispatched_alerts();
+}
+
+template<typename Derived>
+uint32_t BasicLinkLossService<Derived>::get_overflow_count() const
+{
+    return _overflows;
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::raise(typename Event::Type type, AlertLevel level)
+{
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_DEFERRED_EVENTS
+    defer(Event{type, level});
+#else
+    dispatch(Event{type, level});
+#endif
+
+    request_dispatched_alerts();
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::request_dispatched_alerts()
+{
+    if (!_alert_dispatcher) {
+        return;
+    }
+
+    /* the dispatcher coalesces the requests, the service requests the highest level of its alerts */
+    AlertLevel link_loss_level = AlertLevel::NO_ALERT;
+    for (const Alert &alert : _alerts) {
+        if (alert.active && alert.level > link_loss_level) {
+            link_loss_level = alert.level;
+        }
+    }
+    _alert_dispatcher->request(ble::AlertDispatcher::LINK_LOSS, link_loss_level);
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+    AlertLevel out_of_range_level = AlertLevel::NO_ALERT;
+    _connections.for_each([&](ble::connection_handle_t, ConnectionState &connection) {
+        if (connection.pre_alert && connection.alert_level > out_of_range_level) {
+            out_of_range_level = connection.alert_level;
+        }
+    });
+    _alert_dispatcher->request(ble::AlertDispatcher::OUT_OF_RANGE, out_of_range_level);
+#endif
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::dispatch(const Event &event)
+{
+    switch (event.type) {
+        case Event::ALERT_REQUESTED:
+            derived().on_alert_requested(event.level);
+            break;
+        case Event::ALERT_END:
+            derived().on_alert_end();
+            break;
+        case Event::PRE_ALERT_REQUESTED:
+            derived().on_pre_alert_requested(event.level);
+            break;
+        case Event::PRE_ALERT_END:
+            derived().on_pre_alert_end();
+            break;
+    }
+}
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_DEFERRED_EVENTS
+template<typename Derived>
+void BasicLinkLossService<Derived>::defer(const Event &event)
+{
+    const bool alert = (event.type == Event::ALERT_REQUESTED || event.type == Event::ALERT_END);
+    DeferredEvents &deferred = alert ? _deferred_alerts : _deferred_pre_alerts;
+    uint8_t &requested = deferred.requested[static_cast<uint8_t>(event.level)];
+
+    if (event.type == Event::ALERT_REQUESTED || event.type == Event::PRE_ALERT_REQUESTED) {
+        requested++;
+    } else if (requested) {
+        /* the handlers were not told of the request, they are not told of its end either */
+        requested--;
+    } else {
+        deferred.ended++;
+    }
+
+    /* the events raised by the handlers are dispatched before dispatch_deferred_events() returns */
+    if (!_dispatching && !_deferred_events.pending()) {
+        _deferred_events.post(std::chrono::milliseconds(0));
+    }
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::dispatch_deferred_events()
+{
+    /* take a request of the highest level pending, the level is that of the request */
+    auto take_request = [](DeferredEvents &deferred, AlertLevel &level) {
+        for (uint8_t i = sizeof(deferred.requested); i-- > 0;) {
+            if (deferred.requested[i]) {
+                deferred.requested[i]--;
+                level = static_cast<AlertLevel>(i);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    _dispatching = true;
+
+    /*
+     * the ends come first, they are those of alerts dispatched before: a pre-alert ends before the alert of
+     * its link is requested and the requests dispatched last are those of the alerts still in progress
+     */
+    for (;;) {
+        AlertLevel level = AlertLevel::NO_ALERT;
+
+        if (_deferred_pre_alerts.ended) {
+            _deferred_pre_alerts.ended--;
+            dispatch(Event{Event::PRE_ALERT_END, level});
+        } else if (_deferred_alerts.ended) {
+            _deferred_alerts.ended--;
+            dispatch(Event{Event::ALERT_END, level});
+        } else if (take_request(_deferred_pre_alerts, level)) {
+            dispatch(Event{Event::PRE_ALERT_REQUESTED, level});
+        } else if (take_request(_deferred_alerts, level)) {
+            dispatch(Event{Event::ALERT_REQUESTED, level});
+        } else {
+            break;
+        }
+    }
+
+    _dispatching = false;
+}
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+template<typename Derived>
+typename BasicLinkLossService<Derived>::ConnectionParameters
+BasicLinkLossService<Derived>::target_parameters(bool alert)
+{
+    using std::chrono::milliseconds;
+
+    if (alert) {
+        return ConnectionParameters{
+            milliseconds(MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_CONNECTION_INTERVAL_MIN),
+            milliseconds(MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_CONNECTION_INTERVAL_MAX),
+            ble::slave_latency_t(MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_PERIPHERAL_LATENCY),
+            milliseconds(MBED_CONF_BLE_SERVICE_LINK_LOSS_ALERT_SUPERVISION_TIMEOUT)
+        };
+    }
+
+    return ConnectionParameters{
+        milliseconds(MBED_CONF_BLE_SERVICE_LINK_LOSS_IDLE_CONNECTION_INTERVAL_MIN),
+        milliseconds(MBED_CONF_BLE_SERVICE_LINK_LOSS_IDLE_CONNECTION_INTERVAL_MAX),
+        ble::slave_latency_t(MBED_CONF_BLE_SERVICE_LINK_LOSS_IDLE_PERIPHERAL_LATENCY),
+        milliseconds(MBED_CONF_BLE_SERVICE_LINK_LOSS_IDLE_SUPERVISION_TIMEOUT)
+    };
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::apply_connection_parameter_policy(ble::connection_handle_t connection_handle,
+                                                                      ConnectionState &connection)
+{
+    const bool alert = connection.alert_level != AlertLevel::NO_ALERT;
+
+    if (alert != connection.alert_parameters) {
+        connection.alert_parameters = alert;
+        connection.parameters_requests = 0;
+    }
+
+    /* the outcome of the request in progress tells whether another one is needed */
+    if (connection.parameters_update_pending) {
+        return;
+    }
+
+    const ConnectionParameters target = target_parameters(alert);
+    const ConnectionParameters &current = connection.parameters;
+
+    if (current.max_interval.value() >= target.min_interval.value() &&
+        current.max_interval.value() <= target.max_interval.value() &&
+        current.latency.value() == target.latency.value() &&
+        current.supervision_timeout.value() == target.supervision_timeout.value()) {
+        return;
+    }
+
+    /* the peer is free to reject or amend the parameters, do not insist forever */
+    if (connection.parameters_requests >= MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_REQUESTS) {
+        return;
+    }
+
+    ble_error_t error = _ble.gap().updateConnectionParameters(
+        connection_handle,
+        target.min_interval,
+        target.max_interval,
+        target.latency,
+        target.supervision_timeout
+    );
+
+    connection.parameters_requests++;
+    connection.parameters_update_pending = (error == BLE_ERROR_NONE);
+}
+#endif
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::start_alert(const ConnectionState &connection)
+{
+    Alert *free_alert = nullptr;
+    Alert *oldest_alert = nullptr;
+
+    for (Alert &alert : _alerts) {
+        if (!alert.active) {
+            free_alert = free_alert ? free_alert : &alert;
+        } else if (same_peer(alert, connection.peer_address_type, connection.peer_address)) {
+            /* this peer is already being alerted */
+            return;
+        } else if (!oldest_alert || static_cast<int32_t>(alert.order - oldest_alert->order) < 0) {
+            oldest_alert = &alert;
+        }
+    }
+
+    if (!free_alert) {
+        /* the link just lost matters more than the one lost first, which may never come back */
+        _overflows++;
+        end_alert(*oldest_alert);
+        free_alert = oldest_alert;
+    }
+
+    free_alert->active = true;
+    free_alert->order = _alerts_started++;
+    free_alert->level = connection.alert_level;
+    free_alert->peer_address_type = connection.peer_address_type;
+    free_alert->peer_address = connection.peer_address;
+
+    raise(Event::ALERT_REQUESTED, connection.alert_level);
+
+    arm_alert_timeout(*free_alert);
+}
+
+template<typename Derived>
+bool BasicLinkLossService<Derived>::same_peer(const Alert &alert, ble::peer_address_type_t peer_address_type,
+                                              const ble::address_t &peer_address)
+{
+    /* the links whose peer address is unknown cannot be told apart, each has its own alert */
+    if (peer_address_type == ble::peer_address_type_t::ANONYMOUS) {
+        return false;
+    }
+
+    return alert.peer_address_type == peer_address_type && alert.peer_address == peer_address;
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::arm_alert_timeout(Alert &alert)
+{
+    if (_alert_timeout > std::chrono::milliseconds(0)) {
+        _alert_timeouts.arm(alert.timeout, _alert_timeout, [this, &alert] { end_alert(alert); });
+    } else {
+        _alert_timeouts.cancel(alert.timeout);
+    }
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::end_alert(Alert &alert)
+{
+    _alert_timeouts.cancel(alert.timeout);
+    alert.active = false;
+    raise(Event::ALERT_END, alert.level);
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::onConnectionComplete(const ble::ConnectionCompleteEvent &event)
+{
+    if (event.getStatus() != BLE_ERROR_NONE) {
+        return;
+    }
+
+    /*
+     * the peer is back, stop the alert raised when its previous link was lost; any peer may be the one
+     * whose address was unknown
+     */
+    for (Alert &alert : _alerts) {
+        if (alert.active &&
+            (alert.peer_address_type == ble::peer_address_type_t::ANONYMOUS ||
+             same_peer(alert, event.getPeerAddressType(), event.getPeerAddress()))) {
+            end_alert(alert);
+        }
+    }
+
+    ConnectionState *connection = _connections.insert(event.getConnectionHandle());
+    if (connection) {
+        connection->alert_level = _alert_level;
+        connection->peer_address_type = event.getPeerAddressType();
+        connection->peer_address = event.getPeerAddress();
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+        /* the interval in effect is both ends of its range */
+        connection->parameters = ConnectionParameters{
+            event.getConnectionInterval(),
+            event.getConnectionInterval(),
+            event.getConnectionLatency(),
+            event.getSupervisionTimeout()
+        };
+        apply_connection_parameter_policy(event.getConnectionHandle(), *connection);
+#endif
+    } else {
+        /* every entry is taken, this link is not monitored */
+        _overflows++;
+    }
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event)
+{
+    ConnectionState *connection = _connections.find(event.getConnectionHandle());
+    if (!connection) {
+        return;
+    }
+
+    ConnectionState lost_connection = *connection;
+    _connections.erase(event.getConnectionHandle());
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+    if (lost_connection.pre_alert) {
+        raise(Event::PRE_ALERT_END, lost_connection.pre_alert_level);
+    }
+#endif
+
+    if (event.getReason() == ble::disconnection_reason_t::CONNECTION_TIMEOUT &&
+        lost_connection.alert_level != AlertLevel::NO_ALERT) {
+        start_alert(lost_connection);
+    }
+}
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+template<typename Derived>
+void BasicLinkLossService<Derived>::onConnectionParametersUpdateComplete(
+    const ble::ConnectionParametersUpdateCompleteEvent &event)
+{
+    ConnectionState *connection = _connections.find(event.getConnectionHandle());
+    if (!connection) {
+        return;
+    }
+
+    connection->parameters_update_pending = false;
+
+    /* the update may have been initiated by the peer, or amended by it */
+    if (event.getStatus() == BLE_ERROR_NONE) {
+        connection->parameters = ConnectionParameters{
+            event.getConnectionInterval(),
+            event.getConnectionInterval(),
+            event.getSlaveLatency(),
+            event.getSupervisionTimeout()
+        };
+    }
+
+    apply_connection_parameter_policy(event.getConnectionHandle(), *connection);
+}
+#endif
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::onDataRead(GattReadAuthCallbackParams *read_request)
+{
+    ConnectionState *connection = _connections.find(read_request->connHandle);
+
+    read_request->data = reinterpret_cast<uint8_t *>(connection ? &connection->alert_level : &_alert_level);
+    read_request->len  = sizeof(AlertLevel);
+    read_request->authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+}
+
+template<typename Derived>
+void BasicLinkLossService<Derived>::onDataWritten(GattWriteAuthCallbackParams *write_request)
+{
+    if (write_request->len != ble::codec::uint8::size) {
+        write_request->authorizationReply = GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH;
+        return;
+    }
+
+    const uint8_t level = ble::codec::uint8::decode(write_request->data);
+
+    if (level > (uint8_t)(AlertLevel::HIGH_ALERT)) {
+        write_request->authorizationReply = GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_OUT_OF_RANGE;
+        return;
+    }
+
+    ConnectionState *connection = _connections.find(write_request->connHandle);
+    if (!connection) {
+        /* the connection was established before the service was listening to gap events */
+        connection = _connections.insert(write_request->connHandle);
+        if (!connection) {
+            _overflows++;
+            write_request->authorizationReply =
+                GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_RESOURCES;
+            return;
+        }
+        /* Gap does not tell the address of the peer, the connection is anonymous */
+        connection->peer_address_type = ble::peer_address_type_t::ANONYMOUS;
+        connection->peer_address = ble::address_t();
+    }
+
+    connection->alert_level = (AlertLevel) level;
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+    update_pre_alert(*connection);
+#endif
+
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_CONNECTION_PARAMETER_POLICY
+    apply_connection_parameter_policy(write_request->connHandle, *connection);
+#endif
+}
+
+#endif // BLE_FEATURE_GATT_SERVER
+
+#endif // BASIC_LINK_LOSS_SERVICE_H
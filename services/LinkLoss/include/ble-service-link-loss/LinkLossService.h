@@ -22,11 +22,7 @@
 
 #if BLE_FEATURE_GATT_SERVER
 
-#include "ble/Gap.h"
-#include "events/EventQueue.h"
-#include "ble/gap/ChainableGapEventHandler.h"
-
-#include <chrono>
+#include "ble-service-link-loss/BasicLinkLossService.h"
 
 /**
  * Link Loss Service
@@ -44,24 +40,22 @@
  * This service requires access to gap events. Please register a
  * ChainableGapEventHandler with Gap and pass it to this service.
  *
+ * Events are forwarded to the EventHandler set at run time, see BasicLinkLossService to
+ * handle them at compile time instead.
+ *
  * @note The specification for the link loss service can be found here:
  * https://www.bluetooth.com/specifications/gatt
  *
  * @attention The user should not instantiate more than a single link loss service
  */
-class LinkLossService : private ble::Gap::EventHandler {
+class LinkLossService : public BasicLinkLossService<LinkLossService> {
 public:
-    enum class AlertLevel : uint8_t {
-        NO_ALERT    = 0,
-        MILD_ALERT  = 1,
-        HIGH_ALERT  = 2
-    };
-
     struct EventHandler {
         /**
          * On alert requested
          *
-         * This function is called if the client disconnects ungracefully
+         * This function is called if a client disconnects ungracefully.
+         * It is called once for each link lost.
          *
          * @attention This is an abstract function and should be overridden by the user.
          */
@@ -69,11 +63,27 @@ public:
         /**
          * On alert end
          *
-         * This function is called if the alert is stopped
+         * This function is called if an alert is stopped, once for each alert requested. An alert ends when
+         * its timeout expires, when stop_alert() is called or when the lost peer reconnects; the alerts of
+         * links whose peer address is unknown end with any reconnection.
          *
          * @attention This is an abstract function and should be overridden by the user.
          */
         virtual void on_alert_end() { }
+        /**
+         * On pre-alert requested
+         *
+         * This function is called if the signal of a link fades, before the link is lost, with the
+         * early-warning configuration option enabled.
+         */
+        virtual void on_pre_alert_requested(AlertLevel) { }
+        /**
+         * On pre-alert end
+         *
+         * This function is called once for each pre-alert requested, when the signal recovers or the
+         * link is disconnected. If the link was lost, on_alert_requested() follows.
+         */
+        virtual void on_pre_alert_end() { }
     };
 
     /**
@@ -91,26 +101,6 @@ public:
      */
     LinkLossService(BLE &ble, events::EventQueue &event_queue, ChainableGapEventHandler &chainable_gap_event_handler);
 
-    /**
-     * Destructor
-     *
-     * Cancel the pending event queue timeout
-     */
-    ~LinkLossService();
-
-    LinkLossService(const LinkLossService&) = delete;
-    LinkLossService &operator=(const LinkLossService&) = delete;
-
-    /**
-     * Initializer
-     *
-     * Set the onDataWritten() function as the write authorization callback for the alert level characteristic.
-     * Add the link loss service to the BLE device and chain of GAP event handlers.
-     *
-     * @return BLE_ERROR_NONE if the initialisation process completed successfully.
-     */
-    ble_error_t init();
-
     /**
      * Set event handler
      *
@@ -118,54 +108,23 @@ public:
      */
     void set_event_handler(EventHandler* handler);
 
-    /**
-     * Set alert level
-     *
-     * @param level New alert level
-     */
-    void set_alert_level(AlertLevel level);
-
-    /**
-     * Set alert timeout
-     *
-     * @param timeout Event queue timeout measured in ms
-     */
-    void set_alert_timeout(std::chrono::milliseconds timeout);
-
-    /**
-     * Get alert level
-     *
-     * @return AlertLevel The current alert level
-     */
-    AlertLevel get_alert_level();
-
-    /**
-     * Stop alert
-     *
-     * Cancel the pending event queue timeout
-     */
-    void stop_alert();
-
 private:
-    void onConnectionComplete(const ble::ConnectionCompleteEvent &event) override;
+    friend class BasicLinkLossService<LinkLossService>;
 
-    void onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event) override;
+    void on_alert_requested(AlertLevel level);
 
-    void onDataWritten(GattWriteAuthCallbackParams *write_request);
+    void on_alert_end();
 
-    BLE &_ble;
-    events::EventQueue &_event_queue;
-    ChainableGapEventHandler &_chainable_gap_event_handler;
+    void on_pre_alert_requested(AlertLevel level);
 
-    ReadWriteGattCharacteristic<AlertLevel> _alert_level_char;
-    AlertLevel _alert_level = AlertLevel::NO_ALERT;
-    std::chrono::milliseconds _alert_timeout = std::chrono::milliseconds(0);
-    EventHandler *_alert_handler = nullptr;
+    void on_pre_alert_end();
 
-    bool _in_alert = false;
-    int _event_queue_handle = 0;
+    EventHandler *_alert_handler = nullptr;
 };
 
+/* the service itself is compiled once, in LinkLossService.cpp */
+extern template class BasicLinkLossService<LinkLossService>;
+
 #endif // BLE_FEATURE_GATT_SERVER
 
 #endif // LINK_LOSS_SERVICE_H
@@ -0,0 +1,140 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RSSI_DETECTOR_H
+#define RSSI_DETECTOR_H
+
+#include <cstdint>
+
+/**
+ * RSSI Detector
+ *
+ * @par purpose
+ * Tells from the received signal strength of a link that its peer is moving out of range, before the link
+ * is lost. A link is only reported lost once no packet got through for a whole supervision timeout, often
+ * several seconds after the signal faded below the sensitivity of the receiver.
+ *
+ * @par usage
+ * Pass every RSSI sample of the link to add_sample(). The samples are smoothed by an exponential moving
+ * average giving a weight of 1 / 2^@p Smoothing to the newest one, so that a single sample lost in a fade
+ * is not taken for a trend. The warning is raised once the average stayed below @p Threshold for @p Samples
+ * samples in a row, and cleared once it stayed at or above @p Threshold + @p Hysteresis as long.
+ *
+ * The path loss is the transmit power of the peer less the RSSI: with a constant transmit power, a path
+ * loss threshold is an RSSI threshold.
+ *
+ * @tparam Threshold RSSI in dBm below which the warning is raised
+ * @tparam Hysteresis Margin in dB above the threshold the RSSI must come back to for the warning to clear
+ * @tparam Smoothing Weight of the newest sample in the average, as a power of two, 0 to disable smoothing
+ * @tparam Samples Number of samples in a row past a threshold needed to raise or clear the warning
+ */
+template<int8_t Threshold, uint8_t Hysteresis, uint8_t Smoothing, uint8_t Samples>
+class RssiDetector {
+    static_assert(Smoothing <= 7, "The average is kept in 1/16 dBm steps, a weight below 1/128 does not move it");
+    static_assert(Samples > 0, "At least one sample is needed to raise the warning");
+
+public:
+    /** Value reported by the controller when the RSSI is not available */
+    static constexpr int8_t RSSI_NOT_AVAILABLE = 127;
+
+    enum class Transition : uint8_t {
+        NONE,
+        WARNING_RAISED,
+        WARNING_CLEARED
+    };
+
+    /**
+     * Add the RSSI sample @p rssi, in dBm, to the average.
+     *
+     * @return The transition of the warning caused by the sample, if any
+     */
+    Transition add_sample(int8_t rssi)
+    {
+        if (rssi == RSSI_NOT_AVAILABLE) {
+            return Transition::NONE;
+        }
+
+        if (!_sampled) {
+            _average = rssi * STEPS_PER_DBM;
+            _sampled = true;
+        } else {
+            _average += (rssi * STEPS_PER_DBM - _average) / (1 << Smoothing);
+        }
+
+        const bool crossed = _warning ?
+            (_average >= (Threshold + Hysteresis) * STEPS_PER_DBM) :
+            (_average < Threshold * STEPS_PER_DBM);
+
+        if (!crossed) {
+            _crossings = 0;
+            return Transition::NONE;
+        }
+
+        if (++_crossings < Samples) {
+            return Transition::NONE;
+        }
+
+        _crossings = 0;
+        _warning = !_warning;
+
+        return _warning ? Transition::WARNING_RAISED : Transition::WARNING_CLEARED;
+    }
+
+    /**
+     * @return true while the warning is raised
+     */
+    bool warning() const
+    {
+        return _warning;
+    }
+
+    /**
+     * @return Average of the samples in dBm, rounded towards zero, or RSSI_NOT_AVAILABLE before the first sample
+     */
+    int8_t average() const
+    {
+        return _sampled ? static_cast<int8_t>(_average / STEPS_PER_DBM) : RSSI_NOT_AVAILABLE;
+    }
+
+    /**
+     * Forget the samples and clear the warning.
+     */
+    void reset()
+    {
+        _average = 0;
+        _crossings = 0;
+        _sampled = false;
+        _warning = false;
+    }
+
+private:
+    static constexpr int16_t STEPS_PER_DBM = 16;
+
+    /* in 1/16 dBm */
+    int16_t _average = 0;
+    uint8_t _crossings = 0;
+    bool _sampled = false;
+    bool _warning = false;
+};
+
+template<int8_t Threshold, uint8_t Hysteresis, uint8_t Smoothing, uint8_t Samples>
+constexpr int8_t RssiDetector<Threshold, Hysteresis, Smoothing, Samples>::RSSI_NOT_AVAILABLE;
+
+template<int8_t Threshold, uint8_t Hysteresis, uint8_t Smoothing, uint8_t Samples>
+constexpr int16_t RssiDetector<Threshold, Hysteresis, Smoothing, Samples>::STEPS_PER_DBM;
+
+#endif // RSSI_DETECTOR_H
@@ -19,33 +19,11 @@
 
 #if BLE_FEATURE_GATT_SERVER
 
-LinkLossService::LinkLossService(BLE &ble, events::EventQueue &event_queue, ChainableGapEventHandler &chainable_gap_event_handler) :
-    _ble(ble),
-    _event_queue(event_queue),
-    _chainable_gap_event_handler(chainable_gap_event_handler),
-    _alert_level_char(GattCharacteristic::UUID_ALERT_LEVEL_CHAR, &_alert_level)
-{
-}
-
-LinkLossService::~LinkLossService()
-{
-    _event_queue.cancel(_event_queue_handle);
-}
+template class BasicLinkLossService<LinkLossService>;
 
-ble_error_t LinkLossService::init()
+LinkLossService::LinkLossService(BLE &ble, events::EventQueue &event_queue, ChainableGapEventHandler &chainable_gap_event_handler) :
+    BasicLinkLossService(ble, event_queue, chainable_gap_event_handler)
 {
-    GattCharacteristic *charTable[] = { &_alert_level_char };
-    GattService         linkLossService(GattService::UUID_LINK_LOSS_SERVICE, charTable, 1);
-
-    _alert_level_char.setWriteAuthorizationCallback(this, &LinkLossService::onDataWritten);
-
-    ble_error_t error = _ble.gattServer().addService(linkLossService);
-
-    if (error == BLE_ERROR_NONE) {
-        _chainable_gap_event_handler.addEventHandler(this);
-    }
-
-    return error;
 }
 
 void LinkLossService::set_event_handler(EventHandler* handler)
@@ -53,61 +31,31 @@ void LinkLossService::set_event_handler(EventHandler* handler)
     _alert_handler = handler;
 }
 
-void LinkLossService::set_alert_level(AlertLevel level)
+void LinkLossService::on_alert_requested(AlertLevel level)
 {
-    _alert_level = level;
-}
-
-void LinkLossService::set_alert_timeout(std::chrono::milliseconds timeout)
-{
-    _alert_timeout = timeout;
-}
-
-LinkLossService::AlertLevel LinkLossService::get_alert_level()
-{
-    return _alert_level;
-}
-
-void LinkLossService::stop_alert()
-{
-    _event_queue.cancel(_event_queue_handle);
-    _event_queue_handle = 0;
-    if (_in_alert) {
-        _in_alert = false;
-        if (_alert_handler) {
-            _alert_handler->on_alert_end();
-        }
+    if (_alert_handler) {
+        _alert_handler->on_alert_requested(level);
     }
 }
 
-void LinkLossService::onConnectionComplete(const ble::ConnectionCompleteEvent &event)
+void LinkLossService::on_alert_end()
 {
-    if (event.getStatus() == BLE_ERROR_NONE) {
-        stop_alert();
+    if (_alert_handler) {
+        _alert_handler->on_alert_end();
     }
 }
 
-void LinkLossService::onDisconnectionComplete(const ble::DisconnectionCompleteEvent &event)
+void LinkLossService::on_pre_alert_requested(AlertLevel level)
 {
-    AlertLevel level  = get_alert_level();
-    if (_alert_handler != nullptr && event.getReason() == ble::disconnection_reason_t::CONNECTION_TIMEOUT &&
-        level != AlertLevel::NO_ALERT && !_in_alert) {
-        _in_alert = true;
-        _alert_handler->on_alert_requested(level);
-        if (_alert_timeout > std::chrono::milliseconds(0)) {
-            _event_queue_handle = _event_queue.call_in(_alert_timeout, [this] { stop_alert(); });
-        }
+    if (_alert_handler) {
+        _alert_handler->on_pre_alert_requested(level);
     }
 }
 
-void LinkLossService::onDataWritten(GattWriteAuthCallbackParams *write_request)
+void LinkLossService::on_pre_alert_end()
 {
-    const uint8_t level = *write_request->data;
-
-    if (level <= (uint8_t)(AlertLevel::HIGH_ALERT)) {
-        set_alert_level((AlertLevel) level);
-    } else {
-        write_request->authorizationReply = GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_OUT_OF_RANGE;
+    if (_alert_handler) {
+        _alert_handler->on_pre_alert_end();
     }
 }
 
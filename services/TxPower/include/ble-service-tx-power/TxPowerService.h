@@ -0,0 +1,105 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TX_POWER_SERVICE_H
+#define TX_POWER_SERVICE_H
+
+#include "ble/BLE.h"
+
+#if BLE_FEATURE_GATT_SERVER
+
+/**
+ * Tx Power Service
+ *
+ * @par purpose
+ * The Tx Power service exposes the transmit power level of the device, in dBm, with the Tx Power Level
+ * characteristic. A client compares it with the RSSI it measures to estimate the path loss, and so the
+ * distance, in the Proximity profile.
+ *
+ * @par usage
+ * Read the transmit power from the controller once, for instance from the vendor API of your radio or the
+ * power you configured for advertising, and pass it to init(). The level is stored in the value of the
+ * characteristic and the stack serves the reads from there: reading the characteristic costs the application
+ * nothing. Call set_tx_power_level() only if the transmit power is changed.
+ *
+ * @note The specification for the Tx Power service can be found here:
+ * https://www.bluetooth.com/specifications/gatt
+ *
+ * @attention The user should not instantiate more than a single Tx Power service
+ */
+class TxPowerService {
+public:
+    /** Lowest and highest transmit power levels the characteristic can expose, in dBm */
+    static const int8_t MIN_TX_POWER_LEVEL = -100;
+    static const int8_t MAX_TX_POWER_LEVEL = 20;
+
+    /**
+     * Constructor
+     *
+     * @param ble BLE object to host the Tx Power service
+     *
+     * @attention The Initializer must be called after instantiating a Tx Power service.
+     */
+    TxPowerService(BLE &ble);
+
+    TxPowerService(const TxPowerService&) = delete;
+    TxPowerService &operator=(const TxPowerService&) = delete;
+
+    /**
+     * Initializer
+     *
+     * @param tx_power_level Transmit power level of the controller in dBm, from MIN_TX_POWER_LEVEL to
+     * MAX_TX_POWER_LEVEL
+     *
+     * @return BLE_ERROR_NONE if the initialisation process completed successfully, BLE_ERROR_INVALID_PARAM if
+     * @p tx_power_level is out of range.
+     */
+    ble_error_t init(int8_t tx_power_level);
+
+    /**
+     * Set the transmit power level, after the transmit power of the controller was changed
+     *
+     * @param tx_power_level Transmit power level in dBm, from MIN_TX_POWER_LEVEL to MAX_TX_POWER_LEVEL
+     *
+     * @return BLE_ERROR_NONE if the level was set, BLE_ERROR_INVALID_PARAM if @p tx_power_level is out of range
+     * or the error of the GattServer.
+     */
+    ble_error_t set_tx_power_level(int8_t tx_power_level);
+
+    /**
+     * @return Transmit power level exposed to the clients, in dBm
+     */
+    int8_t get_tx_power_level() const
+    {
+        return _tx_power_level;
+    }
+
+private:
+    static bool valid(int8_t tx_power_level)
+    {
+        return tx_power_level >= MIN_TX_POWER_LEVEL && tx_power_level <= MAX_TX_POWER_LEVEL;
+    }
+
+    BLE &_ble;
+
+    int8_t _tx_power_level = 0;
+    ReadOnlyGattCharacteristic<int8_t> _tx_power_level_char;
+};
+
+#endif // BLE_FEATURE_GATT_SERVER
+
+#endif // TX_POWER_SERVICE_H
@@ -0,0 +1,71 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2021 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble-service-tx-power/TxPowerService.h"
+
+#if BLE_FEATURE_GATT_SERVER
+
+const int8_t TxPowerService::MIN_TX_POWER_LEVEL;
+const int8_t TxPowerService::MAX_TX_POWER_LEVEL;
+
+TxPowerService::TxPowerService(BLE &ble) :
+    _ble(ble),
+    _tx_power_level_char(GattCharacteristic::UUID_TX_POWER_LEVEL_CHAR, &_tx_power_level)
+{
+}
+
+ble_error_t TxPowerService::init(int8_t tx_power_level)
+{
+    if (!valid(tx_power_level)) {
+        return BLE_ERROR_INVALID_PARAM;
+    }
+
+    /* the value is copied into the attribute as the service is added, no read authorization is needed */
+    _tx_power_level = tx_power_level;
+
+    GattCharacteristic *charTable[] = { &_tx_power_level_char };
+    GattService         txPowerService(GattService::UUID_TX_POWER_SERVICE, charTable, 1);
+
+    return _ble.gattServer().addService(txPowerService);
+}
+
+ble_error_t TxPowerService::set_tx_power_level(int8_t tx_power_level)
+{
+    if (!valid(tx_power_level)) {
+        return BLE_ERROR_INVALID_PARAM;
+    }
+
+    if (tx_power_level == _tx_power_level) {
+        return BLE_ERROR_NONE;
+    }
+
+    ble_error_t error = _ble.gattServer().write(
+        _tx_power_level_char.getValueHandle(),
+        reinterpret_cast<const uint8_t *>(&tx_power_level),
+        sizeof(tx_power_level),
+        /* local only: the characteristic is not notified */
+        true
+    );
+
+    if (error == BLE_ERROR_NONE) {
+        _tx_power_level = tx_power_level;
+    }
+
+    return error;
+}
+
+#endif // BLE_FEATURE_GATT_SERVER
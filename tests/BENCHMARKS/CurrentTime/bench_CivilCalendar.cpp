@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "ble-service-current-time/CivilCalendar.h"
+
+#include <ctime>
+
+/* Wednesday 2021-07-14 12:00:00 */
+static const time_t START_TIME = 1626264000;
+
+/* Baseline: the libc conversion previously used by the current time service */
+static void BM_libc_localtime(benchmark::State &state)
+{
+    time_t time = START_TIME;
+    for (auto _ : state) {
+        struct tm *tm = localtime(&time);
+        benchmark::DoNotOptimize(tm);
+        time += 60;
+    }
+}
+BENCHMARK(BM_libc_localtime);
+
+static void BM_civil_date_time_from_seconds(benchmark::State &state)
+{
+    int64_t time = START_TIME;
+    for (auto _ : state) {
+        CivilCalendar::DateTime date_time = CivilCalendar::date_time_from_seconds(time);
+        benchmark::DoNotOptimize(date_time);
+        time += 60;
+    }
+}
+BENCHMARK(BM_civil_date_time_from_seconds);
+
+/* The periodic update advances the cached value by one minute */
+static void BM_civil_advance(benchmark::State &state)
+{
+    CivilCalendar::DateTime date_time = CivilCalendar::date_time_from_seconds(START_TIME);
+    for (auto _ : state) {
+        date_time = CivilCalendar::advance(date_time, 60);
+        benchmark::DoNotOptimize(date_time);
+    }
+}
+BENCHMARK(BM_civil_advance);
+
+/* Baseline: the libc conversion previously used when the characteristic is written */
+static void BM_libc_mktime(benchmark::State &state)
+{
+    time_t time = START_TIME;
+    struct tm reference = *localtime(&time);
+    for (auto _ : state) {
+        struct tm tm = reference;
+        time_t result = mktime(&tm);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_libc_mktime);
+
+static void BM_civil_seconds_from_date_time(benchmark::State &state)
+{
+    CivilCalendar::DateTime date_time = CivilCalendar::date_time_from_seconds(START_TIME);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(date_time);
+        int64_t result = CivilCalendar::seconds_from_date_time(date_time);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_civil_seconds_from_date_time);
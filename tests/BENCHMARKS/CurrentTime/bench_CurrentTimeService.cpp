@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+#include "ble-service-current-time/CurrentTimeService.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <memory>
+
+using namespace ble;
+
+namespace {
+
+/* Wednesday 2021-07-14 12:00:00, no adjust reason */
+const uint8_t CURRENT_TIME[] = {0xe5, 0x07, 7, 14, 12, 0, 0, 3, 0, 0};
+
+/* every field is checked before the invalid weekday is found */
+const uint8_t INVALID_CURRENT_TIME[] = {0xe5, 0x07, 7, 14, 12, 0, 0, 0, 0, 0};
+
+struct TimeHandler : CurrentTimeService::EventHandler {
+    void on_current_time_changed(time_t, uint8_t) override { }
+};
+
+/* the same empty handler, called at compile time */
+class StaticCurrentTimeService : public BasicCurrentTimeService<StaticCurrentTimeService> {
+public:
+    using BasicCurrentTimeService::BasicCurrentTimeService;
+};
+
+template<typename Service>
+struct CurrentTimeServiceContext {
+    CurrentTimeServiceContext() :
+        current_time_service(
+            BLE::Instance(), event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        )
+    {
+    }
+
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+    Service current_time_service;
+    TimeHandler time_handler;
+};
+
+/*
+ * Current time service registered with the GATT server double, its callbacks are called the way the stack
+ * calls them. The fixture object is shared by the runs of a benchmark, each run gets its own service and
+ * chains of event handlers.
+ */
+template<typename Service>
+class BasicCurrentTimeServiceFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &) override
+    {
+        context = std::make_unique<CurrentTimeServiceContext<Service>>();
+        context->current_time_service.init();
+    }
+
+    void TearDown(const benchmark::State &) override
+    {
+        context.reset();
+        delete_mocks();
+    }
+
+    GattServerMock::characteristic_t &current_time_char()
+    {
+        return gatt_server_mock().services[0].characteristics[0];
+    }
+
+    GattAuthCallbackReply_t write(const uint8_t *data, uint16_t len)
+    {
+        GattWriteAuthCallbackParams write_request {
+            0,
+            current_time_char().value_handle,
+            0,
+            len,
+            data,
+            AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        current_time_char().write_cb(&write_request);
+
+        return write_request.authorizationReply;
+    }
+
+    std::unique_ptr<CurrentTimeServiceContext<Service>> context;
+};
+
+using CurrentTimeServiceFixture = BasicCurrentTimeServiceFixture<CurrentTimeService>;
+using StaticCurrentTimeServiceFixture = BasicCurrentTimeServiceFixture<StaticCurrentTimeService>;
+
+} // namespace
+
+/* onCurrentTimeRead: convert the current time, advancing the cached calendar value, and expose it */
+BENCHMARK_F(CurrentTimeServiceFixture, BM_current_time_read)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        GattReadAuthCallbackParams read_request {
+            0,
+            current_time_char().value_handle,
+            0,
+            0,
+            nullptr,
+            AUTH_CALLBACK_REPLY_SUCCESS
+        };
+        current_time_char().read_cb(&read_request);
+        benchmark::DoNotOptimize(read_request);
+    }
+}
+
+/* onCurrentTimeWritten: decode, check, convert and apply a new time, including the value update */
+BENCHMARK_F(CurrentTimeServiceFixture, BM_current_time_written)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(write(CURRENT_TIME, sizeof(CURRENT_TIME)));
+    }
+}
+
+/* onCurrentTimeWritten with an event handler set, called through its vtable */
+BENCHMARK_F(CurrentTimeServiceFixture, BM_current_time_written_handler)(benchmark::State &state)
+{
+    context->current_time_service.set_event_handler(&context->time_handler);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(write(CURRENT_TIME, sizeof(CURRENT_TIME)));
+    }
+
+    state.counters["service_size"] = sizeof(CurrentTimeService);
+}
+
+/* onCurrentTimeWritten with the event handler dispatched at compile time */
+BENCHMARK_F(StaticCurrentTimeServiceFixture, BM_current_time_written_handler)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(write(CURRENT_TIME, sizeof(CURRENT_TIME)));
+    }
+
+    state.counters["service_size"] = sizeof(StaticCurrentTimeService);
+}
+
+/* CurrentTime::valid(): a rejected write is the decode followed by the full range check */
+BENCHMARK_F(CurrentTimeServiceFixture, BM_current_time_valid)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(write(INVALID_CURRENT_TIME, sizeof(INVALID_CURRENT_TIME)));
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "ble-service-current-time/WallClock.h"
+
+#include <ctime>
+#include <vector>
+
+/* Wednesday 2021-07-14 12:00:00 */
+static const int64_t START_TIME_MS = 1626264000000;
+
+/* a drifting clock so that the correction is part of the cost */
+static void publish(WallClock &wall_clock)
+{
+    wall_clock.publish(0, START_TIME_MS, 35000);
+}
+
+/* Baseline: the second resolution time previously used by the current time service */
+static void BM_libc_time(benchmark::State &state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(time(nullptr));
+    }
+}
+BENCHMARK(BM_libc_time);
+
+/* one sample stamped at a time, each reading the published conversion */
+static void BM_wall_clock_stamp(benchmark::State &state)
+{
+    WallClock wall_clock;
+    publish(wall_clock);
+
+    WallClock::time_point tick(std::chrono::milliseconds(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(wall_clock.stamp(tick));
+        tick += std::chrono::milliseconds(1);
+    }
+
+    state.counters["seconds_per_stamp"] = benchmark::Counter(
+        1, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+    );
+}
+BENCHMARK(BM_wall_clock_stamp);
+
+/* a batch of samples stamped with a single read of the conversion */
+static void BM_wall_clock_stamp_batch(benchmark::State &state)
+{
+    WallClock wall_clock;
+    publish(wall_clock);
+
+    std::vector<WallClock::time_point> ticks;
+    for (int64_t ms = 0; ms < state.range(0); ms++) {
+        ticks.push_back(WallClock::time_point(std::chrono::milliseconds(ms)));
+    }
+    std::vector<WallClock::Timestamp> timestamps(ticks.size());
+
+    for (auto _ : state) {
+        wall_clock.stamp(ticks.data(), timestamps.data(), ticks.size());
+        benchmark::DoNotOptimize(timestamps.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["seconds_per_stamp"] = benchmark::Counter(
+        state.range(0), benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+    );
+}
+BENCHMARK(BM_wall_clock_stamp_batch)->Arg(16)->Arg(256);
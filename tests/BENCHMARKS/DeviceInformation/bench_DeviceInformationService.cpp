@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "ble/BLE.h"
+#include "ble-service-device-information/DeviceInformationService.h"
+
+#include "ble_mocks.h"
+
+using namespace ble;
+
+namespace {
+
+using DIS = DeviceInformationService;
+
+const DIS::system_id_t system_id{0x01020304, 0x050607};
+const uint8_t cert_data[] = {0x03, 0x01, 0x02, 0x03};
+const DIS::regulatory_cert_data_list_t cert_data_list{cert_data};
+const DIS::pnp_id_t pnp_id{0x01, 0x0822, 0x0001, 0x0100};
+
+/* the GATT server double keeps every service added, forget them from time to time */
+void reset_services(benchmark::State &state)
+{
+    if (gatt_server_mock().services.size() >= 1000) {
+        state.PauseTiming();
+        gatt_server_mock().services.clear();
+        state.ResumeTiming();
+    }
+}
+
+} // namespace
+
+/* Every characteristic, passed as pointers and built on the stack */
+static void BM_dis_add_service_runtime(benchmark::State &state)
+{
+    BLE &ble = BLE::Instance();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DIS::add_service(
+            ble, "manufacturer", "model", "serial", "hardware", "firmware", "software",
+            &system_id, &cert_data_list, &pnp_id
+        ));
+        reset_services(state);
+    }
+
+    delete_mocks();
+}
+BENCHMARK(BM_dis_add_service_runtime);
+
+/* Every characteristic, selected at compile time and kept in static storage */
+static void BM_dis_add_service_static(benchmark::State &state)
+{
+    BLE &ble = BLE::Instance();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DIS::add_service(
+            ble,
+            DIS::manufacturers_name_t{"manufacturer"},
+            DIS::model_number_t{"model"},
+            DIS::serial_number_t{"serial"},
+            DIS::hardware_revision_t{"hardware"},
+            DIS::firmware_revision_t{"firmware"},
+            DIS::software_revision_t{"software"},
+            system_id,
+            cert_data_list,
+            pnp_id
+        ));
+        reset_services(state);
+    }
+
+    delete_mocks();
+}
+BENCHMARK(BM_dis_add_service_static);
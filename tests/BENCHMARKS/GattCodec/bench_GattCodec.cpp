@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "ble/gatt/GattCodec.h"
+
+using namespace ble;
+
+/* Each codec benchmark has a baseline reproducing the hand-written code it replaced in the services */
+
+struct pnp_id_t {
+    uint8_t vendor_id_source;
+    uint16_t vendor_id;
+    uint16_t product_id;
+    uint16_t product_version;
+};
+
+static void BM_hand_written_pack_pnp_id(benchmark::State &state)
+{
+    pnp_id_t pnp_id = { 0x01, 0x0822, 0x1234, 0x0100 };
+    uint8_t pnp_value[7];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pnp_id);
+        pnp_value[0] = pnp_id.vendor_id_source;
+        pnp_value[1] = pnp_id.vendor_id;
+        pnp_value[2] = pnp_id.vendor_id >> 8;
+        pnp_value[3] = pnp_id.product_id;
+        pnp_value[4] = pnp_id.product_id >> 8;
+        pnp_value[5] = pnp_id.product_version;
+        pnp_value[6] = pnp_id.product_version >> 8;
+        benchmark::DoNotOptimize(pnp_value);
+        pnp_id.product_version++;
+    }
+}
+BENCHMARK(BM_hand_written_pack_pnp_id);
+
+static void BM_codec_pack_pnp_id(benchmark::State &state)
+{
+    pnp_id_t pnp_id = { 0x01, 0x0822, 0x1234, 0x0100 };
+    uint8_t pnp_value[7];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pnp_id);
+        codec::encode<codec::uint8>(pnp_value, pnp_id.vendor_id_source);
+        codec::encode<codec::uint16_le, 1>(pnp_value, pnp_id.vendor_id);
+        codec::encode<codec::uint16_le, 3>(pnp_value, pnp_id.product_id);
+        codec::encode<codec::uint16_le, 5>(pnp_value, pnp_id.product_version);
+        benchmark::DoNotOptimize(pnp_value);
+        pnp_id.product_version++;
+    }
+}
+BENCHMARK(BM_codec_pack_pnp_id);
+
+static void BM_hand_written_pack_system_id(benchmark::State &state)
+{
+    uint64_t manufacturer_defined_identifier = 0x0102030405;
+    uint32_t organizationally_unique_identifier = 0xABCDEF;
+    uint8_t system_id_value[8];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manufacturer_defined_identifier);
+        for (int i = 0; i < 5; i++) {
+            system_id_value[i] = manufacturer_defined_identifier >> (i * 8);
+        }
+        for (int i = 0; i < 3; i++) {
+            system_id_value[5 + i] = organizationally_unique_identifier >> (i * 8);
+        }
+        benchmark::DoNotOptimize(system_id_value);
+        manufacturer_defined_identifier++;
+    }
+}
+BENCHMARK(BM_hand_written_pack_system_id);
+
+static void BM_codec_pack_system_id(benchmark::State &state)
+{
+    uint64_t manufacturer_defined_identifier = 0x0102030405;
+    uint32_t organizationally_unique_identifier = 0xABCDEF;
+    uint8_t system_id_value[8];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manufacturer_defined_identifier);
+        codec::encode<codec::uint40_le>(system_id_value, manufacturer_defined_identifier);
+        codec::encode<codec::uint24_le, codec::uint40_le::size>(system_id_value, organizationally_unique_identifier);
+        benchmark::DoNotOptimize(system_id_value);
+        manufacturer_defined_identifier++;
+    }
+}
+BENCHMARK(BM_codec_pack_system_id);
+
+/* Current Time characteristic value as written by a client */
+static uint8_t current_time_value[10] = { 0xE5, 0x07, 7, 14, 12, 30, 59, 3, 0, 1 };
+
+struct current_time_t {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+    uint8_t weekday;
+    uint8_t fractions256;
+    uint8_t adjust_reason;
+};
+
+static void BM_hand_written_decode_current_time(benchmark::State &state)
+{
+    current_time_t current_time;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(current_time_value);
+        const uint8_t *data = current_time_value;
+        current_time.year          = *data | (*(data + 1) << 8);
+        data += 2;
+        current_time.month         = *data++;
+        current_time.day           = *data++;
+        current_time.hours         = *data++;
+        current_time.minutes       = *data++;
+        current_time.seconds       = *data++;
+        current_time.weekday       = *data++;
+        current_time.fractions256  = *data++;
+        current_time.adjust_reason = *data;
+        benchmark::DoNotOptimize(current_time);
+    }
+}
+BENCHMARK(BM_hand_written_decode_current_time);
+
+static void BM_codec_decode_current_time(benchmark::State &state)
+{
+    current_time_t current_time;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(current_time_value);
+        const codec::date_time::value_type date_time = codec::decode<codec::date_time>(current_time_value);
+        current_time.year          = date_time.year;
+        current_time.month         = date_time.month;
+        current_time.day           = date_time.day;
+        current_time.hours         = date_time.hours;
+        current_time.minutes       = date_time.minutes;
+        current_time.seconds       = date_time.seconds;
+        current_time.weekday       = codec::decode<codec::uint8, 7>(current_time_value);
+        current_time.fractions256  = codec::decode<codec::uint8, 8>(current_time_value);
+        current_time.adjust_reason = codec::decode<codec::uint8, 9>(current_time_value);
+        benchmark::DoNotOptimize(current_time);
+    }
+}
+BENCHMARK(BM_codec_decode_current_time);
+
+static void BM_hand_written_decode_uint48(benchmark::State &state)
+{
+    uint8_t data[6] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(data);
+        uint64_t value = (uint64_t)data[0] | ((uint64_t)data[1] << 8) | ((uint64_t)data[2] << 16) |
+                         ((uint64_t)data[3] << 24) | ((uint64_t)data[4] << 32) | ((uint64_t)data[5] << 40);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_hand_written_decode_uint48);
+
+static void BM_codec_decode_uint48(benchmark::State &state)
+{
+    uint8_t data[6] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(data);
+        uint64_t value = codec::decode<codec::uint48_le>(data);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_codec_decode_uint48);
+
+static void BM_hand_written_decode_sfloat(benchmark::State &state)
+{
+    uint8_t data[2] = { 0x6C, 0xF1 };
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(data);
+        uint16_t raw = data[0] | (data[1] << 8);
+        int16_t mantissa = raw & 0x0FFF;
+        int8_t exponent = raw >> 12;
+        if (mantissa >= 0x0800) {
+            mantissa -= 0x1000;
+        }
+        if (exponent >= 0x08) {
+            exponent -= 0x10;
+        }
+        benchmark::DoNotOptimize(mantissa);
+        benchmark::DoNotOptimize(exponent);
+    }
+}
+BENCHMARK(BM_hand_written_decode_sfloat);
+
+static void BM_codec_decode_sfloat(benchmark::State &state)
+{
+    uint8_t data[2] = { 0x6C, 0xF1 };
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(data);
+        codec::sfloat::value_type value = codec::decode<codec::sfloat>(data);
+        benchmark::DoNotOptimize(value.mantissa);
+        benchmark::DoNotOptimize(value.exponent);
+    }
+}
+BENCHMARK(BM_codec_decode_sfloat);
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gap/Events.h"
+#include "ble-service-link-loss/LinkLossService.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <chrono>
+#include <memory>
+
+using namespace ble;
+using namespace std::literals::chrono_literals;
+
+namespace {
+
+struct AlertHandler : LinkLossService::EventHandler {
+    void on_alert_requested(LinkLossService::AlertLevel) override { }
+    void on_alert_end() override { }
+};
+
+/* the same empty handlers, called at compile time */
+class StaticLinkLossService : public BasicLinkLossService<StaticLinkLossService> {
+public:
+    using BasicLinkLossService::BasicLinkLossService;
+};
+
+void set_event_handler(LinkLossService &link_loss_service, AlertHandler &alert_handler)
+{
+    link_loss_service.set_event_handler(&alert_handler);
+}
+
+void set_event_handler(StaticLinkLossService &, AlertHandler &)
+{
+}
+
+template<typename Service>
+struct LinkLossServiceContext {
+    LinkLossServiceContext() :
+        link_loss_service(BLE::Instance(), event_queue, chainable_gap_event_handler)
+    {
+    }
+
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    Service link_loss_service;
+    AlertHandler alert_handler;
+};
+
+/*
+ * Link loss service registered with the GATT server double, with one connected peer. The fixture object
+ * is shared by the runs of a benchmark, each run gets its own service and chain of event handlers.
+ */
+template<typename Service>
+class BasicLinkLossServiceFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &) override
+    {
+        context = std::make_unique<LinkLossServiceContext<Service>>();
+
+        Service &link_loss_service = context->link_loss_service;
+        link_loss_service.init();
+        set_event_handler(link_loss_service, context->alert_handler);
+        link_loss_service.set_alert_level(Service::AlertLevel::HIGH_ALERT);
+        link_loss_service.set_alert_timeout(60s);
+
+        connect();
+    }
+
+    void TearDown(const benchmark::State &) override
+    {
+        context.reset();
+        delete_mocks();
+    }
+
+    void connect()
+    {
+        const uint8_t peer_address[] = {0xfb, 0xdd, 0x62, 0x03, 0x04, 0xd8};
+        const uint8_t local_address[] = {0x4d, 0xc7, 0x92, 0x0e, 0x51, 0xba};
+
+        ConnectionCompleteEvent event(
+            BLE_ERROR_NONE,
+            0,
+            connection_role_t::PERIPHERAL,
+            peer_address_type_t::PUBLIC,
+            address_t(peer_address),
+            address_t(local_address),
+            address_t(peer_address),
+            conn_interval_t(50),
+            slave_latency_t::min(),
+            supervision_timeout_t(100),
+            100
+        );
+
+        context->chainable_gap_event_handler.onConnectionComplete(event);
+    }
+
+    void disconnect(disconnection_reason_t reason)
+    {
+        DisconnectionCompleteEvent event(0, reason);
+
+        context->chainable_gap_event_handler.onDisconnectionComplete(event);
+    }
+
+    GattAuthCallbackReply_t write(const uint8_t *data, uint16_t len)
+    {
+        GattServerMock::characteristic_t &alert_level_char = gatt_server_mock().services[0].characteristics[0];
+
+        GattWriteAuthCallbackParams write_request {
+            0,
+            alert_level_char.value_handle,
+            0,
+            len,
+            data,
+            AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        alert_level_char.write_cb(&write_request);
+
+        return write_request.authorizationReply;
+    }
+
+    std::unique_ptr<LinkLossServiceContext<Service>> context;
+};
+
+using LinkLossServiceFixture = BasicLinkLossServiceFixture<LinkLossService>;
+using StaticLinkLossServiceFixture = BasicLinkLossServiceFixture<StaticLinkLossService>;
+
+} // namespace
+
+/* onDataWritten: a valid alert level stored in the state of the connection */
+BENCHMARK_F(LinkLossServiceFixture, BM_link_loss_data_written)(benchmark::State &state)
+{
+    uint8_t level = 0;
+    for (auto _ : state) {
+        level = (level + 1) % 3;
+        benchmark::DoNotOptimize(write(&level, sizeof(level)));
+    }
+}
+
+/* onDataWritten: an out of range alert level rejected */
+BENCHMARK_F(LinkLossServiceFixture, BM_link_loss_data_written_rejected)(benchmark::State &state)
+{
+    const uint8_t level = 0x10;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(write(&level, sizeof(level)));
+    }
+}
+
+/*
+ * Closing and reopening a connection without losing it; the baseline to subtract from the link loss below,
+ * which needs a connection to lose every iteration.
+ */
+BENCHMARK_F(LinkLossServiceFixture, BM_link_loss_reconnection)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        disconnect(disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION);
+        connect();
+    }
+}
+
+/*
+ * onDisconnectionComplete of a lost link, which requests an alert and arms its timeout, then the reconnection
+ * of the peer, which ends the alert
+ */
+BENCHMARK_F(LinkLossServiceFixture, BM_link_loss_disconnection_complete)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        disconnect(disconnection_reason_t::CONNECTION_TIMEOUT);
+        connect();
+    }
+
+    state.counters["service_size"] = sizeof(LinkLossService);
+}
+
+/*
+ * The same link loss and reconnection with the alert handlers dispatched at compile time, compare with
+ * BM_link_loss_disconnection_complete for the cost of the virtual handlers
+ */
+BENCHMARK_F(StaticLinkLossServiceFixture, BM_link_loss_disconnection_complete)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        disconnect(disconnection_reason_t::CONNECTION_TIMEOUT);
+        connect();
+    }
+
+    state.counters["service_size"] = sizeof(StaticLinkLossService);
+}
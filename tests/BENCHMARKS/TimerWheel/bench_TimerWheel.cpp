@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "ble/common/TimerWheel.h"
+
+#include <vector>
+
+using namespace ble;
+using namespace std::chrono;
+
+static void on_timeout()
+{
+}
+
+/* Timeouts spread over every level of the wheel, as alert timeouts of many links would be */
+static milliseconds timeout_of(size_t index)
+{
+    return milliseconds(100) * ((index * 7919) % (TimerWheel::MAX_TICKS / 4) + 1);
+}
+
+/* Arm then cancel every timer; the cost per operation does not depend on the number of timers */
+static void BM_arm_cancel(benchmark::State &state)
+{
+    events::EventQueue event_queue;
+    TimerWheel wheel(event_queue, milliseconds(100));
+    std::vector<TimerWheel::Timer> timers(state.range(0));
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < timers.size(); i++) {
+            wheel.arm(timers[i], timeout_of(i), on_timeout);
+        }
+        for (TimerWheel::Timer &timer : timers) {
+            wheel.cancel(timer);
+        }
+    }
+
+    /* seconds per arm or cancel */
+    state.counters["per_op"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * timers.size() * 2),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert
+    );
+}
+BENCHMARK(BM_arm_cancel)->Arg(100)->Arg(1000)->Arg(10000);
+
+/* Timer re-arming itself when it expires to keep the number of armed timers constant */
+struct PeriodicTimer {
+    void arm()
+    {
+        wheel->arm(timer, timeout, mbed::callback(this, &PeriodicTimer::arm));
+    }
+
+    TimerWheel *wheel;
+    milliseconds timeout;
+    TimerWheel::Timer timer;
+};
+
+/* Advance the wheel with timers armed; a tick only touches the slots due */
+static void BM_tick(benchmark::State &state)
+{
+    events::EventQueue event_queue;
+    TimerWheel wheel(event_queue, milliseconds(100));
+    std::vector<PeriodicTimer> timers(state.range(0));
+
+    for (size_t i = 0; i < timers.size(); i++) {
+        timers[i].wheel = &wheel;
+        timers[i].timeout = timeout_of(i);
+        timers[i].arm();
+    }
+
+    for (auto _ : state) {
+        event_queue.dispatch(100);
+    }
+
+    for (PeriodicTimer &timer : timers) {
+        wheel.cancel(timer.timer);
+    }
+}
+BENCHMARK(BM_tick)->Arg(100)->Arg(10000);
@@ -0,0 +1,28 @@
+#!/bin/bash
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+set -e
+
+# Set wd to script location
+cd "$( cd "$( dirname "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )"
+
+# Directory of the JSON results, one file per benchmark executable
+results=${1:-cmake_build/results}
+mkdir -p "$results"
+
+# Run every benchmark executable
+for benchmark in $(find cmake_build -type f -name "*-benchmark" -perm -u+x | sort); do
+    "$benchmark" --benchmark_out="$results/$(basename "$benchmark").json" --benchmark_out_format=json
+done
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Simulation.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+#include "ble/gatt/GattCodec.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+using namespace simulation;
+using namespace std::literals::chrono_literals;
+using ::testing::_;
+using ::testing::Return;
+using ::testing::InvokeWithoutArgs;
+
+namespace {
+
+const size_t PEERS = 4;
+static_assert(PEERS <= MBED_CONF_BLE_SERVICE_CURRENT_TIME_MAX_SUBSCRIBERS, "Every peer may subscribe");
+
+const size_t CURRENT_TIME_SIZE = 10;
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        if (failures++ < 10) {
+            fprintf(stderr, "FAILED: %s\n", what);
+        }
+    }
+}
+
+void encode_current_time(time_t time, uint8_t adjust_reason, uint8_t (&value)[CURRENT_TIME_SIZE])
+{
+    struct tm tm{};
+    gmtime_r(&time, &tm);
+
+    ble::codec::encode<ble::codec::date_time>(value, {
+        static_cast<uint16_t>(tm.tm_year + 1900),
+        static_cast<uint8_t>(tm.tm_mon + 1),
+        static_cast<uint8_t>(tm.tm_mday),
+        static_cast<uint8_t>(tm.tm_hour),
+        static_cast<uint8_t>(tm.tm_min),
+        static_cast<uint8_t>(tm.tm_sec)
+    });
+    value[7] = (tm.tm_wday == 0) ? 7 : tm.tm_wday;
+    value[8] = 0;
+    value[9] = adjust_reason;
+}
+
+time_t decode_current_time(const uint8_t (&value)[CURRENT_TIME_SIZE])
+{
+    const auto date_time = ble::codec::decode<ble::codec::date_time>(value);
+
+    struct tm tm{};
+    tm.tm_year = date_time.year - 1900;
+    tm.tm_mon  = date_time.month - 1;
+    tm.tm_mday = date_time.day;
+    tm.tm_hour = date_time.hours;
+    tm.tm_min  = date_time.minutes;
+    tm.tm_sec  = date_time.seconds;
+    return timegm(&tm);
+}
+
+} // namespace
+
+/*
+ * Connect peers, have them subscribe, read, write and unsubscribe the current time and disconnect,
+ * over and over, while the application sets the time and virtual time runs.
+ *
+ * Usage: sim_CurrentTimeService [sequences]
+ */
+int main(int argc, char *argv[])
+{
+    const unsigned long sequences = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 2000;
+
+    Simulation simulation;
+    const UUID current_time_uuid(GattCharacteristic::UUID_CURRENT_TIME_CHAR);
+
+    CurrentTimeService current_time_service(
+        simulation.ble(), simulation.event_queue(),
+        simulation.gap_event_handler(), simulation.gatt_server_event_handler()
+    );
+    current_time_service.init();
+
+    /* value updates pushed to the GATT server, notified to the subscribers */
+    size_t updates = 0;
+    ON_CALL(ble::gatt_server_mock(), write(_, _, _, _))
+        .WillByDefault(InvokeWithoutArgs([&updates] { updates++; return BLE_ERROR_NONE; }));
+
+    SimulatedPeer peers[PEERS] = {
+        {simulation, 0, 0xd0}, {simulation, 1, 0xd1}, {simulation, 2, 0xd2}, {simulation, 3, 0xd3}
+    };
+    bool subscribed[PEERS] = {};
+
+    /* deterministic pseudo random sequence of operations */
+    uint32_t state = 54321;
+    unsigned long completed = 0;
+
+    while (completed < sequences) {
+        state = state * 1103515245 + 12345;
+        const size_t index = (state >> 16) % PEERS;
+        SimulatedPeer &peer = peers[index];
+
+        if (!peer.connected()) {
+            peer.connect();
+        } else {
+            switch ((state >> 8) % 6) {
+                case 0:
+                    peer.subscribe(current_time_uuid, !subscribed[index]);
+                    subscribed[index] = !subscribed[index];
+                    break;
+                case 1: {
+                    uint8_t value[CURRENT_TIME_SIZE];
+                    uint16_t len = sizeof(value);
+                    check(peer.read(current_time_uuid, value, len) == AUTH_CALLBACK_REPLY_SUCCESS,
+                          "current time read");
+                    check(len == CURRENT_TIME_SIZE, "current time length");
+
+                    const time_t read_time = decode_current_time(value);
+                    check(std::abs(read_time - current_time_service.get_time()) <= 1, "current time read matches");
+                    break;
+                }
+                case 2: {
+                    /* any time between 2000 and 2100 */
+                    const time_t time = 946684800 + static_cast<time_t>(state % 3155760000UL);
+                    uint8_t value[CURRENT_TIME_SIZE];
+                    encode_current_time(time, CurrentTimeService::MANUAL_TIME_UPDATE, value);
+                    check(peer.write(current_time_uuid, value, sizeof(value)) == AUTH_CALLBACK_REPLY_SUCCESS,
+                          "valid current time accepted");
+                    check(std::abs(current_time_service.get_time() - time) <= 1, "current time written");
+                    break;
+                }
+                case 3: {
+                    uint8_t value[CURRENT_TIME_SIZE] = {};
+                    check(peer.write(current_time_uuid, value, sizeof(value)) != AUTH_CALLBACK_REPLY_SUCCESS,
+                          "invalid current time rejected");
+                    check(peer.write(current_time_uuid, value, 9) ==
+                          AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH,
+                          "short current time rejected");
+                    break;
+                }
+                case 4:
+                    simulation.measure("set_time", [&] {
+                        current_time_service.set_time(current_time_service.get_time() + 1,
+                                                      CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+                    });
+                    break;
+                case 5:
+                    peer.disconnect();
+                    subscribed[index] = false;
+                    completed++;
+                    break;
+            }
+        }
+
+        bool any_subscribed = false;
+        for (bool s : subscribed) {
+            any_subscribed |= s;
+        }
+
+        /* the periodic update only runs while a client is subscribed */
+        const size_t updates_before = updates;
+        simulation.advance(std::chrono::milliseconds((state >> 4) % 30000));
+        check(any_subscribed || updates == updates_before, "no periodic update without subscribers");
+    }
+
+    simulation.report(std::cout, "Current Time Service");
+    std::cout << "value updates: " << updates << "\n";
+    std::cout << "unchanged value updates suppressed: " << current_time_service.get_suppressed_update_count() << "\n";
+
+    check(updates == current_time_service.get_update_count(), "update count matches the GATT server writes");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
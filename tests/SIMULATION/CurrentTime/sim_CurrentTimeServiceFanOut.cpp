@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Simulation.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+
+using namespace simulation;
+using namespace std::literals::chrono_literals;
+using ::testing::_;
+using ::testing::Invoke;
+
+namespace {
+
+const size_t PEERS = 16;
+static_assert(PEERS <= MBED_CONF_BLE_SERVICE_CURRENT_TIME_MAX_SUBSCRIBERS, "Every peer may subscribe");
+
+const std::chrono::milliseconds FAN_OUT_WINDOW(MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_WINDOW);
+const size_t FAN_OUT_CREDITS = MBED_CONF_BLE_SERVICE_CURRENT_TIME_FAN_OUT_CREDITS;
+
+/* buffers of the controller shared by all the connections, a write beyond them is refused */
+const size_t CONTROLLER_BUFFERS = 8;
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        if (failures++ < 10) {
+            fprintf(stderr, "FAILED: %s\n", what);
+        }
+    }
+}
+
+/*
+ * Controller transmitting the updates at the next connection event of each connection, then raising onDataSent
+ */
+class Controller {
+public:
+    explicit Controller(Simulation &simulation) : _simulation(simulation)
+    {
+    }
+
+    ble_error_t write(ble::connection_handle_t connection_handle, GattAttribute::Handle_t handle)
+    {
+        if (_queued.size() == CONTROLLER_BUFFERS) {
+            refused++;
+            return BLE_ERROR_NO_MEM;
+        }
+
+        /* connection intervals from 7 ms to 45 ms, the update leaves at the next connection event */
+        const int64_t interval = 15 * (1 + connection_handle % 6) / 2;
+        const int64_t now = _simulation.now().count();
+        const int64_t delay = interval - (now % interval);
+
+        Packet packet{connection_handle, 0};
+        packet.event = _simulation.event_queue().call_in(std::chrono::milliseconds(delay), [this, connection_handle, handle] {
+            sent(connection_handle, handle);
+        });
+        _queued.push_back(packet);
+
+        peak_depth = std::max(peak_depth, _queued.size());
+        writes++;
+
+        return BLE_ERROR_NONE;
+    }
+
+    /**
+     * Drop the packets of a connection that is lost, onDataSent is not raised for them
+     */
+    void disconnect(ble::connection_handle_t connection_handle)
+    {
+        for (auto it = _queued.begin(); it != _queued.end();) {
+            if (it->connection_handle == connection_handle) {
+                _simulation.event_queue().cancel(it->event);
+                it = _queued.erase(it);
+                dropped++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    size_t depth() const
+    {
+        return _queued.size();
+    }
+
+    size_t peak_depth = 0;
+    size_t writes = 0;
+    size_t refused = 0;
+    size_t delivered = 0;
+    size_t dropped = 0;
+
+private:
+    struct Packet {
+        ble::connection_handle_t connection_handle;
+        int event;
+    };
+
+    void sent(ble::connection_handle_t connection_handle, GattAttribute::Handle_t handle)
+    {
+        for (auto it = _queued.begin(); it != _queued.end(); ++it) {
+            if (it->connection_handle == connection_handle) {
+                _queued.erase(it);
+                break;
+            }
+        }
+
+        delivered++;
+        GattDataSentCallbackParams params{connection_handle, handle};
+        _simulation.measure("data sent", [&] { _simulation.gatt_server_event_handler().onDataSent(params); });
+    }
+
+    Simulation &_simulation;
+    std::list<Packet> _queued;
+};
+
+} // namespace
+
+/*
+ * Connect sixteen peers that subscribe and unsubscribe to the current time, disconnect and reconnect, while the
+ * application sets the time. Check that the controller never holds more updates than the fan-out credits and that
+ * each update reaches every subscriber within the fan-out window.
+ *
+ * Usage: sim_CurrentTimeServiceFanOut [sequences]
+ */
+int main(int argc, char *argv[])
+{
+    const unsigned long sequences = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 2000;
+
+    Simulation simulation;
+    Controller controller(simulation);
+    const UUID current_time_uuid(GattCharacteristic::UUID_CURRENT_TIME_CHAR);
+
+    CurrentTimeService current_time_service(
+        simulation.ble(), simulation.event_queue(),
+        simulation.gap_event_handler(), simulation.gatt_server_event_handler()
+    );
+    current_time_service.init();
+
+    /* updates written to one subscriber, by the fan-out */
+    std::chrono::milliseconds last_update[PEERS] = {};
+    ON_CALL(ble::gatt_server_mock(), write(_, _, _, _, _))
+        .WillByDefault(Invoke([&](ble::connection_handle_t connection_handle, GattAttribute::Handle_t handle,
+                                  const uint8_t *, uint16_t, bool) {
+            ble_error_t error = controller.write(connection_handle, handle);
+            if (error == BLE_ERROR_NONE) {
+                last_update[connection_handle] = simulation.now();
+            }
+            return error;
+        }));
+
+    SimulatedPeer peers[PEERS] = {
+        {simulation,  0, 0xd0}, {simulation,  1, 0xd1}, {simulation,  2, 0xd2}, {simulation,  3, 0xd3},
+        {simulation,  4, 0xd4}, {simulation,  5, 0xd5}, {simulation,  6, 0xd6}, {simulation,  7, 0xd7},
+        {simulation,  8, 0xd8}, {simulation,  9, 0xd9}, {simulation, 10, 0xda}, {simulation, 11, 0xdb},
+        {simulation, 12, 0xdc}, {simulation, 13, 0xdd}, {simulation, 14, 0xde}, {simulation, 15, 0xdf}
+    };
+    bool subscribed[PEERS] = {};
+
+    for (size_t i = 0; i < PEERS; i++) {
+        peers[i].connect();
+        peers[i].subscribe(current_time_uuid);
+        subscribed[i] = true;
+    }
+
+    /* deterministic pseudo random sequence of operations */
+    uint32_t state = 24680;
+    unsigned long completed = 0;
+    size_t rounds = 0;
+
+    while (completed < sequences) {
+        state = state * 1103515245 + 12345;
+        const size_t index = (state >> 16) % PEERS;
+        SimulatedPeer &peer = peers[index];
+
+        switch ((state >> 8) % 10) {
+            case 0:
+            case 1:
+                if (!peer.connected()) {
+                    peer.connect();
+                }
+                peer.subscribe(current_time_uuid);
+                subscribed[index] = true;
+                break;
+            case 2:
+                if (peer.connected()) {
+                    peer.subscribe(current_time_uuid, false);
+                    subscribed[index] = false;
+                }
+                break;
+            case 3:
+                if (peer.connected()) {
+                    peer.disconnect();
+                    controller.disconnect(peer.connection_handle());
+                    subscribed[index] = false;
+                }
+                break;
+            default: {
+                /* the time set while the previous updates may still be in flight */
+                simulation.measure("set_time", [&] {
+                    current_time_service.set_time(current_time_service.get_time() + 1,
+                                                  CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+                });
+                const std::chrono::milliseconds set_at = simulation.now();
+                rounds++;
+
+                /* the fan-out runs in steps, dispatch each of them */
+                for (std::chrono::milliseconds elapsed = 0ms; elapsed < FAN_OUT_WINDOW + 500ms; elapsed += 1ms) {
+                    simulation.advance(1ms);
+                    check(controller.depth() <= FAN_OUT_CREDITS, "controller holds no more updates than the credits");
+                }
+
+                for (size_t i = 0; i < PEERS; i++) {
+                    if (subscribed[i]) {
+                        check(last_update[i] >= set_at, "every subscriber is sent the update");
+                    }
+                }
+                break;
+            }
+        }
+
+        simulation.advance(std::chrono::milliseconds((state >> 4) % 5000));
+        completed++;
+    }
+
+    simulation.report(std::cout, "Current Time Service fan-out");
+    std::cout << "subscribers: " << PEERS << ", fan-out window: " << FAN_OUT_WINDOW.count() << " ms, credits: "
+              << FAN_OUT_CREDITS << "\n";
+    std::cout << "time updates: " << rounds << ", updates written: " << controller.writes
+              << ", refused by the controller: " << controller.refused
+              << ", peak controller queue depth: " << controller.peak_depth << "\n";
+
+    /* every update written is sent, dropped with its connection or still queued */
+    const Statistics *data_sent = simulation.statistics("data sent");
+    check(controller.writes == controller.delivered + controller.dropped + controller.depth(),
+          "every update written is accounted for");
+    check(data_sent && data_sent->count() == controller.delivered, "onDataSent raised for every update sent");
+
+    check(controller.peak_depth > 0, "updates written to the controller");
+    check(controller.peak_depth <= FAN_OUT_CREDITS, "peak controller queue depth bounded by the credits");
+    check(controller.refused == 0, "no update refused by the controller");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Simulation.h"
+
+#include "ble-service-device-information/DeviceInformationService.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace simulation;
+
+namespace {
+
+using DIS = DeviceInformationService;
+
+const uint16_t CHARACTERISTICS[] = {
+    GattCharacteristic::UUID_MANUFACTURER_NAME_STRING_CHAR,
+    GattCharacteristic::UUID_MODEL_NUMBER_STRING_CHAR,
+    GattCharacteristic::UUID_SERIAL_NUMBER_STRING_CHAR,
+    GattCharacteristic::UUID_HARDWARE_REVISION_STRING_CHAR,
+    GattCharacteristic::UUID_FIRMWARE_REVISION_STRING_CHAR,
+    GattCharacteristic::UUID_SOFTWARE_REVISION_STRING_CHAR,
+    GattCharacteristic::UUID_SYSTEM_ID_CHAR,
+    GattCharacteristic::UUID_IEEE_REGULATORY_CERTIFICATION_DATA_LIST_CHAR,
+    GattCharacteristic::UUID_PNP_ID_CHAR
+};
+
+const uint8_t cert_data[] = {0x03, 0x01, 0x02, 0x03};
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        if (failures++ < 10) {
+            fprintf(stderr, "FAILED: %s\n", what);
+        }
+    }
+}
+
+} // namespace
+
+/*
+ * Boot the device, registering the service with either form of add_service, then connect a peer that reads
+ * every characteristic and disconnects, over and over.
+ *
+ * Usage: sim_DeviceInformationService [sequences]
+ */
+int main(int argc, char *argv[])
+{
+    const unsigned long sequences = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 2000;
+
+    Simulation simulation;
+
+    const DIS::system_id_t system_id{0x01020304, 0x050607};
+    const DIS::regulatory_cert_data_list_t cert_data_list{cert_data};
+    const DIS::pnp_id_t pnp_id{0x01, 0x0822, 0x0001, 0x0100};
+
+    SimulatedPeer peer(simulation, 0, 0xd0);
+
+    for (unsigned long sequence = 0; sequence < sequences; sequence++) {
+        /* a reboot starts from an empty attribute table */
+        ble::gatt_server_mock().services.clear();
+
+        ble_error_t error = BLE_ERROR_NONE;
+        if (sequence & 1) {
+            simulation.measure("add_service (static)", [&] {
+                error = DIS::add_service(
+                    simulation.ble(),
+                    DIS::manufacturers_name_t{"manufacturer"},
+                    DIS::model_number_t{"model"},
+                    DIS::serial_number_t{"serial"},
+                    DIS::hardware_revision_t{"hardware"},
+                    DIS::firmware_revision_t{"firmware"},
+                    DIS::software_revision_t{"software"},
+                    system_id,
+                    cert_data_list,
+                    pnp_id
+                );
+            });
+        } else {
+            simulation.measure("add_service (runtime)", [&] {
+                error = DIS::add_service(
+                    simulation.ble(),
+                    "manufacturer", "model", "serial", "hardware", "firmware", "software",
+                    &system_id, &cert_data_list, &pnp_id
+                );
+            });
+        }
+        check(error == BLE_ERROR_NONE, "service added");
+
+        peer.connect();
+
+        for (uint16_t uuid : CHARACTERISTICS) {
+            ble::GattServerMock::characteristic_t *characteristic = simulation.find_characteristic(UUID(uuid));
+            check(characteristic != nullptr, "characteristic registered");
+            check(characteristic && characteristic->properties == GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ,
+                  "characteristic read only");
+
+            uint8_t value[32];
+            uint16_t len = sizeof(value);
+            check(peer.read(UUID(uuid), value, len) == AUTH_CALLBACK_REPLY_SUCCESS, "characteristic read");
+
+            const uint8_t data = 0;
+            check(peer.write(UUID(uuid), &data, sizeof(data)) != AUTH_CALLBACK_REPLY_SUCCESS,
+                  "characteristic write refused");
+        }
+
+        peer.disconnect();
+        simulation.advance(std::chrono::milliseconds(1000));
+    }
+
+    simulation.report(std::cout, "Device Information Service");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
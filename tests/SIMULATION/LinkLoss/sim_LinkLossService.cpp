@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Simulation.h"
+
+#include "ble-service-link-loss/LinkLossService.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace simulation;
+using namespace std::literals::chrono_literals;
+
+namespace {
+
+const size_t PEERS = 4;
+static_assert(PEERS <= MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS, "Every peer needs a connection slot");
+
+struct AlertCounter : LinkLossService::EventHandler {
+    void on_alert_requested(LinkLossService::AlertLevel) override
+    {
+        requested++;
+    }
+
+    void on_alert_end() override
+    {
+        ended++;
+    }
+
+    size_t requested = 0;
+    size_t ended = 0;
+};
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        if (failures++ < 10) {
+            fprintf(stderr, "FAILED: %s\n", what);
+        }
+    }
+}
+
+} // namespace
+
+/*
+ * Connect peers, have them write and read back their alert level and lose or close their link, over and over.
+ *
+ * Usage: sim_LinkLossService [sequences]
+ */
+int main(int argc, char *argv[])
+{
+    const unsigned long sequences = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 2000;
+
+    Simulation simulation;
+    const UUID alert_level_uuid(GattCharacteristic::UUID_ALERT_LEVEL_CHAR);
+
+    LinkLossService link_loss_service(simulation.ble(), simulation.event_queue(), simulation.gap_event_handler());
+    AlertCounter alerts;
+    link_loss_service.init();
+    link_loss_service.set_event_handler(&alerts);
+    link_loss_service.set_alert_timeout(10s);
+
+    SimulatedPeer peers[PEERS] = {
+        {simulation, 0, 0xd0}, {simulation, 1, 0xd1}, {simulation, 2, 0xd2}, {simulation, 3, 0xd3}
+    };
+
+    /* deterministic pseudo random sequence of operations */
+    uint32_t state = 12345;
+    unsigned long completed = 0;
+
+    while (completed < sequences) {
+        state = state * 1103515245 + 12345;
+        SimulatedPeer &peer = peers[(state >> 16) % PEERS];
+
+        if (!peer.connected()) {
+            peer.connect();
+        } else {
+            switch ((state >> 8) % 4) {
+                case 0:
+                case 1: {
+                    const uint8_t level = (state >> 20) % 3;
+                    check(peer.write(alert_level_uuid, &level, sizeof(level)) == AUTH_CALLBACK_REPLY_SUCCESS,
+                          "valid alert level accepted");
+
+                    uint8_t value = 0xff;
+                    uint16_t len = sizeof(value);
+                    check(peer.read(alert_level_uuid, &value, len) == AUTH_CALLBACK_REPLY_SUCCESS,
+                          "alert level read");
+                    check(len == 1 && value == level, "alert level read back");
+                    break;
+                }
+                case 2: {
+                    const uint8_t level = 3 + (state >> 20) % 253;
+                    check(peer.write(alert_level_uuid, &level, sizeof(level)) == AUTH_CALLBACK_REPLY_ATTERR_OUT_OF_RANGE,
+                          "invalid alert level rejected");
+                    break;
+                }
+                case 3:
+                    peer.disconnect(((state >> 20) & 1) ?
+                                    ble::disconnection_reason_t::CONNECTION_TIMEOUT :
+                                    ble::disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION);
+                    completed++;
+                    break;
+            }
+        }
+
+        check(alerts.requested - alerts.ended <= PEERS, "at most one alert per peer");
+
+        simulation.advance(std::chrono::milliseconds((state >> 4) % 1000));
+    }
+
+    /* every alert either ended with the reconnection of its peer or times out */
+    simulation.advance(11s);
+    check(alerts.requested == alerts.ended, "every alert requested ends");
+
+    simulation.report(std::cout, "Link Loss Service");
+    std::cout << "alerts requested: " << alerts.requested << ", ended: " << alerts.ended << "\n";
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
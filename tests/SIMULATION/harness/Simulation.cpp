@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Simulation.h"
+
+#include "ble/gap/Events.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+using namespace std::chrono;
+
+namespace simulation {
+
+void Statistics::add(nanoseconds latency)
+{
+    _samples.push_back(latency.count());
+    _total += latency;
+}
+
+size_t Statistics::count() const
+{
+    return _samples.size();
+}
+
+nanoseconds Statistics::total() const
+{
+    return _total;
+}
+
+nanoseconds Statistics::mean() const
+{
+    return _samples.empty() ? nanoseconds(0) : _total / static_cast<nanoseconds::rep>(_samples.size());
+}
+
+nanoseconds Statistics::percentile(double fraction) const
+{
+    if (_samples.empty()) {
+        return nanoseconds(0);
+    }
+
+    std::vector<nanoseconds::rep> sorted(_samples);
+    size_t rank = std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return nanoseconds(sorted[rank]);
+}
+
+nanoseconds Statistics::max() const
+{
+    return _samples.empty() ? nanoseconds(0) : nanoseconds(*std::max_element(_samples.begin(), _samples.end()));
+}
+
+double Statistics::throughput() const
+{
+    return (_total.count() == 0) ? 0 : _samples.size() / duration<double>(_total).count();
+}
+
+Simulation::Simulation() :
+    _start(steady_clock::now())
+{
+    /* every simulation starts from a fresh GATT server */
+    ble::delete_mocks();
+    ble::init_mocks();
+}
+
+Simulation::~Simulation()
+{
+    ble::delete_mocks();
+}
+
+BLE &Simulation::ble()
+{
+    return BLE::Instance();
+}
+
+events::EventQueue &Simulation::event_queue()
+{
+    return _event_queue;
+}
+
+ChainableGapEventHandler &Simulation::gap_event_handler()
+{
+    return _gap_event_handler;
+}
+
+ChainableGattServerEventHandler &Simulation::gatt_server_event_handler()
+{
+    return _gatt_server_event_handler;
+}
+
+void Simulation::advance(milliseconds duration)
+{
+    measure("dispatch", [&] { _event_queue.dispatch(duration.count()); });
+    _now += duration;
+}
+
+milliseconds Simulation::now() const
+{
+    return _now;
+}
+
+ble::GattServerMock::characteristic_t *Simulation::find_characteristic(const UUID &uuid)
+{
+    for (auto &service : ble::gatt_server_mock().services) {
+        for (auto &characteristic : service.characteristics) {
+            if (characteristic.uuid == uuid) {
+                return &characteristic;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void Simulation::report(std::ostream &os, const char *title) const
+{
+    auto us = [](nanoseconds latency) { return duration<double, std::micro>(latency).count(); };
+
+    os << title << ": " << duration_cast<seconds>(_now).count() << " s of virtual time in "
+       << std::fixed << std::setprecision(3) << duration<double>(steady_clock::now() - _start).count()
+       << " s of host time\n";
+
+    os << std::left << std::setw(24) << "operation" << std::right
+       << std::setw(10) << "count"
+       << std::setw(12) << "mean (us)"
+       << std::setw(12) << "p50 (us)"
+       << std::setw(12) << "p99 (us)"
+       << std::setw(12) << "max (us)"
+       << std::setw(14) << "ops/s" << "\n";
+
+    for (const auto &entry : _statistics) {
+        const Statistics &statistics = entry.second;
+        os << std::left << std::setw(24) << entry.first << std::right
+           << std::setw(10) << statistics.count()
+           << std::setprecision(3)
+           << std::setw(12) << us(statistics.mean())
+           << std::setw(12) << us(statistics.percentile(0.5))
+           << std::setw(12) << us(statistics.percentile(0.99))
+           << std::setw(12) << us(statistics.max())
+           << std::setprecision(0)
+           << std::setw(14) << statistics.throughput() << "\n";
+    }
+}
+
+const Statistics *Simulation::statistics(const char *operation) const
+{
+    for (const auto &entry : _statistics) {
+        if (entry.first == operation) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+Statistics &Simulation::find_statistics(const char *operation)
+{
+    for (auto &entry : _statistics) {
+        if (entry.first == operation) {
+            return entry.second;
+        }
+    }
+    _statistics.emplace_back(operation, Statistics());
+    return _statistics.back().second;
+}
+
+SimulatedPeer::SimulatedPeer(Simulation &simulation, ble::connection_handle_t connection_handle, uint8_t address_byte) :
+    _simulation(simulation),
+    _connection_handle(connection_handle)
+{
+    const uint8_t address_bytes[] = {0xfb, 0xdd, 0x62, 0x03, 0x04, address_byte};
+    _address = ble::address_t(address_bytes);
+}
+
+void SimulatedPeer::connect()
+{
+    const uint8_t local_address_bytes[] = {0x4d, 0xc7, 0x92, 0x0e, 0x51, 0xba};
+
+    ble::ConnectionCompleteEvent event(
+        BLE_ERROR_NONE,
+        _connection_handle,
+        ble::connection_role_t::PERIPHERAL,
+        ble::peer_address_type_t::PUBLIC,
+        _address,
+        ble::address_t(local_address_bytes),
+        _address,
+        ble::conn_interval_t(50),
+        ble::slave_latency_t::min(),
+        ble::supervision_timeout_t(100),
+        100
+    );
+
+    _simulation.measure("connect", [&] { _simulation.gap_event_handler().onConnectionComplete(event); });
+    _connected = true;
+}
+
+void SimulatedPeer::disconnect(ble::disconnection_reason_t reason)
+{
+    ble::DisconnectionCompleteEvent event(_connection_handle, reason);
+
+    _simulation.measure("disconnect", [&] { _simulation.gap_event_handler().onDisconnectionComplete(event); });
+    _connected = false;
+}
+
+GattAuthCallbackReply_t SimulatedPeer::write(const UUID &uuid, const uint8_t *data, uint16_t len)
+{
+    ble::GattServerMock::characteristic_t *characteristic = _simulation.find_characteristic(uuid);
+    if (!characteristic || !characteristic->write_cb) {
+        return AUTH_CALLBACK_REPLY_ATTERR_WRITE_NOT_PERMITTED;
+    }
+
+    GattWriteAuthCallbackParams write_request {
+        _connection_handle,
+        characteristic->value_handle,
+        0,
+        len,
+        data,
+        AUTH_CALLBACK_REPLY_SUCCESS
+    };
+
+    _simulation.measure("write", [&] { characteristic->write_cb(&write_request); });
+
+    return write_request.authorizationReply;
+}
+
+GattAuthCallbackReply_t SimulatedPeer::read(const UUID &uuid, uint8_t *buffer, uint16_t &len)
+{
+    ble::GattServerMock::characteristic_t *characteristic = _simulation.find_characteristic(uuid);
+    if (!characteristic) {
+        return AUTH_CALLBACK_REPLY_ATTERR_READ_NOT_PERMITTED;
+    }
+
+    /* values without a read authorization callback are served by the GATT server itself */
+    if (!characteristic->read_cb) {
+        ble_error_t error = BLE_ERROR_NONE;
+        _simulation.measure("read", [&] {
+            error = _simulation.ble().gattServer().read(characteristic->value_handle, buffer, &len);
+        });
+        return (error == BLE_ERROR_NONE) ? AUTH_CALLBACK_REPLY_SUCCESS : AUTH_CALLBACK_REPLY_ATTERR_UNLIKELY_ERROR;
+    }
+
+    GattReadAuthCallbackParams read_request {
+        _connection_handle,
+        characteristic->value_handle,
+        0,
+        0,
+        nullptr,
+        AUTH_CALLBACK_REPLY_SUCCESS
+    };
+
+    _simulation.measure("read", [&] { characteristic->read_cb(&read_request); });
+
+    if (read_request.authorizationReply == AUTH_CALLBACK_REPLY_SUCCESS) {
+        len = std::min(len, read_request.len);
+        memcpy(buffer, read_request.data, len);
+    }
+
+    return read_request.authorizationReply;
+}
+
+void SimulatedPeer::subscribe(const UUID &uuid, bool enable)
+{
+    ble::GattServerMock::characteristic_t *characteristic = _simulation.find_characteristic(uuid);
+    if (!characteristic) {
+        return;
+    }
+
+    /* the CCCD directly follows the value in the attribute table */
+    GattUpdatesEnabledCallbackParams params {
+        _connection_handle,
+        static_cast<GattAttribute::Handle_t>(characteristic->value_handle + 1),
+        characteristic->value_handle
+    };
+
+    if (enable) {
+        _simulation.measure("subscribe", [&] { _simulation.gatt_server_event_handler().onUpdatesEnabled(params); });
+    } else {
+        _simulation.measure("unsubscribe", [&] { _simulation.gatt_server_event_handler().onUpdatesDisabled(params); });
+    }
+}
+
+} // namespace simulation
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_SIMULATION_H
+#define BLE_SIMULATION_H
+
+#include "ble/BLE.h"
+#include "ble/GattServer.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+#include "events/EventQueue.h"
+
+#include "ble_mocks.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simulation {
+
+/**
+ * Latency samples of one kind of operation
+ */
+class Statistics {
+public:
+    void add(std::chrono::nanoseconds latency);
+
+    size_t count() const;
+
+    std::chrono::nanoseconds total() const;
+
+    std::chrono::nanoseconds mean() const;
+
+    /**
+     * @param fraction Fraction of the samples below the returned latency, 0.5 for the median
+     */
+    std::chrono::nanoseconds percentile(double fraction) const;
+
+    std::chrono::nanoseconds max() const;
+
+    /**
+     * @return Operations per second of host time spent in the operation
+     */
+    double throughput() const;
+
+private:
+    std::vector<std::chrono::nanoseconds::rep> _samples;
+    std::chrono::nanoseconds _total{0};
+};
+
+/**
+ * Simulation
+ *
+ * @par purpose
+ * Host side environment running services against the BLE and event queue doubles of the unit tests,
+ * in virtual time, while measuring the host time spent in every operation.
+ *
+ * @par usage
+ * Construct the services under test with ble(), event_queue() and the chainable event handlers, then
+ * drive them with SimulatedPeer objects. Virtual time only moves when advance() is called, which
+ * dispatches the events that fall due. Print the latency and throughput of each kind of operation with
+ * report().
+ *
+ * @attention The mocks are deleted when the simulation is destroyed; only one simulation may exist at a time.
+ */
+class Simulation {
+public:
+    Simulation();
+
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+    Simulation &operator=(const Simulation&) = delete;
+
+    BLE &ble();
+
+    events::EventQueue &event_queue();
+
+    ChainableGapEventHandler &gap_event_handler();
+
+    ChainableGattServerEventHandler &gatt_server_event_handler();
+
+    /**
+     * Move virtual time forward by @p duration, dispatching the events due; the time spent
+     * dispatching is recorded as the "dispatch" operation.
+     */
+    void advance(std::chrono::milliseconds duration);
+
+    /**
+     * @return Virtual time elapsed since the start of the simulation
+     */
+    std::chrono::milliseconds now() const;
+
+    /**
+     * Call @p f and record the host time it took under @p operation. @p f may measure operations of its own,
+     * their time is also included in @p operation.
+     */
+    template<typename F>
+    void measure(const char *operation, F f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto latency = std::chrono::steady_clock::now() - start;
+        /* looked up after f(), a nested measure may have added statistics and moved the others */
+        find_statistics(operation).add(latency);
+    }
+
+    /**
+     * @return Statistics recorded under @p operation or nullptr if it was never measured.
+     */
+    const Statistics *statistics(const char *operation) const;
+
+    /**
+     * @return Characteristic registered with @p uuid or nullptr if no service registered one.
+     */
+    ble::GattServerMock::characteristic_t *find_characteristic(const UUID &uuid);
+
+    /**
+     * Print the statistics of every operation, followed by the totals.
+     */
+    void report(std::ostream &os, const char *title) const;
+
+private:
+    Statistics &find_statistics(const char *operation);
+
+    events::EventQueue _event_queue;
+    ChainableGapEventHandler _gap_event_handler;
+    ChainableGattServerEventHandler _gatt_server_event_handler;
+
+    std::chrono::milliseconds _now{0};
+    std::chrono::steady_clock::time_point _start;
+    std::vector<std::pair<std::string, Statistics>> _statistics;
+};
+
+/**
+ * Simulated Peer
+ *
+ * @par purpose
+ * Remote GATT client connected to the simulated device. Every operation raises the GAP or GATT server
+ * events a real stack would raise and is recorded by the simulation under the name of the operation.
+ */
+class SimulatedPeer {
+public:
+    /**
+     * @param simulation Simulation the peer belongs to
+     * @param connection_handle Handle of the connection of the peer, unique among the connected peers
+     * @param address_byte Last byte of the public address of the peer
+     */
+    SimulatedPeer(Simulation &simulation, ble::connection_handle_t connection_handle, uint8_t address_byte);
+
+    void connect();
+
+    void disconnect(ble::disconnection_reason_t reason = ble::disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION);
+
+    /**
+     * Write @p len bytes of @p data to the characteristic with @p uuid.
+     *
+     * @return The authorization reply of the server
+     */
+    GattAuthCallbackReply_t write(const UUID &uuid, const uint8_t *data, uint16_t len);
+
+    /**
+     * Read the characteristic with @p uuid into @p buffer.
+     *
+     * @param[in,out] len Size of @p buffer, then length of the value read
+     *
+     * @return The authorization reply of the server
+     */
+    GattAuthCallbackReply_t read(const UUID &uuid, uint8_t *buffer, uint16_t &len);
+
+    /**
+     * Enable or disable the updates of the characteristic with @p uuid.
+     */
+    void subscribe(const UUID &uuid, bool enable = true);
+
+    bool connected() const
+    {
+        return _connected;
+    }
+
+    ble::connection_handle_t connection_handle() const
+    {
+        return _connection_handle;
+    }
+
+private:
+    Simulation &_simulation;
+    ble::connection_handle_t _connection_handle;
+    ble::address_t _address;
+    bool _connected = false;
+};
+
+} // namespace simulation
+
+#endif // BLE_SIMULATION_H
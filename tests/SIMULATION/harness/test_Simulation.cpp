@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "Simulation.h"
+
+#include <string>
+
+using namespace simulation;
+using namespace std::literals::chrono_literals;
+
+TEST(TestSimulation, measure_records_each_call)
+{
+    Simulation simulation;
+
+    simulation.measure("operation", [] { });
+    simulation.measure("operation", [] { });
+
+    ASSERT_NE(simulation.statistics("operation"), nullptr);
+    EXPECT_EQ(simulation.statistics("operation")->count(), 2);
+    EXPECT_EQ(simulation.statistics("other operation"), nullptr);
+}
+
+TEST(TestSimulation, nested_measure_of_new_operations)
+{
+    Simulation simulation;
+    const std::string inner[] = {"inner 0", "inner 1", "inner 2", "inner 3", "inner 4", "inner 5", "inner 6"};
+
+    // Each inner operation is new, the statistics of the outer one move while it is measured
+    simulation.measure("outer", [&] {
+        for (const std::string &operation : inner) {
+            simulation.measure(operation.c_str(), [] { });
+        }
+    });
+
+    ASSERT_NE(simulation.statistics("outer"), nullptr);
+    EXPECT_EQ(simulation.statistics("outer")->count(), 1);
+    for (const std::string &operation : inner) {
+        ASSERT_NE(simulation.statistics(operation.c_str()), nullptr);
+        EXPECT_EQ(simulation.statistics(operation.c_str())->count(), 1);
+        EXPECT_LE(simulation.statistics(operation.c_str())->total(), simulation.statistics("outer")->total());
+    }
+}
+
+TEST(TestSimulation, nested_measure_from_dispatch)
+{
+    Simulation simulation;
+    int calls = 0;
+
+    simulation.event_queue().call_in(10ms, [&] {
+        simulation.measure("handler", [&] { calls++; });
+    });
+    simulation.advance(20ms);
+
+    EXPECT_EQ(calls, 1);
+    ASSERT_NE(simulation.statistics("dispatch"), nullptr);
+    EXPECT_EQ(simulation.statistics("dispatch")->count(), 1);
+    ASSERT_NE(simulation.statistics("handler"), nullptr);
+    EXPECT_EQ(simulation.statistics("handler")->count(), 1);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "ble/common/AlertDispatcher.h"
+
+using namespace ble;
+
+using ::testing::InSequence;
+
+struct EventHandlerMock : AlertDispatcher::EventHandler {
+    MOCK_METHOD(void, on_alert_changed, (AlertLevel, uint8_t), (override));
+};
+
+class TestAlertDispatcher : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    EventHandlerMock event_handler_mock;
+    AlertDispatcher alert_dispatcher{event_queue};
+
+    void SetUp()
+    {
+        alert_dispatcher.set_event_handler(&event_handler_mock);
+    }
+};
+
+TEST_F(TestAlertDispatcher, level_is_highest_requested)
+{
+    EXPECT_EQ(alert_dispatcher.get_level(), AlertLevel::NO_ALERT);
+    EXPECT_EQ(alert_dispatcher.get_sources(), 0);
+
+    alert_dispatcher.request(AlertDispatcher::IMMEDIATE_ALERT, AlertLevel::MILD_ALERT);
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::HIGH_ALERT);
+
+    // The state is up to date before the event queue runs
+    EXPECT_EQ(alert_dispatcher.get_level(), AlertLevel::HIGH_ALERT);
+    EXPECT_EQ(alert_dispatcher.get_sources(), AlertDispatcher::IMMEDIATE_ALERT | AlertDispatcher::LINK_LOSS);
+
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::NO_ALERT);
+
+    EXPECT_EQ(alert_dispatcher.get_level(), AlertLevel::MILD_ALERT);
+    EXPECT_EQ(alert_dispatcher.get_sources(), AlertDispatcher::IMMEDIATE_ALERT);
+}
+
+TEST_F(TestAlertDispatcher, concurrent_requests_coalesced)
+{
+    // Nothing is called from request()
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::MILD_ALERT);
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::HIGH_ALERT);
+    alert_dispatcher.request(AlertDispatcher::IMMEDIATE_ALERT, AlertLevel::MILD_ALERT);
+    alert_dispatcher.request(AlertDispatcher::OUT_OF_RANGE, AlertLevel::HIGH_ALERT);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The requests of the three sources raise a single call
+    EXPECT_CALL(event_handler_mock, on_alert_changed(
+            AlertLevel::HIGH_ALERT,
+            AlertDispatcher::LINK_LOSS | AlertDispatcher::IMMEDIATE_ALERT | AlertDispatcher::OUT_OF_RANGE));
+    event_queue.dispatch(0);
+
+    EXPECT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestAlertDispatcher, end_of_alert_reported)
+{
+    alert_dispatcher.request(AlertDispatcher::IMMEDIATE_ALERT, AlertLevel::HIGH_ALERT);
+
+    {
+        InSequence sequence;
+        EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::HIGH_ALERT, AlertDispatcher::IMMEDIATE_ALERT));
+        EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::NO_ALERT, 0));
+    }
+    event_queue.dispatch(0);
+
+    alert_dispatcher.request(AlertDispatcher::IMMEDIATE_ALERT, AlertLevel::NO_ALERT);
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestAlertDispatcher, withdrawn_request_not_reported)
+{
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+
+    // The alert ends before the event queue runs
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::HIGH_ALERT);
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::NO_ALERT);
+
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestAlertDispatcher, source_joining_reported)
+{
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::HIGH_ALERT);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::HIGH_ALERT, AlertDispatcher::LINK_LOSS));
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The level stays the same but another source is alerting
+    EXPECT_CALL(event_handler_mock, on_alert_changed(
+            AlertLevel::HIGH_ALERT, AlertDispatcher::LINK_LOSS | AlertDispatcher::IMMEDIATE_ALERT));
+    alert_dispatcher.request(AlertDispatcher::IMMEDIATE_ALERT, AlertLevel::MILD_ALERT);
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // A source changing its level without changing the alert is not reported
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+    alert_dispatcher.request(AlertDispatcher::IMMEDIATE_ALERT, AlertLevel::HIGH_ALERT);
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestAlertDispatcher, request_from_handler)
+{
+    // The handler silences the out-of-range alert as soon as it is raised
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::MILD_ALERT, AlertDispatcher::OUT_OF_RANGE))
+            .WillOnce([this](AlertLevel, uint8_t) {
+                alert_dispatcher.request(AlertDispatcher::OUT_OF_RANGE, AlertLevel::NO_ALERT);
+            });
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::NO_ALERT, 0));
+
+    alert_dispatcher.request(AlertDispatcher::OUT_OF_RANGE, AlertLevel::MILD_ALERT);
+    event_queue.dispatch(0);
+
+    // The request made by the handler was reported by the same dispatch
+    EXPECT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestAlertDispatcher, no_handler)
+{
+    alert_dispatcher.set_event_handler(nullptr);
+
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::HIGH_ALERT);
+    event_queue.dispatch(0);
+
+    // The change is not reported again once a handler is set
+    alert_dispatcher.set_event_handler(&event_handler_mock);
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+    event_queue.dispatch(0);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace allocation_tracker {
+
+static thread_local size_t thread_allocations = 0;
+
+size_t allocations()
+{
+    return thread_allocations;
+}
+
+} // namespace allocation_tracker
+
+#if defined(__GLIBC__)
+
+/* glibc exports its allocator under these names, the C++ runtime allocates through malloc */
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    allocation_tracker::thread_allocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    allocation_tracker::thread_allocations++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    allocation_tracker::thread_allocations++;
+    return __libc_realloc(ptr, size);
+}
+}
+
+static void *allocate(size_t size)
+{
+    return malloc(size ? size : 1);
+}
+
+#else
+
+static void *allocate(size_t size)
+{
+    allocation_tracker::thread_allocations++;
+    return malloc(size ? size : 1);
+}
+
+#endif // defined(__GLIBC__)
+
+void *operator new(size_t size)
+{
+    void *ptr = allocate(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_UNITTEST_ALLOCATION_TRACKER_H
+#define BLE_UNITTEST_ALLOCATION_TRACKER_H
+
+#include <cstddef>
+#include <utility>
+
+/**
+ * Allocation Tracker
+ *
+ * @par purpose
+ * Services run in firmware where a heap allocation in a BLE callback or an event queue handler is a bug.
+ * Linking the allocation tracker into a test binary replaces the global operator new and, with glibc, malloc,
+ * calloc and realloc with versions counting the allocations of each thread.
+ *
+ * @par usage
+ * Run the callback under test with allocations_in() and expect the result to be zero. A double allocating when
+ * it is called, such as a gmock mock recording the call, is whitelisted explicitly: measure it by calling it
+ * directly with the same arguments, expect the exact number of calls the callback makes to it and allow that
+ * many times its allocations, no more.
+ *
+ * @code
+ * size_t mock_allocations = allocation_tracker::allocations_in([&] { ble.gattServer().write(handle, value, 1); });
+ * EXPECT_CALL(gatt_server_mock(), write(_, _, _, _)).Times(1);
+ * EXPECT_EQ(allocation_tracker::allocations_in([&] { simulate_write_event(value, 1); }), mock_allocations);
+ * @endcode
+ */
+namespace allocation_tracker {
+
+/**
+ * @return Number of heap allocations made by the calling thread since it started
+ */
+size_t allocations();
+
+/**
+ * @return Number of heap allocations made by the calling thread while running @p f
+ */
+template<typename F>
+size_t allocations_in(F &&f)
+{
+    const size_t before = allocations();
+    std::forward<F>(f)();
+    return allocations() - before;
+}
+
+} // namespace allocation_tracker
+
+#endif // BLE_UNITTEST_ALLOCATION_TRACKER_H
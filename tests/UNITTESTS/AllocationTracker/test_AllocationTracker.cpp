@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using allocation_tracker::allocations_in;
+
+TEST(TestAllocationTracker, counts_operator_new)
+{
+    ASSERT_EQ(allocations_in([] { delete new int(1); }), 1);
+    ASSERT_EQ(allocations_in([] { delete[] new int[4]; }), 1);
+    ASSERT_EQ(allocations_in([] { std::make_unique<std::vector<int>>(16); }), 2);
+}
+
+#if defined(__GLIBC__)
+TEST(TestAllocationTracker, counts_malloc)
+{
+    ASSERT_EQ(allocations_in([] { free(malloc(8)); }), 1);
+    ASSERT_EQ(allocations_in([] { free(calloc(2, 8)); }), 1);
+}
+#endif
+
+TEST(TestAllocationTracker, ignores_stack)
+{
+    ASSERT_EQ(allocations_in([] {
+        int values[16] = {};
+        volatile int *escape = values;
+        (void) escape;
+    }), 0);
+}
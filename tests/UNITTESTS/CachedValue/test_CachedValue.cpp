@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/gatt/CachedValue.h"
+
+#include "ble_mocks.h"
+
+using namespace ble;
+
+using ::testing::_;
+using ::testing::Return;
+
+class TestCachedValue : public testing::Test {
+protected:
+    const GattAttribute::Handle_t handle = 0x10;
+
+    GattServer &server()
+    {
+        return BLE::Instance().gattServer();
+    }
+
+    void TearDown()
+    {
+        ble::delete_mocks();
+    }
+};
+
+TEST_F(TestCachedValue, first_write_reaches_server)
+{
+    CachedValue<10> value;
+    const uint8_t data[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    EXPECT_CALL(gatt_server_mock(), write(handle, data, 10, _))
+            .Times(1);
+
+    ASSERT_EQ(value.write(server(), handle, data), BLE_ERROR_NONE);
+    EXPECT_EQ(value.writes(), 1);
+    EXPECT_EQ(value.suppressed_writes(), 0);
+}
+
+TEST_F(TestCachedValue, local_only_write)
+{
+    CachedValue<10> value;
+    const uint8_t data[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    EXPECT_CALL(gatt_server_mock(), write(handle, data, 10, true))
+            .Times(1);
+
+    ASSERT_EQ(value.write(server(), handle, data, true), BLE_ERROR_NONE);
+    ASSERT_EQ(value.write(server(), handle, data, true), BLE_ERROR_NONE);
+    EXPECT_EQ(value.writes(), 1);
+    EXPECT_EQ(value.suppressed_writes(), 1);
+}
+
+TEST_F(TestCachedValue, unchanged_write_suppressed)
+{
+    CachedValue<10> value;
+    const uint8_t data[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    uint8_t copy[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    EXPECT_CALL(gatt_server_mock(), write(handle, _, 10, _))
+            .Times(1);
+
+    value.write(server(), handle, data);
+
+    /* the bytes are compared, not the buffers */
+    ASSERT_EQ(value.write(server(), handle, copy), BLE_ERROR_NONE);
+    EXPECT_FALSE(value.changed(copy));
+    EXPECT_EQ(value.writes(), 1);
+    EXPECT_EQ(value.suppressed_writes(), 1);
+}
+
+TEST_F(TestCachedValue, any_byte_change_is_written)
+{
+    CachedValue<10> value;
+    uint8_t data[10] = { };
+
+    value.write(server(), handle, data);
+
+    /* every byte, including the ones of the tail compared after the first word */
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] ^= 0x80;
+        ASSERT_TRUE(value.changed(data));
+        EXPECT_CALL(gatt_server_mock(), write(handle, data, 10, _))
+                .Times(1);
+        value.write(server(), handle, data);
+        testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+    }
+
+    EXPECT_EQ(value.writes(), 11);
+    EXPECT_EQ(value.suppressed_writes(), 0);
+}
+
+TEST_F(TestCachedValue, invalidate)
+{
+    CachedValue<1> value;
+    const uint8_t data = 0x42;
+
+    EXPECT_CALL(gatt_server_mock(), write(handle, _, 1, _))
+            .Times(2);
+
+    value.write(server(), handle, &data);
+    value.invalidate();
+    ASSERT_TRUE(value.changed(&data));
+    value.write(server(), handle, &data);
+}
+
+TEST_F(TestCachedValue, failed_write_not_cached)
+{
+    CachedValue<4> value;
+    const uint8_t data[4] = { 1, 2, 3, 4 };
+
+    EXPECT_CALL(gatt_server_mock(), write(handle, _, 4, _))
+            .WillOnce(Return(BLE_ERROR_NO_MEM))
+            .WillOnce(Return(BLE_ERROR_NONE));
+
+    ASSERT_EQ(value.write(server(), handle, data), BLE_ERROR_NO_MEM);
+    EXPECT_EQ(value.writes(), 0);
+
+    /* the retry with the same value reaches the server */
+    ASSERT_EQ(value.write(server(), handle, data), BLE_ERROR_NONE);
+    EXPECT_EQ(value.writes(), 1);
+}
+
+TEST_F(TestCachedValue, large_value)
+{
+    CachedValue<64> value;
+    uint8_t data[64] = { };
+
+    EXPECT_CALL(gatt_server_mock(), write(handle, _, 64, _))
+            .Times(2);
+
+    value.write(server(), handle, data);
+    value.write(server(), handle, data);
+
+    data[63] = 1;
+    value.write(server(), handle, data);
+
+    EXPECT_EQ(value.suppressed_writes(), 1);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/common/ConnectionTable.h"
+
+#include <map>
+
+using namespace ble;
+
+TEST(TestConnectionTable, insert_find_erase)
+{
+    ConnectionTable<int, 4> table;
+
+    ASSERT_EQ(table.find(0), nullptr);
+
+    *table.insert(0) = 10;
+    *table.insert(1) = 11;
+
+    ASSERT_EQ(table.size(), 2);
+    ASSERT_EQ(*table.find(0), 10);
+    ASSERT_EQ(*table.find(1), 11);
+
+    /* inserting an existing connection returns its state */
+    ASSERT_EQ(*table.insert(1), 11);
+    ASSERT_EQ(table.size(), 2);
+
+    ASSERT_TRUE(table.erase(0));
+    ASSERT_FALSE(table.erase(0));
+    ASSERT_EQ(table.find(0), nullptr);
+    ASSERT_EQ(*table.find(1), 11);
+    ASSERT_EQ(table.size(), 1);
+}
+
+TEST(TestConnectionTable, full)
+{
+    ConnectionTable<int, 3> table;
+
+    ASSERT_NE(table.insert(7), nullptr);
+    ASSERT_NE(table.insert(8), nullptr);
+    ASSERT_NE(table.insert(9), nullptr);
+
+    ASSERT_TRUE(table.full());
+    ASSERT_EQ(table.insert(10), nullptr);
+
+    /* looking up a missing connection in a full table terminates */
+    ASSERT_EQ(table.find(10), nullptr);
+}
+
+TEST(TestConnectionTable, colliding_handles)
+{
+    ConnectionTable<int, 4> table;
+
+    /* all of these land in the same home slot */
+    *table.insert(1) = 1;
+    *table.insert(5) = 5;
+    *table.insert(9) = 9;
+    *table.insert(2) = 2;
+
+    /* erasing the head of the probe sequence must keep the displaced entries reachable */
+    ASSERT_TRUE(table.erase(1));
+
+    ASSERT_EQ(*table.find(5), 5);
+    ASSERT_EQ(*table.find(9), 9);
+    ASSERT_EQ(*table.find(2), 2);
+}
+
+TEST(TestConnectionTable, matches_reference_map)
+{
+    ConnectionTable<int, 8> table;
+    std::map<connection_handle_t, int> reference;
+
+    /* deterministic pseudo random sequence of operations */
+    uint32_t state = 12345;
+    for (int i = 0; i < 10000; i++) {
+        state = state * 1103515245 + 12345;
+        connection_handle_t handle = (state >> 16) % 24;
+
+        if ((state >> 8) & 1) {
+            int *value = table.insert(handle);
+            if (reference.count(handle) || reference.size() < 8) {
+                ASSERT_NE(value, nullptr);
+                *value = i;
+                reference[handle] = i;
+            } else {
+                ASSERT_EQ(value, nullptr);
+            }
+        } else {
+            ASSERT_EQ(table.erase(handle), reference.erase(handle) == 1);
+        }
+
+        ASSERT_EQ(table.size(), reference.size());
+        for (connection_handle_t h = 0; h < 24; h++) {
+            int *value = table.find(h);
+            if (reference.count(h)) {
+                ASSERT_NE(value, nullptr);
+                ASSERT_EQ(*value, reference[h]);
+            } else {
+                ASSERT_EQ(value, nullptr);
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KVStoreFake.h"
+#include "kvstore_global_api/kvstore_global_api.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+/* any non zero value is a failure for the callers */
+const int KV_FAKE_ERROR = -1;
+const int KV_FAKE_ITEM_NOT_FOUND = -2;
+
+std::map<std::string, std::vector<uint8_t>> store;
+size_t write_count = 0;
+bool failing = false;
+
+} // namespace
+
+namespace kvstore_fake {
+
+void reset()
+{
+    store.clear();
+    write_count = 0;
+    failing = false;
+}
+
+size_t writes()
+{
+    return write_count;
+}
+
+void fail(bool fail)
+{
+    failing = fail;
+}
+
+} // namespace kvstore_fake
+
+int kv_set(const char *full_name_key, const void *buffer, size_t size, uint32_t)
+{
+    if (failing || strlen(full_name_key) >= KV_MAX_KEY_LENGTH) {
+        return KV_FAKE_ERROR;
+    }
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(buffer);
+    store[full_name_key].assign(bytes, bytes + size);
+    write_count++;
+
+    return 0;
+}
+
+int kv_get(const char *full_name_key, void *buffer, size_t buffer_size, size_t *actual_size)
+{
+    if (failing) {
+        return KV_FAKE_ERROR;
+    }
+
+    auto entry = store.find(full_name_key);
+    if (entry == store.end()) {
+        return KV_FAKE_ITEM_NOT_FOUND;
+    }
+
+    const size_t size = (entry->second.size() < buffer_size) ? entry->second.size() : buffer_size;
+    memcpy(buffer, entry->second.data(), size);
+    if (actual_size) {
+        *actual_size = size;
+    }
+
+    return 0;
+}
+
+int kv_remove(const char *full_name_key)
+{
+    return store.erase(full_name_key) ? 0 : KV_FAKE_ITEM_NOT_FOUND;
+}
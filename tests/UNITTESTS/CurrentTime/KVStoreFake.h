@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_UNITTEST_KVSTORE_FAKE_H
+#define BLE_UNITTEST_KVSTORE_FAKE_H
+
+#include <cstddef>
+
+/**
+ * KVStore Fake
+ *
+ * @par purpose
+ * In memory store behind the global KVStore API, standing for the flash of the device across simulated resets:
+ * destroy the service, construct a new one and init() it to boot again with the same store.
+ *
+ * @par usage
+ * Call reset() before each test. The number of kv_set() calls tells how many times the flash would have
+ * been written.
+ */
+namespace kvstore_fake {
+
+/**
+ * Erase every key and clear the counters
+ */
+void reset();
+
+/**
+ * @return Number of successful kv_set() calls since the last reset()
+ */
+size_t writes();
+
+/**
+ * Make the following kv_get() and kv_set() calls fail, as a store that is not mounted
+ */
+void fail(bool failing);
+
+} // namespace kvstore_fake
+
+#endif // BLE_UNITTEST_KVSTORE_FAKE_H
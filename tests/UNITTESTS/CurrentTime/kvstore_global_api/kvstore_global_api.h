@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_UNITTEST_KVSTORE_GLOBAL_API_H
+#define BLE_UNITTEST_KVSTORE_GLOBAL_API_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Stand-in for the global KVStore API of mbed-os, found before it on the include path of the persistence tests.
+ * Only the functions used by the services are declared; they are implemented in memory by KVStoreFake.cpp.
+ */
+
+#define KV_MAX_KEY_LENGTH 128
+
+int kv_set(const char *full_name_key, const void *buffer, size_t size, uint32_t create_flags);
+
+int kv_get(const char *full_name_key, void *buffer, size_t buffer_size, size_t *actual_size);
+
+int kv_remove(const char *full_name_key);
+
+#endif // BLE_UNITTEST_KVSTORE_GLOBAL_API_H
@@ -0,0 +1,932 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/GattServer.h"
+
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+#include "ble-service-current-time/CivilCalendar.h"
+#include "ble-service-current-time/ClockDiscipline.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <ctime>
+
+using namespace ble;
+
+using ::testing::_;
+using ::testing::Property;
+
+/* the calendar engine is constexpr so its basic properties can be checked at compile time */
+static_assert(CivilCalendar::days_from_civil(1970, 1, 1) == 0, "Epoch is day 0");
+static_assert(CivilCalendar::days_from_civil(2000, 3, 1) == 11017, "2000-03-01 is day 11017");
+static_assert(CivilCalendar::days_from_civil(1969, 12, 31) == -1, "Day before epoch is -1");
+static_assert(CivilCalendar::weekday_from_days(0) == 4, "1970-01-01 was a Thursday");
+static_assert(CivilCalendar::weekday_from_days(-4) == 7, "1969-12-28 was a Sunday");
+static_assert(CivilCalendar::is_leap_year(2000) && !CivilCalendar::is_leap_year(1900), "Gregorian leap years");
+static_assert(CivilCalendar::days_in_month(2024, 2) == 29, "February of a leap year has 29 days");
+static_assert(CivilCalendar::civil_from_days(-1).year == 1969, "Day -1 is in 1969");
+static_assert(CivilCalendar::civil_from_days(-1).day == 31, "Day -1 is December 31st");
+static_assert(CivilCalendar::seconds_from_date_time(CivilCalendar::date_time_from_seconds(1626264896)) == 1626264896,
+              "Conversions round trip");
+static_assert(CivilCalendar::advance(CivilCalendar::date_time_from_seconds(1609459199), 1).year == 2021,
+              "Advancing past new year's eve rolls the year over");
+
+static bool operator==(const CivilCalendar::DateTime &lhs, const CivilCalendar::DateTime &rhs)
+{
+    return lhs.year    == rhs.year    &&
+           lhs.month   == rhs.month   &&
+           lhs.day     == rhs.day     &&
+           lhs.hours   == rhs.hours   &&
+           lhs.minutes == rhs.minutes &&
+           lhs.seconds == rhs.seconds &&
+           lhs.weekday == rhs.weekday;
+}
+
+TEST(TestCivilCalendar, matches_gmtime)
+{
+    /* from the start of the Gregorian calendar to the end of the range of the characteristic */
+    const int64_t first = CivilCalendar::seconds_from_date_time({1582, 10, 15, 0, 0, 0, 0});
+    const int64_t last  = CivilCalendar::seconds_from_date_time({9999, 12, 31, 23, 59, 59, 0});
+
+    for (int64_t seconds = first; seconds <= last; seconds += 1000003) {
+        time_t time = static_cast<time_t>(seconds);
+        struct tm tm{};
+        ASSERT_TRUE(gmtime_r(&time, &tm));
+
+        CivilCalendar::DateTime date_time = CivilCalendar::date_time_from_seconds(seconds);
+
+        ASSERT_EQ(date_time.year,    tm.tm_year + 1900);
+        ASSERT_EQ(date_time.month,   tm.tm_mon + 1);
+        ASSERT_EQ(date_time.day,     tm.tm_mday);
+        ASSERT_EQ(date_time.hours,   tm.tm_hour);
+        ASSERT_EQ(date_time.minutes, tm.tm_min);
+        ASSERT_EQ(date_time.seconds, tm.tm_sec);
+        ASSERT_EQ(date_time.weekday, tm.tm_wday == 0 ? 7 : tm.tm_wday);
+
+        ASSERT_EQ(CivilCalendar::seconds_from_date_time(date_time), seconds);
+    }
+}
+
+TEST(TestCivilCalendar, advance_matches_full_conversion)
+{
+    /* 2020-02-28 23:00:00, crosses a leap day, a month end and a year end */
+    const int64_t start = 1582930800;
+
+    for (int64_t seconds = start; seconds < start + 400 * CivilCalendar::SECONDS_PER_DAY; seconds += 3607) {
+        CivilCalendar::DateTime date_time = CivilCalendar::date_time_from_seconds(seconds);
+
+        for (uint32_t delta : {1u, 59u, 61u, 3599u, 3601u, 86399u}) {
+            ASSERT_TRUE(CivilCalendar::advance(date_time, delta) ==
+                        CivilCalendar::date_time_from_seconds(seconds + delta));
+        }
+    }
+}
+
+/*
+ * Local clock started at boot and running @p drift_ppm parts per million fast (negative if slow), read in
+ * steps of @p local_resolution milliseconds, whole seconds by default as time() does. The reference clock is
+ * the time of the host, read in steps of @p reference_resolution milliseconds.
+ */
+class DriftingClock {
+public:
+    /* Wednesday 2021-07-14 12:00:00 */
+    static const int64_t BOOT_REFERENCE = 1626264000000;
+
+    explicit DriftingClock(double drift_ppm, int64_t local_resolution = 1000, int64_t reference_resolution = 1000) :
+        _drift_ppm(drift_ppm),
+        _local_resolution(local_resolution),
+        _reference_resolution(reference_resolution)
+    {
+    }
+
+    void advance(int64_t ms)
+    {
+        _elapsed += ms;
+    }
+
+    int64_t local() const
+    {
+        return round_down(static_cast<int64_t>(_elapsed * (1 + _drift_ppm / 1e6)), _local_resolution);
+    }
+
+    int64_t reference() const
+    {
+        return round_down(BOOT_REFERENCE + _elapsed, _reference_resolution);
+    }
+
+    /* the exact reference time, as opposed to the one the host would send */
+    int64_t true_time() const
+    {
+        return BOOT_REFERENCE + _elapsed;
+    }
+
+private:
+    static int64_t round_down(int64_t ms, int64_t resolution)
+    {
+        return (ms / resolution) * resolution;
+    }
+
+    double _drift_ppm;
+    int64_t _local_resolution;
+    int64_t _reference_resolution;
+    int64_t _elapsed = 0;
+};
+
+static const int64_t MS_PER_HOUR = 3600 * 1000;
+
+using TestClock = ClockDiscipline<8>;
+
+/* 500 ppm */
+static const int32_t MAX_DRIFT = 500000;
+
+TEST(TestClockDiscipline, unsynchronised)
+{
+    TestClock clock(MAX_DRIFT);
+
+    EXPECT_FALSE(clock.synchronised());
+    EXPECT_EQ(clock.error_bound(0), std::numeric_limits<int64_t>::max());
+}
+
+TEST(TestClockDiscipline, first_sample_sets_time)
+{
+    TestClock clock(MAX_DRIFT);
+    DriftingClock rtc(0);
+
+    clock.synchronise(rtc.local(), rtc.reference(), 1000);
+
+    EXPECT_TRUE(clock.synchronised());
+    EXPECT_EQ(clock.reference(rtc.local()), rtc.reference());
+    EXPECT_EQ(clock.drift(), 0);
+
+    /* nothing is known about the drift yet */
+    EXPECT_EQ(clock.drift_uncertainty(), MAX_DRIFT);
+    EXPECT_EQ(clock.error_bound(rtc.local() + MS_PER_HOUR), 1000 + MS_PER_HOUR / 2000);
+}
+
+TEST(TestClockDiscipline, corrects_simulated_drift)
+{
+    for (double drift_ppm : {-200.0, -35.5, 0.0, 20.0, 100.0, 450.0}) {
+        TestClock clock(MAX_DRIFT);
+        DriftingClock rtc(drift_ppm);
+
+        /* a client writes the time every hour for 8 hours */
+        for (int i = 0; i < 8; i++) {
+            rtc.advance(MS_PER_HOUR + 137);
+            clock.synchronise(rtc.local(), rtc.reference(), 1000);
+        }
+
+        /* a slow clock has a positive drift */
+        EXPECT_NEAR(clock.drift(), -drift_ppm * 1000, clock.drift_uncertainty()) << drift_ppm;
+        EXPECT_LT(clock.drift_uncertainty(), 100000) << drift_ppm;
+
+        /* then no client shows up for a day */
+        for (int hour = 1; hour <= 24; hour++) {
+            rtc.advance(MS_PER_HOUR);
+
+            int64_t error = std::llabs(clock.reference(rtc.local()) - rtc.true_time());
+            ASSERT_LE(error, clock.error_bound(rtc.local())) << drift_ppm << " ppm after " << hour << " hours";
+        }
+
+        /* without the correction the time would be off by drift_ppm * 86.4 ms */
+        int64_t error = std::llabs(clock.reference(rtc.local()) - rtc.true_time());
+        EXPECT_LE(error, 2000 + std::abs(drift_ppm) * 86.4 / 10) << drift_ppm;
+    }
+}
+
+TEST(TestClockDiscipline, fine_samples_converge_faster)
+{
+    TestClock clock(MAX_DRIFT);
+    DriftingClock rtc(100, 1, 4);
+
+    /* samples known to 4 ms pin the drift down within minutes instead of hours */
+    for (int i = 0; i < 8; i++) {
+        rtc.advance(60 * 1000 + 137);
+        clock.synchronise(rtc.local(), rtc.reference(), 4);
+    }
+
+    EXPECT_NEAR(clock.drift(), -100000, clock.drift_uncertainty());
+    EXPECT_LT(clock.drift_uncertainty(), 50000);
+
+    rtc.advance(MS_PER_HOUR);
+    EXPECT_LE(std::llabs(clock.reference(rtc.local()) - rtc.true_time()), clock.error_bound(rtc.local()));
+    EXPECT_LT(clock.error_bound(rtc.local()), 200);
+}
+
+TEST(TestClockDiscipline, error_bound_shrinks_with_samples)
+{
+    TestClock clock(MAX_DRIFT);
+    DriftingClock rtc(80);
+
+    int64_t previous_uncertainty = clock.drift_uncertainty();
+
+    for (int i = 0; i < 8; i++) {
+        clock.synchronise(rtc.local(), rtc.reference(), 1000);
+
+        EXPECT_LE(clock.drift_uncertainty(), previous_uncertainty);
+        previous_uncertainty = clock.drift_uncertainty();
+
+        rtc.advance(2 * MS_PER_HOUR);
+    }
+
+    EXPECT_LT(previous_uncertainty, MAX_DRIFT / 10);
+}
+
+TEST(TestClockDiscipline, history_follows_drift_change)
+{
+    TestClock clock(MAX_DRIFT);
+    DriftingClock rtc(50);
+
+    for (int i = 0; i < 8; i++) {
+        clock.synchronise(rtc.local(), rtc.reference(), 1000);
+        rtc.advance(MS_PER_HOUR);
+    }
+    EXPECT_NEAR(clock.drift(), -50000, clock.drift_uncertainty());
+
+    /* the oscillator warms up: rebuild the same elapsed time with a different rate from here on */
+    TestClock restarted = clock;
+    DriftingClock warm_rtc(-50);
+    int64_t local_base = rtc.local() - warm_rtc.local();
+    int64_t reference_base = rtc.reference() - warm_rtc.reference();
+
+    for (int i = 0; i < 8; i++) {
+        warm_rtc.advance(MS_PER_HOUR);
+        restarted.synchronise(local_base + warm_rtc.local(), reference_base + warm_rtc.reference(), 1000);
+    }
+
+    /* the samples of the old rate have left the history */
+    EXPECT_NEAR(restarted.drift(), 50000, restarted.drift_uncertainty());
+}
+
+TEST(TestClockDiscipline, step_keeps_drift)
+{
+    TestClock clock(MAX_DRIFT);
+    DriftingClock rtc(100);
+
+    for (int i = 0; i < 8; i++) {
+        clock.synchronise(rtc.local(), rtc.reference(), 1000);
+        rtc.advance(MS_PER_HOUR);
+    }
+    int32_t drift = clock.drift();
+    int32_t uncertainty = clock.drift_uncertainty();
+
+    /* change of time zone */
+    clock.step(rtc.local(), rtc.reference() + MS_PER_HOUR, 1000);
+    EXPECT_EQ(clock.reference(rtc.local()), rtc.reference() + MS_PER_HOUR);
+    EXPECT_EQ(clock.drift(), drift);
+
+    /* a single sample after the step does not replace the estimate */
+    rtc.advance(MS_PER_HOUR);
+    clock.synchronise(rtc.local(), rtc.reference() + MS_PER_HOUR, 1000);
+    EXPECT_EQ(clock.drift(), drift);
+    EXPECT_EQ(clock.drift_uncertainty(), uncertainty);
+}
+
+TEST(TestClockDiscipline, implausible_sample_is_a_step)
+{
+    TestClock clock(MAX_DRIFT);
+    DriftingClock rtc(100);
+
+    for (int i = 0; i < 8; i++) {
+        clock.synchronise(rtc.local(), rtc.reference(), 1000);
+        rtc.advance(MS_PER_HOUR);
+    }
+    int32_t drift = clock.drift();
+
+    /* a host a minute off in one hour cannot be explained by drift */
+    clock.synchronise(rtc.local(), rtc.reference() + 60000, 1000);
+
+    EXPECT_EQ(clock.reference(rtc.local()), rtc.reference() + 60000);
+    EXPECT_EQ(clock.drift(), drift);
+}
+
+TEST(TestClockDiscipline, restore)
+{
+    TestClock clock(MAX_DRIFT);
+    DriftingClock rtc(-120);
+
+    for (int i = 0; i < 8; i++) {
+        clock.synchronise(rtc.local(), rtc.reference(), 1000);
+        rtc.advance(MS_PER_HOUR);
+    }
+
+    TestClock restored(MAX_DRIFT);
+    restored.restore(clock.anchor(), clock.offset(), clock.drift(), clock.drift_uncertainty(), 1000);
+
+    rtc.advance(10 * MS_PER_HOUR);
+    EXPECT_EQ(restored.reference(rtc.local()), clock.reference(rtc.local()));
+    /* the drift is known after the reset, the error does not grow at the maximum drift */
+    EXPECT_LE(restored.error_bound(rtc.local()), clock.error_bound(rtc.local()));
+    EXPECT_LT(restored.error_bound(rtc.local()), 1000 + (10 * MS_PER_HOUR / 1000000) * (MAX_DRIFT / 1000));
+}
+
+class TestCurrentTimeService : public testing::Test {
+protected:
+    BLE *ble;
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+
+    std::unique_ptr<CurrentTimeService> current_time_service;
+
+    void SetUp()
+    {
+        ble = &BLE::Instance();
+
+        current_time_service = std::make_unique<CurrentTimeService>(
+            *ble, event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        );
+    }
+
+    void TearDown()
+    {
+        ble::delete_mocks();
+    }
+
+    GattServerMock::characteristic_t &current_time_char()
+    {
+        return gatt_server_mock().services[0].characteristics[0];
+    }
+
+    void simulate_updates_enabled_event(connection_handle_t connection_handle)
+    {
+        GattUpdatesEnabledCallbackParams params {
+            connection_handle,
+            static_cast<GattAttribute::Handle_t>(current_time_char().value_handle + 1),
+            current_time_char().value_handle
+        };
+
+        chainable_gatt_server_event_handler.onUpdatesEnabled(params);
+    }
+
+    void simulate_updates_disabled_event(connection_handle_t connection_handle)
+    {
+        GattUpdatesDisabledCallbackParams params {
+            connection_handle,
+            static_cast<GattAttribute::Handle_t>(current_time_char().value_handle + 1),
+            current_time_char().value_handle
+        };
+
+        chainable_gatt_server_event_handler.onUpdatesDisabled(params);
+    }
+
+    void simulate_disconnection_event(connection_handle_t connection_handle)
+    {
+        DisconnectionCompleteEvent disconnection_complete_event(
+            connection_handle,
+            disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION
+        );
+
+        chainable_gap_event_handler.onDisconnectionComplete(disconnection_complete_event);
+    }
+
+    GattAuthCallbackReply_t simulate_read_event(uint8_t *value)
+    {
+        GattReadAuthCallbackParams read_request {
+            0,
+            current_time_char().value_handle,
+            0,
+            0,
+            nullptr,
+            AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        current_time_char().read_cb(&read_request);
+
+        if (read_request.authorizationReply == AUTH_CALLBACK_REPLY_SUCCESS) {
+            EXPECT_EQ(read_request.len, 10);
+            memcpy(value, read_request.data, read_request.len);
+        }
+
+        return read_request.authorizationReply;
+    }
+
+    GattAuthCallbackReply_t simulate_write_event(const uint8_t *data, uint16_t len)
+    {
+        GattWriteAuthCallbackParams write_request {
+            0,
+            current_time_char().value_handle,
+            0,
+            len,
+            data,
+            AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        current_time_char().write_cb(&write_request);
+
+        return write_request.authorizationReply;
+    }
+};
+
+TEST_F(TestCurrentTimeService, init)
+{
+    EXPECT_CALL(gatt_server_mock(), addService(Property(&GattService::getUUID, GattService::UUID_CURRENT_TIME_SERVICE)))
+            .Times(1);
+
+    current_time_service->init();
+
+    ASSERT_EQ(gatt_server_mock().services[0].characteristics.size(), 1);
+    ASSERT_EQ(current_time_char().uuid, GattCharacteristic::UUID_CURRENT_TIME_CHAR);
+    ASSERT_TRUE(current_time_char().read_cb);
+    ASSERT_TRUE(current_time_char().write_cb);
+}
+
+TEST_F(TestCurrentTimeService, read_after_set_time)
+{
+    current_time_service->init();
+
+    /* Wednesday 2021-07-14 12:00:00 */
+    current_time_service->set_time(1626264000, 0);
+
+    uint8_t value[10];
+    ASSERT_EQ(simulate_read_event(value), AUTH_CALLBACK_REPLY_SUCCESS);
+
+    EXPECT_EQ(value[0] | (value[1] << 8), 2021);
+    EXPECT_EQ(value[2], 7);
+    EXPECT_EQ(value[3], 14);
+    EXPECT_EQ(value[4], 12);
+    EXPECT_EQ(value[5], 0);
+    EXPECT_EQ(value[7], 3);
+}
+
+TEST_F(TestCurrentTimeService, write_sets_time)
+{
+    current_time_service->init();
+
+    /* Thursday 2021-07-15 08:30:15 */
+    const uint8_t data[] = { 0xE5, 0x07, 7, 15, 8, 30, 15, 4, 0, CurrentTimeService::MANUAL_TIME_UPDATE };
+
+    ASSERT_EQ(simulate_write_event(data, sizeof(data)), AUTH_CALLBACK_REPLY_SUCCESS);
+
+    time_t time = current_time_service->get_time();
+    EXPECT_GE(time, 1626337815);
+    EXPECT_LE(time, 1626337816);
+}
+
+TEST_F(TestCurrentTimeService, write_sets_fractions)
+{
+    current_time_service->init();
+
+    /* Thursday 2021-07-15 08:30:15 and 192/256 */
+    const uint8_t data[] = { 0xE5, 0x07, 7, 15, 8, 30, 15, 4, 192, CurrentTimeService::MANUAL_TIME_UPDATE };
+
+    /* the fractions are no longer ignored */
+    ASSERT_EQ(simulate_write_event(data, sizeof(data)), AUTH_CALLBACK_REPLY_SUCCESS);
+
+    /* the kernel clock does not advance in the unit tests */
+    uint8_t value[10];
+    ASSERT_EQ(simulate_read_event(value), AUTH_CALLBACK_REPLY_SUCCESS);
+    EXPECT_EQ(value[6], 15);
+    EXPECT_EQ(value[8], 192);
+
+    /* known to 1/256 of a second instead of a whole second */
+    EXPECT_LT(current_time_service->get_time_error_bound(), std::chrono::milliseconds(10));
+}
+
+TEST_F(TestCurrentTimeService, fractions_round_trip)
+{
+    current_time_service->init();
+
+    for (unsigned fractions = 0; fractions < 256; fractions++) {
+        current_time_service->set_time(1626264000, fractions, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+        uint8_t fractions256 = 0;
+        ASSERT_EQ(current_time_service->get_time(fractions256), 1626264000);
+        ASSERT_EQ(fractions256, fractions);
+    }
+}
+
+TEST_F(TestCurrentTimeService, notification_carries_fractions)
+{
+    current_time_service->init();
+
+    simulate_updates_enabled_event(0);
+
+    uint8_t notified_fractions = 0;
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .WillOnce(testing::Invoke([&](GattAttribute::Handle_t, const uint8_t *value, uint16_t, bool) {
+                notified_fractions = value[8];
+                return BLE_ERROR_NONE;
+            }));
+
+    current_time_service->set_time(1626264000, 64, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+
+    EXPECT_EQ(notified_fractions, 64);
+}
+
+TEST_F(TestCurrentTimeService, time_error_bound)
+{
+    current_time_service->init();
+
+    EXPECT_EQ(current_time_service->get_time_error_bound(), std::chrono::milliseconds::max());
+
+    current_time_service->set_time(1626264000, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+
+    /* right after setting the time the error is the resolution of the real time clock */
+    EXPECT_GE(current_time_service->get_time_error_bound(), std::chrono::milliseconds(1000));
+    EXPECT_LE(current_time_service->get_time_error_bound(), std::chrono::milliseconds(1500));
+    EXPECT_EQ(current_time_service->get_drift(), 0);
+}
+
+TEST_F(TestCurrentTimeService, write_calls_event_handler)
+{
+    struct TimeHandler : CurrentTimeService::EventHandler {
+        void on_current_time_changed(time_t current_time, uint8_t adjust_reason) override
+        {
+            this->current_time = current_time;
+            this->adjust_reason = adjust_reason;
+        }
+
+        time_t current_time = 0;
+        uint8_t adjust_reason = 0;
+    } handler;
+
+    current_time_service->init();
+    current_time_service->set_event_handler(&handler);
+
+    /* Thursday 2021-07-15 08:30:15 */
+    const uint8_t data[] = { 0xE5, 0x07, 7, 15, 8, 30, 15, 4, 0, CurrentTimeService::CHANGE_OF_DST };
+
+    ASSERT_EQ(simulate_write_event(data, sizeof(data)), AUTH_CALLBACK_REPLY_SUCCESS);
+    EXPECT_EQ(handler.current_time, 1626337815);
+    EXPECT_EQ(handler.adjust_reason, CurrentTimeService::CHANGE_OF_DST);
+}
+
+/* the handler is the service itself, its event is called without a vtable */
+class RecordingCurrentTimeService : public BasicCurrentTimeService<RecordingCurrentTimeService> {
+public:
+    using BasicCurrentTimeService::BasicCurrentTimeService;
+
+    time_t current_time = 0;
+    int changes = 0;
+
+private:
+    friend class BasicCurrentTimeService<RecordingCurrentTimeService>;
+
+    void on_current_time_changed(time_t current_time, uint8_t)
+    {
+        this->current_time = current_time;
+        changes++;
+    }
+};
+
+TEST_F(TestCurrentTimeService, static_handler)
+{
+    RecordingCurrentTimeService service(*ble, event_queue, chainable_gap_event_handler,
+                                        chainable_gatt_server_event_handler);
+    ASSERT_EQ(service.init(), BLE_ERROR_NONE);
+
+    /* Thursday 2021-07-15 08:30:15 */
+    const uint8_t data[] = { 0xE5, 0x07, 7, 15, 8, 30, 15, 4, 0, 0 };
+
+    ASSERT_EQ(simulate_write_event(data, sizeof(data)), AUTH_CALLBACK_REPLY_SUCCESS);
+    EXPECT_EQ(service.changes, 1);
+    EXPECT_EQ(service.current_time, 1626337815);
+
+    /* rejected values are not reported */
+    ASSERT_EQ(simulate_write_event(data, 9), AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH);
+    EXPECT_EQ(service.changes, 1);
+}
+
+TEST_F(TestCurrentTimeService, write_invalid_length)
+{
+    current_time_service->init();
+
+    const uint8_t data[10] = { 0xE5, 0x07, 7, 15, 8, 30, 15, 4, 0, 0 };
+
+    ASSERT_EQ(simulate_write_event(data, 9), AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH);
+
+    /* a shorter value is rejected before being decoded, which would read past its end */
+    const uint8_t year[2] = { 0xE5, 0x07 };
+
+    ASSERT_EQ(simulate_write_event(year, sizeof(year)), AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH);
+}
+
+TEST_F(TestCurrentTimeService, no_periodic_update_without_subscribers)
+{
+    current_time_service->init();
+
+    EXPECT_CALL(gatt_server_mock(), write(_, _, _, _))
+            .Times(0);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    /* nothing should be scheduled while no client listens */
+    ASSERT_EQ(event_queue.size(), 0);
+
+    event_queue.dispatch(120000);
+}
+
+TEST_F(TestCurrentTimeService, periodic_update_aligned_to_minute)
+{
+    current_time_service->init();
+
+    /* 30 seconds before the minute changes */
+    current_time_service->set_time(1626264030, 0);
+
+    simulate_updates_enabled_event(0);
+
+    ASSERT_EQ(event_queue.size(), 1);
+
+    /* allow one second for the real time clock ticking while the test runs */
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .Times(0);
+
+    event_queue.dispatch(28500);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    event_queue.dispatch(2000);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /*
+     * the following update comes a whole period later; the real time clock does not follow the event
+     * queue double so it carries the same value, which is not sent again
+     */
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .Times(0);
+
+    event_queue.dispatch(58000);
+    ASSERT_EQ(current_time_service->get_suppressed_update_count(), 0);
+
+    event_queue.dispatch(2000);
+    ASSERT_EQ(current_time_service->get_suppressed_update_count(), 1);
+}
+
+TEST_F(TestCurrentTimeService, periodic_update_with_pool_exhausted)
+{
+    current_time_service->init();
+    current_time_service->set_time(1626264030, 0);
+
+    /* the application took every event of the pool of the event queue */
+    event_queue.set_pool_size(0);
+
+    simulate_updates_enabled_event(0);
+
+    /* the periodic update does not use the pool, it is still sent at the minute boundary */
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    event_queue.dispatch(30500);
+    ASSERT_EQ(event_queue.size(), 1);
+}
+
+TEST_F(TestCurrentTimeService, unsubscribe_stops_updates)
+{
+    current_time_service->init();
+
+    simulate_updates_enabled_event(0);
+    simulate_updates_enabled_event(1);
+
+    ASSERT_EQ(event_queue.size(), 1);
+
+    simulate_updates_disabled_event(0);
+
+    /* a subscriber remains */
+    ASSERT_EQ(event_queue.size(), 1);
+
+    simulate_updates_disabled_event(1);
+
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestCurrentTimeService, disconnection_removes_subscriber)
+{
+    current_time_service->init();
+
+    simulate_updates_enabled_event(0);
+
+    ASSERT_EQ(event_queue.size(), 1);
+
+    simulate_disconnection_event(0);
+
+    ASSERT_EQ(event_queue.size(), 0);
+
+    EXPECT_CALL(gatt_server_mock(), write(_, _, _, _))
+            .Times(0);
+
+    event_queue.dispatch(120000);
+}
+
+TEST_F(TestCurrentTimeService, set_time_notifies_subscribers)
+{
+    current_time_service->init();
+
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    /* the periodic update is re-armed rather than duplicated */
+    ASSERT_EQ(event_queue.size(), 1);
+}
+
+TEST_F(TestCurrentTimeService, unchanged_value_not_sent)
+{
+    current_time_service->init();
+
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    EXPECT_EQ(current_time_service->get_update_count(), 1);
+    EXPECT_EQ(current_time_service->get_suppressed_update_count(), 1);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /* a new subscriber gets the value even though it did not change */
+    simulate_updates_enabled_event(1);
+
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    EXPECT_EQ(current_time_service->get_update_count(), 2);
+}
+
+TEST_F(TestCurrentTimeService, coalesced_updates_merge_adjust_reasons)
+{
+    current_time_service->init();
+    current_time_service->set_update_coalescing_window(std::chrono::milliseconds(100));
+
+    simulate_updates_enabled_event(0);
+
+    uint8_t notified_adjust_reason = 0;
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .WillOnce(testing::Invoke([&](GattAttribute::Handle_t, const uint8_t *value, uint16_t, bool) {
+                notified_adjust_reason = value[9];
+                return BLE_ERROR_NONE;
+            }));
+
+    /* a move to another time zone in summer, then the time entered by hand */
+    current_time_service->set_time(1626264000, CurrentTimeService::CHANGE_OF_TIME_ZONE);
+    current_time_service->set_time(1626267600, CurrentTimeService::CHANGE_OF_DST);
+    current_time_service->set_time(1626267605, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    /* the time is set at once, the notification waits for the end of the window */
+    EXPECT_EQ(current_time_service->get_time(), 1626267605);
+    EXPECT_EQ(current_time_service->get_update_count(), 0);
+    /* only the coalesced update is pending, the periodic update is re-armed after it */
+    ASSERT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(100);
+
+    EXPECT_EQ(current_time_service->get_update_count(), 1);
+    EXPECT_EQ(notified_adjust_reason, CurrentTimeService::CHANGE_OF_TIME_ZONE | CurrentTimeService::CHANGE_OF_DST |
+                                      CurrentTimeService::MANUAL_TIME_UPDATE);
+    ASSERT_EQ(event_queue.size(), 1);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /* the following burst starts from no adjust reason */
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, _))
+            .WillOnce(testing::Invoke([&](GattAttribute::Handle_t, const uint8_t *value, uint16_t, bool) {
+                notified_adjust_reason = value[9];
+                return BLE_ERROR_NONE;
+            }));
+
+    current_time_service->set_time(1626267700, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+    event_queue.dispatch(100);
+
+    EXPECT_EQ(notified_adjust_reason, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+}
+
+TEST_F(TestCurrentTimeService, coalesced_update_dropped_without_subscribers)
+{
+    current_time_service->init();
+    current_time_service->set_update_coalescing_window(std::chrono::milliseconds(100));
+
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(_, _, _, _))
+            .Times(0);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    simulate_disconnection_event(0);
+
+    ASSERT_EQ(event_queue.size(), 0);
+
+    event_queue.dispatch(120000);
+}
+
+
+class TestCurrentTimeServiceAllocations : public TestCurrentTimeService {
+protected:
+    /* Thursday 2021-07-15 08:30:15 */
+    const uint8_t data[10] = { 0xE5, 0x07, 7, 15, 8, 30, 15, 4, 0, CurrentTimeService::MANUAL_TIME_UPDATE };
+
+    /* the GattServer mock allocates to record each call, measure that once */
+    size_t value_update_allocations = 0;
+
+    void SetUp()
+    {
+        TestCurrentTimeService::SetUp();
+
+        current_time_service->init();
+
+        EXPECT_CALL(gatt_server_mock(), write(_, _, _, _))
+                .Times(2);
+        ble->gattServer().write(current_time_char().value_handle, data, sizeof(data));
+        value_update_allocations = allocation_tracker::allocations_in([this] {
+            ble->gattServer().write(current_time_char().value_handle, data, sizeof(data));
+        });
+    }
+
+    /*
+     * The GattServer mock is the only double allowed to allocate: expect exactly @p writes values pushed and
+     * return the allocations they account for, any other allocation fails the test.
+     */
+    size_t expect_value_updates(int writes)
+    {
+        EXPECT_CALL(gatt_server_mock(), write(_, _, _, _))
+                .Times(writes);
+        return writes * value_update_allocations;
+    }
+};
+
+TEST_F(TestCurrentTimeServiceAllocations, read)
+{
+    uint8_t value[10];
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_read_event(value); }), 0);
+}
+
+TEST_F(TestCurrentTimeServiceAllocations, write)
+{
+    size_t whitelisted = expect_value_updates(0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_write_event(data, sizeof(data)); }), whitelisted);
+
+    /* with a subscriber the value is pushed and the periodic update moves to the new minute boundary */
+    simulate_updates_enabled_event(0);
+    whitelisted = expect_value_updates(1);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_write_event(data, sizeof(data)); }), whitelisted);
+}
+
+TEST_F(TestCurrentTimeServiceAllocations, coalesced_write)
+{
+    current_time_service->set_update_coalescing_window(std::chrono::milliseconds(100));
+    simulate_updates_enabled_event(0);
+
+    /* a burst of writes posts the coalesced update once and pushes nothing */
+    size_t whitelisted = expect_value_updates(0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] {
+        for (int i = 0; i < 3; i++) {
+            simulate_write_event(data, sizeof(data));
+        }
+    }), whitelisted);
+
+    /* the value is pushed once and the periodic update posted once */
+    whitelisted = expect_value_updates(1);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { event_queue.dispatch(100); }), whitelisted);
+}
+
+TEST_F(TestCurrentTimeServiceAllocations, subscription)
+{
+    expect_value_updates(0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_updates_enabled_event(0); }), 0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_updates_enabled_event(1); }), 0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_updates_disabled_event(1); }), 0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_disconnection_event(0); }), 0);
+}
+
+TEST_F(TestCurrentTimeServiceAllocations, periodic_update)
+{
+    simulate_updates_enabled_event(0);
+
+    /* each update pushes the value and posts the next one */
+    const size_t whitelisted = expect_value_updates(1);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { event_queue.dispatch(60000); }), whitelisted);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ble;
+
+/* Thursday 2021-07-15 08:30:15 */
+static const time_t HOST_TIME = 1626337815;
+
+/* built with the command mailbox enabled, it holds four times */
+class TestCurrentTimeServiceCommandMailbox : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+
+    std::unique_ptr<CurrentTimeService> current_time_service;
+
+    void SetUp()
+    {
+        current_time_service = std::make_unique<CurrentTimeService>(
+            BLE::Instance(), event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        );
+        current_time_service->init();
+    }
+
+    void TearDown()
+    {
+        current_time_service.reset();
+        ble::delete_mocks();
+    }
+};
+
+TEST_F(TestCurrentTimeServiceCommandMailbox, time_set_from_event_queue)
+{
+    ASSERT_TRUE(current_time_service->post_set_time(HOST_TIME, CurrentTimeService::MANUAL_TIME_UPDATE));
+
+    // The service is left alone until the event queue runs
+    EXPECT_NE(current_time_service->get_time(), HOST_TIME);
+
+    event_queue.dispatch(0);
+
+    /* the kernel clock does not advance in the unit tests, the command did not wait */
+    EXPECT_EQ(current_time_service->get_time(), HOST_TIME);
+    EXPECT_EQ(current_time_service->get_adjust_reason(), CurrentTimeService::MANUAL_TIME_UPDATE);
+}
+
+TEST_F(TestCurrentTimeServiceCommandMailbox, time_set_with_fractions)
+{
+    ASSERT_TRUE(current_time_service->post_set_time(HOST_TIME, 128, CurrentTimeService::MANUAL_TIME_UPDATE));
+
+    event_queue.dispatch(0);
+
+    uint8_t fractions256 = 0;
+    EXPECT_EQ(current_time_service->get_time(fractions256), HOST_TIME);
+    EXPECT_EQ(fractions256, 128);
+}
+
+TEST_F(TestCurrentTimeServiceCommandMailbox, full_mailbox_refuses_times)
+{
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(current_time_service->post_set_time(HOST_TIME + i, CurrentTimeService::MANUAL_TIME_UPDATE));
+    }
+
+    ASSERT_FALSE(current_time_service->post_set_time(HOST_TIME + 4, CurrentTimeService::MANUAL_TIME_UPDATE));
+
+    event_queue.dispatch(0);
+
+    EXPECT_EQ(current_time_service->get_time(), HOST_TIME + 3);
+}
+
+TEST_F(TestCurrentTimeServiceCommandMailbox, times_from_concurrent_threads)
+{
+    // A GNSS thread and a user interface thread both set the time
+    std::vector<std::thread> producers;
+    producers.emplace_back([this] {
+        EXPECT_TRUE(current_time_service->post_set_time(HOST_TIME, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE));
+        EXPECT_TRUE(current_time_service->post_set_time(HOST_TIME + 1, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE));
+    });
+    producers.emplace_back([this] {
+        EXPECT_TRUE(current_time_service->post_set_time(HOST_TIME + 10, CurrentTimeService::MANUAL_TIME_UPDATE));
+        EXPECT_TRUE(current_time_service->post_set_time(HOST_TIME + 11, CurrentTimeService::MANUAL_TIME_UPDATE));
+    });
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    event_queue.dispatch(0);
+
+    // The time and adjust reason applied last come from the same command, the last one of either thread
+    if (current_time_service->get_adjust_reason() == CurrentTimeService::MANUAL_TIME_UPDATE) {
+        EXPECT_EQ(current_time_service->get_time(), HOST_TIME + 11);
+    } else {
+        EXPECT_EQ(current_time_service->get_adjust_reason(), CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+        EXPECT_EQ(current_time_service->get_time(), HOST_TIME + 1);
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <memory>
+#include <vector>
+
+using namespace ble;
+
+/* an application handler recording where it is called from, it may take its time writing to a slow log */
+struct RecordingTimeHandler : CurrentTimeService::EventHandler {
+    void on_current_time_changed(time_t current_time, uint8_t adjust_reason) override
+    {
+        calls_from_write_callback += in_write_callback;
+        calls_from_dispatch += in_dispatch;
+        times.push_back(current_time);
+        adjust_reasons.push_back(adjust_reason);
+    }
+
+    bool in_write_callback = false;
+    bool in_dispatch = false;
+    int calls_from_write_callback = 0;
+    int calls_from_dispatch = 0;
+    std::vector<time_t> times;
+    std::vector<uint8_t> adjust_reasons;
+};
+
+/* built with deferred events enabled, two time changes fit in the mailbox */
+class TestCurrentTimeServiceDeferredEvents : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+    RecordingTimeHandler handler;
+
+    std::unique_ptr<CurrentTimeService> current_time_service;
+
+    void SetUp()
+    {
+        current_time_service = std::make_unique<CurrentTimeService>(
+            BLE::Instance(), event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        );
+        current_time_service->init();
+        current_time_service->set_event_handler(&handler);
+    }
+
+    void TearDown()
+    {
+        current_time_service.reset();
+        ble::delete_mocks();
+    }
+
+    GattAuthCallbackReply_t simulate_write_event(uint8_t seconds, uint8_t adjust_reason)
+    {
+        /* Thursday 2021-07-15 08:30 */
+        const uint8_t data[] = { 0xE5, 0x07, 7, 15, 8, 30, seconds, 4, 0, adjust_reason };
+
+        GattServerMock::characteristic_t &current_time_char = gatt_server_mock().services[0].characteristics[0];
+
+        GattWriteAuthCallbackParams write_request {
+            0,
+            current_time_char.value_handle,
+            0,
+            sizeof(data),
+            data,
+            AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        handler.in_write_callback = true;
+        current_time_char.write_cb(&write_request);
+        handler.in_write_callback = false;
+
+        return write_request.authorizationReply;
+    }
+
+    void dispatch()
+    {
+        handler.in_dispatch = true;
+        event_queue.dispatch(0);
+        handler.in_dispatch = false;
+    }
+};
+
+TEST_F(TestCurrentTimeServiceDeferredEvents, handler_called_from_event_queue)
+{
+    ASSERT_EQ(simulate_write_event(15, CurrentTimeService::MANUAL_TIME_UPDATE), AUTH_CALLBACK_REPLY_SUCCESS);
+
+    // The time is set right away
+    EXPECT_EQ(current_time_service->get_time(), 1626337815);
+
+    // but the application hears of it from the event queue
+    EXPECT_TRUE(handler.times.empty());
+
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handler.times.size(), 1);
+    EXPECT_EQ(handler.times[0], 1626337815);
+    EXPECT_EQ(handler.adjust_reasons[0], CurrentTimeService::MANUAL_TIME_UPDATE);
+}
+
+TEST_F(TestCurrentTimeServiceDeferredEvents, handler_not_called_from_write_callback)
+{
+    ASSERT_EQ(simulate_write_event(15, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE),
+              AUTH_CALLBACK_REPLY_SUCCESS);
+
+    dispatch();
+
+    // Called inline, the handler would have held the reply for as long as it takes
+    EXPECT_EQ(handler.calls_from_write_callback, 0);
+    EXPECT_EQ(handler.calls_from_dispatch, 1);
+    ASSERT_EQ(handler.times.size(), 1);
+}
+
+TEST_F(TestCurrentTimeServiceDeferredEvents, burst_of_writes_not_reported_from_write_callback)
+{
+    for (uint8_t seconds = 10; seconds < 15; seconds++) {
+        ASSERT_EQ(simulate_write_event(seconds, CurrentTimeService::MANUAL_TIME_UPDATE), AUTH_CALLBACK_REPLY_SUCCESS);
+    }
+
+    // The mailbox holds two changes: the others are dropped rather than reported from the write callback
+    EXPECT_EQ(handler.calls_from_write_callback, 0);
+    EXPECT_TRUE(handler.times.empty());
+    EXPECT_EQ(current_time_service->get_dropped_event_count(), 3);
+
+    // while the time itself follows every write
+    EXPECT_EQ(current_time_service->get_time(), 1626337814);
+
+    dispatch();
+
+    EXPECT_EQ(handler.calls_from_dispatch, 2);
+    ASSERT_EQ(handler.times.size(), 2);
+    EXPECT_EQ(handler.times[0], 1626337810);
+    EXPECT_EQ(handler.times[1], 1626337811);
+}
+
+TEST_F(TestCurrentTimeServiceDeferredEvents, pending_changes_dropped_with_service)
+{
+    simulate_write_event(15, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    current_time_service.reset();
+
+    event_queue.dispatch(0);
+
+    EXPECT_TRUE(handler.times.empty());
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <memory>
+
+using namespace ble;
+using ::testing::_;
+using ::testing::Return;
+
+/* built with indications enabled */
+class TestCurrentTimeServiceIndications : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+
+    std::unique_ptr<CurrentTimeService> current_time_service;
+
+    void SetUp()
+    {
+        current_time_service = std::make_unique<CurrentTimeService>(
+            BLE::Instance(), event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        );
+        current_time_service->init();
+
+        /* the value held by the stack is not sent anywhere */
+        EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, true))
+                .Times(testing::AnyNumber());
+    }
+
+    void TearDown()
+    {
+        current_time_service.reset();
+        ble::delete_mocks();
+    }
+
+    GattServerMock::characteristic_t &current_time_char()
+    {
+        return gatt_server_mock().services[0].characteristics[0];
+    }
+
+    void simulate_updates_enabled_event(connection_handle_t connection_handle)
+    {
+        GattUpdatesEnabledCallbackParams params {
+            connection_handle,
+            static_cast<GattAttribute::Handle_t>(current_time_char().value_handle + 1),
+            current_time_char().value_handle
+        };
+
+        chainable_gatt_server_event_handler.onUpdatesEnabled(params);
+    }
+
+    void simulate_confirmation_received_event(connection_handle_t connection_handle)
+    {
+        GattConfirmationReceivedCallbackParams params {
+            connection_handle,
+            current_time_char().value_handle,
+            current_time_char().value_handle
+        };
+
+        chainable_gatt_server_event_handler.onConfirmationReceived(params);
+    }
+
+    void simulate_data_sent_event(connection_handle_t connection_handle)
+    {
+        GattDataSentCallbackParams params {
+            connection_handle,
+            current_time_char().value_handle
+        };
+
+        chainable_gatt_server_event_handler.onDataSent(params);
+    }
+
+    void simulate_disconnection_event(connection_handle_t connection_handle)
+    {
+        DisconnectionCompleteEvent disconnection_complete_event(
+            connection_handle,
+            disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION
+        );
+
+        chainable_gap_event_handler.onDisconnectionComplete(disconnection_complete_event);
+    }
+};
+
+TEST_F(TestCurrentTimeServiceIndications, init)
+{
+    EXPECT_TRUE(current_time_char().properties & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY);
+    EXPECT_TRUE(current_time_char().properties & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE);
+}
+
+TEST_F(TestCurrentTimeServiceIndications, update_sent_to_each_subscriber)
+{
+    simulate_updates_enabled_event(0);
+    simulate_updates_enabled_event(1);
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(1);
+    EXPECT_CALL(gatt_server_mock(), write(1, current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    EXPECT_EQ(current_time_service->get_update_count(), 1);
+}
+
+TEST_F(TestCurrentTimeServiceIndications, newest_update_sent_on_confirmation)
+{
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /* the first update is not confirmed yet, the following ones replace each other */
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, true))
+            .Times(testing::AnyNumber());
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(0);
+
+    current_time_service->set_time(1626264060, CurrentTimeService::CHANGE_OF_TIME_ZONE);
+    current_time_service->set_time(1626267660, CurrentTimeService::CHANGE_OF_DST);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /* the confirmation releases the newest time, carrying the reasons of both updates */
+    uint8_t indicated[10] = {};
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .WillOnce(testing::Invoke([&](connection_handle_t, GattAttribute::Handle_t, const uint8_t *value, uint16_t, bool) {
+                memcpy(indicated, value, sizeof(indicated));
+                return BLE_ERROR_NONE;
+            }));
+
+    simulate_confirmation_received_event(0);
+
+    /* Wednesday 2021-07-14 13:01:00 */
+    EXPECT_EQ(indicated[4], 13);
+    EXPECT_EQ(indicated[5], 1);
+    EXPECT_EQ(indicated[9], CurrentTimeService::CHANGE_OF_TIME_ZONE | CurrentTimeService::CHANGE_OF_DST);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /* nothing is left pending */
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(0);
+
+    simulate_confirmation_received_event(0);
+}
+
+TEST_F(TestCurrentTimeServiceIndications, slow_subscriber_does_not_hold_back_others)
+{
+    simulate_updates_enabled_event(0);
+    simulate_updates_enabled_event(1);
+
+    EXPECT_CALL(gatt_server_mock(), write(_, current_time_char().value_handle, _, 10, _))
+            .Times(2);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /* connection 1 confirms, connection 0 does not */
+    simulate_confirmation_received_event(1);
+
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, true))
+            .Times(testing::AnyNumber());
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(0);
+    EXPECT_CALL(gatt_server_mock(), write(1, current_time_char().value_handle, _, 10, _))
+            .Times(3);
+
+    for (int i = 1; i <= 3; i++) {
+        current_time_service->set_time(1626264000 + i * 60, CurrentTimeService::MANUAL_TIME_UPDATE);
+        simulate_confirmation_received_event(1);
+    }
+}
+
+TEST_F(TestCurrentTimeServiceIndications, notification_subscriber_completes_on_data_sent)
+{
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(2);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+    current_time_service->set_time(1626264060, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    /* a client that enabled notifications gets the pending time once the first one is sent */
+    simulate_data_sent_event(0);
+}
+
+TEST_F(TestCurrentTimeServiceIndications, failed_write_retried)
+{
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .WillOnce(Return(BLE_ERROR_NO_MEM))
+            .WillOnce(Return(BLE_ERROR_NO_MEM))
+            .WillOnce(Return(BLE_ERROR_NONE));
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    /* the retry is posted once, next to the periodic update */
+    ASSERT_EQ(event_queue.size(), 2);
+
+    event_queue.dispatch(100);
+    event_queue.dispatch(100);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    /* sent, nothing else to retry */
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(0);
+
+    event_queue.dispatch(1000);
+}
+
+TEST_F(TestCurrentTimeServiceIndications, disconnection_drops_pending_update)
+{
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .WillRepeatedly(Return(BLE_ERROR_NO_MEM));
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    simulate_disconnection_event(0);
+
+    ASSERT_EQ(event_queue.size(), 0);
+
+    /* the connection handle comes back with a new client, which starts with nothing pending */
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(0);
+
+    simulate_confirmation_received_event(0);
+}
+
+TEST_F(TestCurrentTimeServiceIndications, resubscription_waits_for_confirmation)
+{
+    simulate_updates_enabled_event(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    GattUpdatesDisabledCallbackParams params {
+        0,
+        static_cast<GattAttribute::Handle_t>(current_time_char().value_handle + 1),
+        current_time_char().value_handle
+    };
+    chainable_gatt_server_event_handler.onUpdatesDisabled(params);
+    simulate_updates_enabled_event(0);
+
+    /* only one indication may be outstanding on a connection */
+    EXPECT_CALL(gatt_server_mock(), write(current_time_char().value_handle, _, 10, true))
+            .Times(testing::AnyNumber());
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(0);
+
+    current_time_service->set_time(1626264060, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    EXPECT_CALL(gatt_server_mock(), write(0, current_time_char().value_handle, _, 10, _))
+            .Times(1);
+
+    simulate_confirmation_received_event(0);
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+#include "ble-service-current-time/DstTable.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+
+using namespace ble;
+
+/* the tables are generated at compile time, check a year of each rule there */
+using DstTable2021 = DstTable<2021, 1>;
+
+constexpr DstTable2021 EU_2021(DstRules::EU, 60);
+static_assert(EU_2021.transition(0) == 1616893200, "2021-03-28 01:00 UTC");
+static_assert(EU_2021.transition(1) == 1635642000, "2021-10-31 01:00 UTC");
+
+/* New York */
+constexpr DstTable2021 US_2021(DstRules::US, -300);
+static_assert(US_2021.transition(0) == 1615705200, "2021-03-14 02:00 EST");
+static_assert(US_2021.transition(1) == 1636264800, "2021-11-07 02:00 EDT");
+
+/* Sydney, daylight saving time ends before it starts */
+constexpr DstTable2021 AU_2021(DstRules::AU, 600);
+static_assert(AU_2021.end_first(), "Southern hemisphere");
+static_assert(AU_2021.transition(0) == 1617465600, "2021-04-04 03:00 AEDT");
+static_assert(AU_2021.transition(1) == 1633190400, "2021-10-03 02:00 AEST");
+
+static_assert(EU_2021.state(1616893199) == DstTable2021::STANDARD, "Last second of winter time");
+static_assert(EU_2021.state(1616893200) == DstTable2021::DAYLIGHT, "First second of summer time");
+static_assert(EU_2021.state(1609459199) == DstTable2021::UNKNOWN, "Out of the table");
+
+/* the C library tells the same from a POSIX TZ string, parsed at run time */
+template<size_t Years>
+static void expect_matches_libc(const DstTable<2021, Years> &table, const char *tz)
+{
+    const char *previous_tz = getenv("TZ");
+    std::string saved = previous_tz ? previous_tz : "";
+    setenv("TZ", tz, 1);
+    tzset();
+
+    using Table = DstTable<2021, Years>;
+
+    const int64_t first = 1609459200;
+    const int64_t last = first + static_cast<int64_t>(Years) * 365 * 86400;
+
+    /* every hour and a bit, so that the minutes of the transitions drift past the samples */
+    for (int64_t utc = first; utc < last; utc += 3607) {
+        time_t time = static_cast<time_t>(utc);
+        struct tm tm{};
+        ASSERT_TRUE(localtime_r(&time, &tm));
+
+        ASSERT_EQ(table.state(utc), tm.tm_isdst ? Table::DAYLIGHT : Table::STANDARD)
+            << tz << " at " << utc;
+    }
+
+    if (previous_tz) {
+        setenv("TZ", saved.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+
+TEST(TestDstTable, matches_libc)
+{
+    constexpr DstTable<2021, 79> eu(DstRules::EU, 60);
+    constexpr DstTable<2021, 79> us(DstRules::US, -300);
+    constexpr DstTable<2021, 79> au(DstRules::AU, 600);
+
+    expect_matches_libc(eu, "CET-1CEST,M3.5.0,M10.5.0/3");
+    expect_matches_libc(us, "EST5EDT,M3.2.0,M11.1.0");
+    expect_matches_libc(au, "AEST-10AEDT,M10.1.0,M4.1.0/3");
+}
+
+TEST(TestDstTable, local_state)
+{
+    /* 2021-03-28 02:00 CET, the clocks go forward to 03:00 CEST */
+    const int64_t spring = 1616893200 + 3600;
+    EXPECT_EQ(EU_2021.local_state(spring - 1), DstTable2021::STANDARD);
+    /* skipped times count as daylight saving time */
+    EXPECT_EQ(EU_2021.local_state(spring), DstTable2021::DAYLIGHT);
+    EXPECT_EQ(EU_2021.local_state(spring + 3600), DstTable2021::DAYLIGHT);
+
+    /* 2021-10-31 03:00 CEST, the clocks go back to 02:00 CET */
+    const int64_t autumn = 1635642000 + 7200;
+    /* the repeated hour counts as daylight saving time */
+    EXPECT_EQ(EU_2021.local_state(autumn - 3600), DstTable2021::DAYLIGHT);
+    EXPECT_EQ(EU_2021.local_state(autumn - 1), DstTable2021::DAYLIGHT);
+    EXPECT_EQ(EU_2021.local_state(autumn), DstTable2021::STANDARD);
+}
+
+TEST(TestDstTable, no_daylight_saving_time)
+{
+    constexpr DstTable2021 none(DstRules::NONE, 0);
+
+    EXPECT_EQ(none.state(1626264000), DstTable2021::STANDARD);
+    EXPECT_EQ(none.local_state(1626264000), DstTable2021::STANDARD);
+}
+
+/* built with time-zone 4 (UTC+1) and dst-rules EU */
+class TestCurrentTimeServiceLocalTime : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+
+    std::unique_ptr<CurrentTimeService> current_time_service;
+
+    void SetUp()
+    {
+        current_time_service = std::make_unique<CurrentTimeService>(
+            BLE::Instance(), event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        );
+        current_time_service->init();
+    }
+
+    void TearDown()
+    {
+        current_time_service.reset();
+        ble::delete_mocks();
+    }
+
+    GattServerMock::characteristic_t &characteristic(size_t index)
+    {
+        return gatt_server_mock().services[0].characteristics[index];
+    }
+
+    template<size_t Size>
+    void read(size_t index, uint8_t (&value)[Size])
+    {
+        GattReadAuthCallbackParams read_request {
+            0,
+            characteristic(index).value_handle,
+            0,
+            0,
+            nullptr,
+            AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        characteristic(index).read_cb(&read_request);
+
+        ASSERT_EQ(read_request.authorizationReply, AUTH_CALLBACK_REPLY_SUCCESS);
+        ASSERT_EQ(read_request.len, Size);
+        memcpy(value, read_request.data, Size);
+    }
+};
+
+TEST_F(TestCurrentTimeServiceLocalTime, init)
+{
+    ASSERT_EQ(gatt_server_mock().services[0].characteristics.size(), 3);
+    EXPECT_EQ(characteristic(1).uuid, GattCharacteristic::UUID_LOCAL_TIME_INFORMATION_CHAR);
+    EXPECT_EQ(characteristic(2).uuid, GattCharacteristic::UUID_REFERENCE_TIME_INFORMATION_CHAR);
+    EXPECT_TRUE(characteristic(1).read_cb);
+    EXPECT_TRUE(characteristic(2).read_cb);
+}
+
+TEST_F(TestCurrentTimeServiceLocalTime, local_time_information)
+{
+    uint8_t value[2];
+
+    /* Wednesday 2021-07-14 12:00:00, summer time */
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+    read(1, value);
+    EXPECT_EQ(static_cast<int8_t>(value[0]), 4);
+    EXPECT_EQ(value[1], 4);
+
+    /* Sunday 2021-12-26 12:00:00, winter time */
+    current_time_service->set_time(1640520000, CurrentTimeService::CHANGE_OF_DST);
+    read(1, value);
+    EXPECT_EQ(static_cast<int8_t>(value[0]), 4);
+    EXPECT_EQ(value[1], 0);
+
+    /* Saturday 2000-01-01 12:00:00, before the table */
+    current_time_service->set_time(946728000, CurrentTimeService::MANUAL_TIME_UPDATE);
+    EXPECT_EQ(current_time_service->get_dst_offset(), CurrentTimeService::DST_OFFSET_UNKNOWN);
+}
+
+TEST_F(TestCurrentTimeServiceLocalTime, reference_time_information)
+{
+    uint8_t value[4];
+
+    read(2, value);
+    EXPECT_EQ(value[0], CurrentTimeService::TIME_SOURCE_UNKNOWN);
+    EXPECT_EQ(value[1], 255);
+    EXPECT_EQ(value[2], 255);
+    EXPECT_EQ(value[3], 255);
+
+    current_time_service->set_time(1626264000, CurrentTimeService::MANUAL_TIME_UPDATE);
+    read(2, value);
+    EXPECT_EQ(value[0], CurrentTimeService::TIME_SOURCE_MANUAL);
+    /* a whole second is 8 steps of 125 ms */
+    EXPECT_EQ(value[1], 8);
+    /* the kernel clock does not advance in the unit tests */
+    EXPECT_EQ(value[2], 0);
+    EXPECT_EQ(value[3], 0);
+
+    current_time_service->set_time(1626264000, 64, CurrentTimeService::EXTERNAL_REFERENCE_TIME_UPDATE);
+    read(2, value);
+    EXPECT_EQ(value[0], CurrentTimeService::TIME_SOURCE_UNKNOWN);
+    EXPECT_EQ(value[1], 1);
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+#include "KVStoreFake.h"
+#include "kvstore_global_api/kvstore_global_api.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+
+using namespace ble;
+
+/* Wednesday 2021-07-14 12:00:00 */
+static const time_t HOST_TIME = 1626264000;
+
+static const int PERSIST_INTERVAL_MS = MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST_INTERVAL * 1000;
+
+class TestCurrentTimeServicePersistence : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+
+    std::unique_ptr<CurrentTimeService> current_time_service;
+
+    void SetUp()
+    {
+        kvstore_fake::reset();
+        boot();
+    }
+
+    void TearDown()
+    {
+        current_time_service.reset();
+        ble::delete_mocks();
+    }
+
+    /* the store outlives the service, as the flash outlives a reset of the device */
+    void boot()
+    {
+        current_time_service.reset();
+        ble::delete_mocks();
+
+        current_time_service = std::make_unique<CurrentTimeService>(
+            BLE::Instance(), event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        );
+        current_time_service->init();
+    }
+
+    /* the real time clock keeps running across the simulated reset, allow it to tick while the test runs */
+    void expect_time(time_t expected)
+    {
+        EXPECT_LE(std::abs(current_time_service->get_time() - expected), 1);
+    }
+};
+
+TEST_F(TestCurrentTimeServicePersistence, nothing_saved)
+{
+    EXPECT_EQ(kvstore_fake::writes(), 0);
+    expect_time(time(nullptr));
+    EXPECT_EQ(current_time_service->get_adjust_reason(), 0);
+    EXPECT_EQ(current_time_service->get_time_error_bound(), std::chrono::milliseconds::max());
+}
+
+TEST_F(TestCurrentTimeServicePersistence, time_available_after_reset)
+{
+    current_time_service->set_time(HOST_TIME, CurrentTimeService::MANUAL_TIME_UPDATE);
+    event_queue.dispatch(0);
+    EXPECT_EQ(kvstore_fake::writes(), 1);
+
+    boot();
+
+    /* no client had to write the time again */
+    expect_time(HOST_TIME);
+    EXPECT_EQ(current_time_service->get_adjust_reason(), CurrentTimeService::MANUAL_TIME_UPDATE);
+    EXPECT_LT(current_time_service->get_time_error_bound(), std::chrono::milliseconds::max());
+}
+
+TEST_F(TestCurrentTimeServicePersistence, saves_rate_limited)
+{
+    current_time_service->set_time(HOST_TIME, CurrentTimeService::MANUAL_TIME_UPDATE);
+    event_queue.dispatch(0);
+    current_time_service->set_time(HOST_TIME + 60, CurrentTimeService::CHANGE_OF_TIME_ZONE);
+    current_time_service->set_time(HOST_TIME + 3600, CurrentTimeService::CHANGE_OF_DST);
+
+    /* the first save is made as soon as the event queue runs, the following ones wait for the end of the interval */
+    EXPECT_EQ(kvstore_fake::writes(), 1);
+
+    event_queue.dispatch(PERSIST_INTERVAL_MS - 1);
+    EXPECT_EQ(kvstore_fake::writes(), 1);
+
+    /* and are merged into a single save of the last time set */
+    event_queue.dispatch(1);
+    EXPECT_EQ(kvstore_fake::writes(), 2);
+
+    /* nothing changed during the second interval, there is nothing to save at its end */
+    event_queue.dispatch(PERSIST_INTERVAL_MS);
+    EXPECT_EQ(kvstore_fake::writes(), 2);
+    EXPECT_EQ(event_queue.size(), 0);
+
+    boot();
+
+    expect_time(HOST_TIME + 3600);
+    EXPECT_EQ(current_time_service->get_adjust_reason(), CurrentTimeService::CHANGE_OF_DST);
+}
+
+TEST_F(TestCurrentTimeServicePersistence, deferred_save_on_destruction)
+{
+    current_time_service->set_time(HOST_TIME, CurrentTimeService::MANUAL_TIME_UPDATE);
+    event_queue.dispatch(0);
+    current_time_service->set_time(HOST_TIME + 60, CurrentTimeService::CHANGE_OF_TIME_ZONE);
+
+    /* the service saves what it deferred when it goes away */
+    boot();
+
+    EXPECT_EQ(kvstore_fake::writes(), 2);
+    expect_time(HOST_TIME + 60);
+}
+
+TEST_F(TestCurrentTimeServicePersistence, save_not_in_write_callback)
+{
+    /* Wednesday 2021-07-14 12:00:00 */
+    const uint8_t data[] = { 0xE5, 0x07, 7, 14, 12, 0, 0, 3, 0, CurrentTimeService::MANUAL_TIME_UPDATE };
+
+    GattServerMock::characteristic_t &current_time_char = gatt_server_mock().services[0].characteristics[0];
+
+    GattWriteAuthCallbackParams write_request {
+        0,
+        current_time_char.value_handle,
+        0,
+        sizeof(data),
+        data,
+        AUTH_CALLBACK_REPLY_SUCCESS
+    };
+
+    current_time_char.write_cb(&write_request);
+    ASSERT_EQ(write_request.authorizationReply, AUTH_CALLBACK_REPLY_SUCCESS);
+
+    /* the client is replied to without waiting for the flash */
+    EXPECT_EQ(kvstore_fake::writes(), 0);
+
+    event_queue.dispatch(0);
+    EXPECT_EQ(kvstore_fake::writes(), 1);
+
+    boot();
+
+    expect_time(HOST_TIME);
+}
+
+TEST_F(TestCurrentTimeServicePersistence, failed_save_retried)
+{
+    kvstore_fake::fail(true);
+
+    current_time_service->set_time(HOST_TIME, CurrentTimeService::MANUAL_TIME_UPDATE);
+    EXPECT_EQ(kvstore_fake::writes(), 0);
+
+    /* the save is retried at the end of each interval while the store fails */
+    event_queue.dispatch(PERSIST_INTERVAL_MS);
+    EXPECT_EQ(kvstore_fake::writes(), 0);
+
+    kvstore_fake::fail(false);
+
+    event_queue.dispatch(PERSIST_INTERVAL_MS);
+    EXPECT_EQ(kvstore_fake::writes(), 1);
+
+    /* and stops once it succeeded */
+    event_queue.dispatch(2 * PERSIST_INTERVAL_MS);
+    EXPECT_EQ(kvstore_fake::writes(), 1);
+    EXPECT_EQ(event_queue.size(), 0);
+
+    boot();
+
+    expect_time(HOST_TIME);
+}
+
+TEST_F(TestCurrentTimeServicePersistence, invalid_record_ignored)
+{
+    const uint8_t truncated[3] = { 1, 2, 3 };
+    kv_set(MBED_CONF_BLE_SERVICE_CURRENT_TIME_PERSIST_KEY, truncated, sizeof(truncated), 0);
+
+    boot();
+
+    expect_time(time(nullptr));
+}
+
+TEST_F(TestCurrentTimeServicePersistence, store_unavailable)
+{
+    kvstore_fake::fail(true);
+
+    current_time_service->set_time(HOST_TIME, CurrentTimeService::MANUAL_TIME_UPDATE);
+    expect_time(HOST_TIME);
+
+    boot();
+
+    /* the service works without the store, only the time is lost */
+    expect_time(time(nullptr));
+}
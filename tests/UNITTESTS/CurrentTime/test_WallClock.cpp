@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble/gatt/ChainableGattServerEventHandler.h"
+
+#include "ble-service-current-time/CurrentTimeService.h"
+#include "ble-service-current-time/WallClock.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ble;
+using namespace std::chrono;
+
+/* Wednesday 2021-07-14 12:00:00 */
+static const time_t HOST_TIME = 1626264000;
+
+static WallClock::time_point tick(int64_t ms)
+{
+    return WallClock::time_point(milliseconds(ms));
+}
+
+TEST(TestWallClock, stamp)
+{
+    WallClock wall_clock;
+
+    /* the kernel clock read 5000 ms at HOST_TIME + 0.25 s */
+    wall_clock.publish(5000, HOST_TIME * 1000LL + 250 - 5000, 0);
+
+    WallClock::Timestamp timestamp = wall_clock.stamp(tick(5000));
+    EXPECT_EQ(timestamp.seconds, HOST_TIME);
+    EXPECT_EQ(timestamp.fractions256, 64);
+
+    timestamp = wall_clock.stamp(tick(6750));
+    EXPECT_EQ(timestamp.seconds, HOST_TIME + 2);
+    EXPECT_EQ(timestamp.fractions256, 0);
+
+    EXPECT_EQ(wall_clock.to_ms(tick(5001)), HOST_TIME * 1000LL + 251);
+}
+
+TEST(TestWallClock, drift_corrected)
+{
+    WallClock wall_clock;
+
+    /* the kernel clock runs 100 ppm slow */
+    wall_clock.publish(0, HOST_TIME * 1000LL, 100000);
+
+    /* after one day it lags by 8.64 s */
+    EXPECT_EQ(wall_clock.to_ms(tick(86400000)), (HOST_TIME + 86400) * 1000LL + 8640);
+}
+
+TEST(TestWallClock, batch_matches_single_stamps)
+{
+    WallClock wall_clock;
+    wall_clock.publish(1000, HOST_TIME * 1000LL, -35000);
+
+    std::vector<WallClock::time_point> ticks;
+    for (int64_t ms = 0; ms < 100000; ms += 997) {
+        ticks.push_back(tick(ms));
+    }
+    std::vector<WallClock::Timestamp> timestamps(ticks.size());
+
+    wall_clock.stamp(ticks.data(), timestamps.data(), ticks.size());
+
+    for (size_t i = 0; i < ticks.size(); i++) {
+        WallClock::Timestamp timestamp = wall_clock.stamp(ticks[i]);
+        ASSERT_EQ(timestamps[i].seconds, timestamp.seconds);
+        ASSERT_EQ(timestamps[i].fractions256, timestamp.fractions256);
+    }
+}
+
+TEST(TestWallClock, concurrent_readers_never_see_a_torn_conversion)
+{
+    WallClock wall_clock;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> reads{0};
+    std::atomic<size_t> torn{0};
+
+    /* a conversion mixing the offset of one publication with the drift of another breaks drift == offset / 1000 */
+    auto reader = [&] {
+        const WallClock::time_point ticks[] = { tick(0), tick(WallClock::PPB) };
+        WallClock::Timestamp timestamps[2];
+
+        while (!done.load()) {
+            wall_clock.stamp(ticks, timestamps, 2);
+
+            int64_t drift = timestamps[0].seconds;
+            int64_t drift_ms = (timestamps[1].seconds - WallClock::PPB / 1000 - timestamps[0].seconds) * 1000 +
+                               (timestamps[1].fractions256 * 1000 + 255) / 256;
+
+            if (timestamps[0].fractions256 != 0 || drift_ms < drift - 4 || drift_ms > drift) {
+                torn++;
+            }
+            reads++;
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; i++) {
+        readers.emplace_back(reader);
+    }
+
+    /* publish as fast as possible until the readers have stamped enough batches */
+    for (int32_t k = 0; reads.load() < 300000; k = (k + 1) % 1000000) {
+        wall_clock.publish(0, k * 1000LL, k);
+    }
+
+    done = true;
+    for (std::thread &thread : readers) {
+        thread.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0);
+}
+
+class TestCurrentTimeServiceWallClock : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    ChainableGattServerEventHandler chainable_gatt_server_event_handler;
+
+    std::unique_ptr<CurrentTimeService> current_time_service;
+
+    void SetUp()
+    {
+        current_time_service = std::make_unique<CurrentTimeService>(
+            BLE::Instance(), event_queue, chainable_gap_event_handler, chainable_gatt_server_event_handler
+        );
+        current_time_service->init();
+    }
+
+    void TearDown()
+    {
+        current_time_service.reset();
+        ble::delete_mocks();
+    }
+};
+
+TEST_F(TestCurrentTimeServiceWallClock, follows_set_time)
+{
+    const WallClock &wall_clock = current_time_service->get_wall_clock();
+
+    /* before the time is set the wall clock follows the real time clock */
+    EXPECT_LE(std::abs(wall_clock.stamp().seconds - time(nullptr)), 1);
+
+    current_time_service->set_time(HOST_TIME, 128, CurrentTimeService::MANUAL_TIME_UPDATE);
+
+    /* the kernel clock does not advance in the unit tests */
+    WallClock::Timestamp timestamp = wall_clock.stamp();
+    EXPECT_EQ(timestamp.seconds, HOST_TIME);
+    EXPECT_EQ(timestamp.fractions256, 128);
+
+    uint8_t fractions256 = 0;
+    EXPECT_EQ(current_time_service->get_time(fractions256), timestamp.seconds);
+    EXPECT_EQ(fractions256, timestamp.fractions256);
+}
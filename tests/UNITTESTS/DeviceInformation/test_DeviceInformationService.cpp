@@ -23,11 +23,20 @@
 #include "ble-service-device-information/DeviceInformationService.h"
 
 #include "ble_mocks.h"
+#include "AllocationTracker.h"
+
+#include <utility>
+#include <vector>
 
 using namespace ble;
 
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Invoke;
 using ::testing::Property;
 
+using allocation_tracker::allocations;
+
 class TestDeviceInformationService : public testing::Test {
 protected:
     BLE *ble;
@@ -41,6 +50,46 @@ protected:
     {
         ble::delete_mocks();
     }
+
+    /* the values only live as long as the call to add_service, copy them when the service is added */
+    std::vector<std::pair<UUID, std::vector<uint8_t>>> values;
+
+    void expect_add_service()
+    {
+        EXPECT_CALL(gatt_server_mock(), addService(Property(&GattService::getUUID, GattService::UUID_DEVICE_INFORMATION_SERVICE)))
+                .WillOnce(Invoke([this](GattService &service) {
+                    for (uint8_t i = 0; i < service.getCharacteristicCount(); i++) {
+                        GattAttribute &value = service.getCharacteristic(i)->getValueAttribute();
+                        values.emplace_back(
+                            value.getUUID(),
+                            std::vector<uint8_t>(value.getValuePtr(), value.getValuePtr() + value.getLength())
+                        );
+                    }
+                    return gatt_server_mock().fakeAddService(service);
+                }));
+    }
+
+    std::vector<uint8_t> value_of(const UUID &uuid) const
+    {
+        for (const auto &value : values) {
+            if (value.first == uuid) {
+                return value.second;
+            }
+        }
+        return {};
+    }
+
+    /* the System ID and PnP ID of both add_service overloads, packed little endian */
+    void expect_packed_ids()
+    {
+        /* manufacturer defined identifier then organizationally unique identifier */
+        EXPECT_THAT(value_of(GattCharacteristic::UUID_SYSTEM_ID_CHAR),
+                    ElementsAre(0x05, 0x04, 0x03, 0x02, 0x01, 0xEF, 0xCD, 0xAB));
+
+        /* vendor id source, vendor id, product id and product version */
+        EXPECT_THAT(value_of(GattCharacteristic::UUID_PNP_ID_CHAR),
+                    ElementsAre(0x01, 0x22, 0x08, 0x34, 0x12, 0x00, 0x01));
+    }
 };
 
 
@@ -165,3 +214,137 @@ TEST_F(TestDeviceInformationService, add_with_gaps)
         ASSERT_EQ(found, 1);
     }
 }
+
+TEST_F(TestDeviceInformationService, add_compile_time)
+{
+    expect_add_service();
+
+    static const uint8_t cert_data[4] = { 3, 0x01, 0x02, 0x03 };
+
+    DeviceInformationService::add_service(
+        *ble,
+        DeviceInformationService::manufacturers_name_t{"manufacturers_name"},
+        DeviceInformationService::firmware_revision_t{"firmware_revision"},
+        DeviceInformationService::system_id_t{0x00ABCDEF, 0x0102030405},
+        DeviceInformationService::regulatory_cert_data_list_t{cert_data},
+        DeviceInformationService::pnp_id_t{0x01, 0x0822, 0x1234, 0x0100}
+    );
+
+    GattServerMock::service_t& service = gatt_server_mock().services[0];
+
+    ASSERT_EQ(service.characteristics.size(), 5);
+
+    /* registered in the order of the arguments */
+    UUID uuids[5] = {
+        GattCharacteristic::UUID_MANUFACTURER_NAME_STRING_CHAR,
+        GattCharacteristic::UUID_FIRMWARE_REVISION_STRING_CHAR,
+        GattCharacteristic::UUID_SYSTEM_ID_CHAR,
+        GattCharacteristic::UUID_IEEE_REGULATORY_CERTIFICATION_DATA_LIST_CHAR,
+        GattCharacteristic::UUID_PNP_ID_CHAR
+    };
+
+    for (size_t i = 0; i < 5; i++) {
+        ASSERT_EQ(service.characteristics[i].uuid, uuids[i]);
+        ASSERT_TRUE(service.characteristics[i].properties & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ));
+        ASSERT_FALSE(service.characteristics[i].properties & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE));
+    }
+
+    expect_packed_ids();
+}
+
+TEST_F(TestDeviceInformationService, add_packed_ids)
+{
+    expect_add_service();
+
+    /* the same values as add_compile_time, passed at run time */
+    DeviceInformationService::system_id_t system_id{0x00ABCDEF, 0x0102030405};
+    DeviceInformationService::pnp_id_t pnp_id{0x01, 0x0822, 0x1234, 0x0100};
+
+    DeviceInformationService::add_service(
+        *ble,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        &system_id,
+        nullptr,
+        &pnp_id
+    );
+
+    expect_packed_ids();
+}
+
+/* the mock allocates when it is called, measure that once so that it can be told apart from the service */
+class TestDeviceInformationServiceHeap : public TestDeviceInformationService {
+protected:
+    size_t allocations_before_add = 0;
+    size_t mock_allocations = 0;
+
+    void SetUp()
+    {
+        TestDeviceInformationService::SetUp();
+
+        EXPECT_CALL(gatt_server_mock(), addService(_))
+                .Times(2)
+                .WillRepeatedly(Invoke([this](GattService &) {
+                    allocations_before_add = allocations();
+                    return BLE_ERROR_NONE;
+                }));
+
+        GattService empty_service(GattService::UUID_DEVICE_INFORMATION_SERVICE, nullptr, 0);
+
+        size_t allocations_at_start = allocations();
+        ble->gattServer().addService(empty_service);
+        mock_allocations = allocations_before_add - allocations_at_start;
+    }
+};
+
+TEST_F(TestDeviceInformationServiceHeap, add_without_heap_allocation)
+{
+    static const uint8_t cert_data[2] = { 1, 0xAA };
+
+    size_t allocations_at_start = allocations();
+
+    DeviceInformationService::add_service(
+        *ble,
+        DeviceInformationService::manufacturers_name_t{"manufacturers_name"},
+        DeviceInformationService::model_number_t{"model_number"},
+        DeviceInformationService::serial_number_t{"serial_number"},
+        DeviceInformationService::hardware_revision_t{"hardware_revision"},
+        DeviceInformationService::firmware_revision_t{"firmware_revision"},
+        DeviceInformationService::software_revision_t{"software_revision"},
+        DeviceInformationService::system_id_t{0x00ABCDEF, 0x0102030405},
+        DeviceInformationService::regulatory_cert_data_list_t{cert_data},
+        DeviceInformationService::pnp_id_t{0x01, 0x0822, 0x1234, 0x0100}
+    );
+
+    /* nothing allocated before the service is handed to the server nor after */
+    ASSERT_EQ(allocations_before_add - allocations_at_start, mock_allocations);
+    ASSERT_EQ(allocations(), allocations_before_add);
+}
+
+TEST_F(TestDeviceInformationServiceHeap, add_runtime_without_heap_allocation)
+{
+    DeviceInformationService::system_id_t system_id{};
+    DeviceInformationService::pnp_id_t pnp_id{};
+
+    size_t allocations_at_start = allocations();
+
+    DeviceInformationService::add_service(
+        *ble,
+        "manufacturers_name",
+        "model_number",
+        nullptr,
+        nullptr,
+        nullptr,
+        "software_revision",
+        &system_id,
+        nullptr,
+        &pnp_id
+    );
+
+    ASSERT_EQ(allocations_before_add - allocations_at_start, mock_allocations);
+    ASSERT_EQ(allocations(), allocations_before_add);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/common/EmbeddedEvent.h"
+
+using namespace ble;
+using namespace std::chrono;
+
+class TestEmbeddedEvent : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    int dispatched = 0;
+    EmbeddedEvent event{event_queue, [this] { dispatched++; }};
+};
+
+TEST_F(TestEmbeddedEvent, one_shot)
+{
+    ASSERT_FALSE(event.pending());
+
+    event.post(milliseconds(100));
+    ASSERT_TRUE(event.pending());
+
+    event_queue.dispatch(99);
+    ASSERT_EQ(dispatched, 0);
+
+    event_queue.dispatch(1);
+    ASSERT_EQ(dispatched, 1);
+    ASSERT_FALSE(event.pending());
+
+    event_queue.dispatch(1000);
+    ASSERT_EQ(dispatched, 1);
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestEmbeddedEvent, periodic)
+{
+    event.post(milliseconds(50), milliseconds(100));
+
+    event_queue.dispatch(50);
+    ASSERT_EQ(dispatched, 1);
+    ASSERT_TRUE(event.pending());
+
+    event_queue.dispatch(300);
+    ASSERT_EQ(dispatched, 4);
+    ASSERT_TRUE(event.pending());
+    ASSERT_EQ(event_queue.size(), 1);
+}
+
+TEST_F(TestEmbeddedEvent, pool_exhausted)
+{
+    // The application took every event of the pool
+    event_queue.set_pool_size(0);
+    ASSERT_EQ(event_queue.call([] { }), 0);
+
+    event.post(milliseconds(10));
+    ASSERT_TRUE(event.pending());
+
+    event_queue.dispatch(10);
+    ASSERT_EQ(dispatched, 1);
+
+    event.post(milliseconds(0), milliseconds(100));
+
+    event_queue.dispatch(300);
+    ASSERT_EQ(dispatched, 5);
+}
+
+TEST_F(TestEmbeddedEvent, post_moves_pending_event)
+{
+    event.post(milliseconds(100));
+    event_queue.dispatch(50);
+
+    event.post(milliseconds(100));
+    ASSERT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(50);
+    ASSERT_EQ(dispatched, 0);
+
+    event_queue.dispatch(50);
+    ASSERT_EQ(dispatched, 1);
+}
+
+TEST_F(TestEmbeddedEvent, cancel)
+{
+    ASSERT_FALSE(event.cancel());
+
+    event.post(milliseconds(100), milliseconds(100));
+    ASSERT_TRUE(event.cancel());
+    ASSERT_FALSE(event.pending());
+
+    event_queue.dispatch(1000);
+    ASSERT_EQ(dispatched, 0);
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestEmbeddedEvent, cancel_from_periodic_handler)
+{
+    EmbeddedEvent self_cancelling{event_queue, [&] {
+        dispatched++;
+        if (dispatched == 3) {
+            self_cancelling.cancel();
+        }
+    }};
+
+    self_cancelling.post(milliseconds(100), milliseconds(100));
+
+    event_queue.dispatch(1000);
+    ASSERT_EQ(dispatched, 3);
+    ASSERT_FALSE(self_cancelling.pending());
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestEmbeddedEvent, destructor_cancels)
+{
+    {
+        EmbeddedEvent scoped{event_queue, [this] { dispatched++; }};
+        scoped.post(milliseconds(100));
+    }
+
+    event_queue.dispatch(1000);
+    ASSERT_EQ(dispatched, 0);
+    ASSERT_EQ(event_queue.size(), 0);
+}
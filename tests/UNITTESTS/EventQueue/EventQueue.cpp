@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "events/EventQueue.h"
+
+#include "platform/mbed_assert.h"
+
+namespace events {
+
+EventQueue::~EventQueue()
+{
+    /* the user allocated events outliving the queue must not unlink themselves from it */
+    while (_user_events) {
+        user_event *event = _user_events;
+        _user_events = event->next;
+        event->posted = false;
+        event->queued = false;
+    }
+}
+
+int EventQueue::allocate(std::function<void()> f, std::chrono::milliseconds ms)
+{
+    if (_pool_events.size() >= _pool_size) {
+        return 0;
+    }
+
+    const int id = _next_id++;
+    _pool_events.push_back({std::move(f), _now + ms.count(), _order++, id});
+    return id;
+}
+
+bool EventQueue::cancel(int id)
+{
+    for (auto it = _pool_events.begin(); it != _pool_events.end(); ++it) {
+        if (it->id == id) {
+            _pool_events.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t EventQueue::size() const
+{
+    size_t size = _pool_events.size();
+    for (const user_event *event = _user_events; event; event = event->next) {
+        size++;
+    }
+    return size;
+}
+
+void EventQueue::post_user_event(user_event *event)
+{
+    MBED_ASSERT(!event->posted);
+
+    event->posted = true;
+    enqueue_user_event(event, _now + event->delay);
+}
+
+void EventQueue::enqueue_user_event(user_event *event, int64_t due)
+{
+    event->queued = true;
+    event->due = due;
+    event->order = _order++;
+
+    /* appended: the events due at the same time are dispatched in the order they were posted */
+    user_event **last = &_user_events;
+    while (*last) {
+        last = &(*last)->next;
+    }
+    event->next = nullptr;
+    *last = event;
+}
+
+void EventQueue::unlink_user_event(user_event *event)
+{
+    for (user_event **link = &_user_events; *link; link = &(*link)->next) {
+        if (*link == event) {
+            *link = event->next;
+            break;
+        }
+    }
+    event->queued = false;
+}
+
+bool EventQueue::cancel_user_event(user_event *event)
+{
+    if (!event->queued) {
+        /* an event being dispatched is not dispatched again */
+        if (event->posted) {
+            event->period = -1;
+        }
+        return false;
+    }
+
+    unlink_user_event(event);
+    event->posted = false;
+    return true;
+}
+
+void EventQueue::dispatch_user_event(user_event *event)
+{
+    unlink_user_event(event);
+    _now = event->due;
+
+    event->dispatch(event->context);
+
+    /* queued again once the handler returns, unless it cancelled the event */
+    if (event->period >= 0) {
+        enqueue_user_event(event, event->due + event->period);
+    } else {
+        event->posted = false;
+    }
+}
+
+void EventQueue::dispatch(int milliseconds)
+{
+    const int64_t target = (milliseconds < 0) ? INT64_MAX : _now + milliseconds;
+
+    for (;;) {
+        auto next_pool_event = _pool_events.end();
+        for (auto it = _pool_events.begin(); it != _pool_events.end(); ++it) {
+            if (it->due <= target && (next_pool_event == _pool_events.end() ||
+                                      it->due < next_pool_event->due ||
+                                      (it->due == next_pool_event->due && it->order < next_pool_event->order))) {
+                next_pool_event = it;
+            }
+        }
+
+        user_event *next_user_event = nullptr;
+        for (user_event *event = _user_events; event; event = event->next) {
+            if (event->due <= target && (!next_user_event || event->due < next_user_event->due ||
+                                         (event->due == next_user_event->due && event->order < next_user_event->order))) {
+                next_user_event = event;
+            }
+        }
+
+        const bool pool_event_first = next_pool_event != _pool_events.end() &&
+            (!next_user_event || next_pool_event->due < next_user_event->due ||
+             (next_pool_event->due == next_user_event->due && next_pool_event->order < next_user_event->order));
+
+        if (pool_event_first) {
+            _now = next_pool_event->due;
+            std::function<void()> f = std::move(next_pool_event->f);
+            _pool_events.erase(next_pool_event);
+            f();
+        } else if (next_user_event) {
+            dispatch_user_event(next_user_event);
+        } else {
+            break;
+        }
+    }
+
+    if (milliseconds >= 0) {
+        _now = target;
+    }
+}
+
+} // namespace events
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_UNITTEST_EVENT_QUEUE_H
+#define BLE_UNITTEST_EVENT_QUEUE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+
+namespace events {
+
+typedef int event_id;
+
+template<typename F, typename A>
+class UserAllocatedEvent;
+
+/**
+ * Event Queue fake
+ *
+ * @par purpose
+ * Single threaded event queue with the interface of events::EventQueue, dispatching on a simulated clock that
+ * only moves forward in dispatch(). Like the event queue of mbed-os, it dispatches the events allocated from
+ * its pool by call() and call_in() as well as the UserAllocatedEvent objects posted to it, which take nothing
+ * from the pool.
+ *
+ * @par usage
+ * Post events as on a target, then run the ones due with dispatch(). Limit the pool with set_pool_size() to
+ * exhaust it: call() and call_in() return 0 while all its events are pending, user allocated events are still
+ * posted.
+ */
+class EventQueue {
+public:
+    typedef std::chrono::duration<int, std::milli> duration;
+
+    EventQueue(unsigned size = 0, unsigned char *buffer = nullptr)
+    {
+    }
+
+    ~EventQueue();
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue &operator=(const EventQueue&) = delete;
+
+    template<typename F, typename... Args>
+    int call(F f, Args... args)
+    {
+        return call_in(std::chrono::milliseconds(0), f, args...);
+    }
+
+    template<typename T, typename R, typename... Args>
+    int call(T *obj, R (T::*method)(Args...), Args... args)
+    {
+        return call_in(std::chrono::milliseconds(0), obj, method, args...);
+    }
+
+    template<typename F, typename... Args>
+    int call_in(std::chrono::milliseconds ms, F f, Args... args)
+    {
+        return allocate([=]() mutable { f(args...); }, ms);
+    }
+
+    template<typename T, typename R, typename... Args>
+    int call_in(std::chrono::milliseconds ms, T *obj, R (T::*method)(Args...), Args... args)
+    {
+        return allocate([=]() { (obj->*method)(args...); }, ms);
+    }
+
+    /**
+     * Cancel an event allocated from the pool
+     *
+     * @return true if the event was pending
+     */
+    bool cancel(int id);
+
+    /**
+     * Dispatch the events due within @p milliseconds, or all of them if negative, including those they post
+     */
+    void dispatch(int milliseconds = -1);
+
+    void dispatch_forever()
+    {
+        dispatch(-1);
+    }
+
+    /**
+     * @return Number of events pending, from the pool and user allocated
+     */
+    size_t size() const;
+
+    /**
+     * Limit the number of events of the pool pending at once, unlimited by default
+     */
+    void set_pool_size(size_t events)
+    {
+        _pool_size = events;
+    }
+
+private:
+    template<typename F, typename A>
+    friend class UserAllocatedEvent;
+
+    /* the part of a UserAllocatedEvent the queue links and dispatches, it owns no memory */
+    struct user_event {
+        user_event *next = nullptr;
+        void (*dispatch)(void *context) = nullptr;
+        void *context = nullptr;
+        int64_t due = 0;
+        int delay = 0;
+        int period = -1;
+        uint64_t order = 0;
+        /* queued or being dispatched, posting it again is an error until the handler returns */
+        bool posted = false;
+        bool queued = false;
+    };
+
+    struct pool_event {
+        std::function<void()> f;
+        int64_t due;
+        uint64_t order;
+        int id;
+    };
+
+    int allocate(std::function<void()> f, std::chrono::milliseconds ms);
+
+    void post_user_event(user_event *event);
+
+    void enqueue_user_event(user_event *event, int64_t due);
+
+    void unlink_user_event(user_event *event);
+
+    bool cancel_user_event(user_event *event);
+
+    void dispatch_user_event(user_event *event);
+
+    std::list<pool_event> _pool_events;
+    user_event *_user_events = nullptr;
+    size_t _pool_size = std::numeric_limits<size_t>::max();
+    int64_t _now = 0;
+    uint64_t _order = 0;
+    int _next_id = 1;
+};
+
+} // namespace events
+
+#endif // BLE_UNITTEST_EVENT_QUEUE_H
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_UNITTEST_USER_ALLOCATED_EVENT_H
+#define BLE_UNITTEST_USER_ALLOCATED_EVENT_H
+
+#include "events/EventQueue.h"
+#include "platform/mbed_assert.h"
+
+#include <chrono>
+
+namespace events {
+
+/**
+ * User Allocated Event fake
+ *
+ * @par purpose
+ * Event whose memory belongs to its user, posted to the EventQueue fake without taking from its pool. It
+ * follows the rules of the events::UserAllocatedEvent of mbed-os: the event is posted from call() until its
+ * handler returns, posting it again in the meantime asserts, and a periodic event cancelled from its own
+ * handler is not dispatched again.
+ *
+ * @note Only events without arguments are supported, the extensions use no others.
+ */
+template<typename F>
+class UserAllocatedEvent<F, void()> {
+public:
+    typedef EventQueue::duration duration;
+
+    UserAllocatedEvent(EventQueue *queue, F f) :
+        _queue(queue),
+        _f(f)
+    {
+        _e.dispatch = &UserAllocatedEvent::dispatch;
+        _e.context = this;
+    }
+
+    UserAllocatedEvent(F f) :
+        UserAllocatedEvent(nullptr, f)
+    {
+    }
+
+    ~UserAllocatedEvent()
+    {
+        cancel();
+    }
+
+    UserAllocatedEvent(const UserAllocatedEvent&) = delete;
+    UserAllocatedEvent &operator=(const UserAllocatedEvent&) = delete;
+
+    void call()
+    {
+        bool posted = try_call();
+        MBED_ASSERT(posted);
+        (void) posted;
+    }
+
+    bool try_call()
+    {
+        if (!_queue || _e.posted) {
+            return false;
+        }
+        _queue->post_user_event(&_e);
+        return true;
+    }
+
+    void call_on(EventQueue *queue)
+    {
+        bool posted = try_call_on(queue);
+        MBED_ASSERT(posted);
+        (void) posted;
+    }
+
+    bool try_call_on(EventQueue *queue)
+    {
+        if (_e.posted) {
+            return false;
+        }
+        _queue = queue;
+        return try_call();
+    }
+
+    void operator()()
+    {
+        call();
+    }
+
+    void delay(int delay)
+    {
+        MBED_ASSERT(!_e.posted);
+        _e.delay = delay;
+    }
+
+    void delay(duration delay)
+    {
+        this->delay(static_cast<int>(delay.count()));
+    }
+
+    void period(int period)
+    {
+        MBED_ASSERT(!_e.posted);
+        _e.period = period;
+    }
+
+    void period(duration period)
+    {
+        this->period(static_cast<int>(period.count()));
+    }
+
+    /**
+     * @return true if the event was queued, false if it was not posted or is being dispatched, in which case
+     * a periodic event is not dispatched again
+     */
+    bool cancel()
+    {
+        return _queue ? _queue->cancel_user_event(&_e) : false;
+    }
+
+private:
+    static void dispatch(void *context)
+    {
+        static_cast<UserAllocatedEvent *>(context)->_f();
+    }
+
+    EventQueue *_queue;
+    F _f;
+    EventQueue::user_event _e;
+};
+
+} // namespace events
+
+#endif // BLE_UNITTEST_USER_ALLOCATED_EVENT_H
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/gatt/GattCodec.h"
+
+#include <cmath>
+
+using namespace ble;
+
+/* decoding is usable at compile time */
+static constexpr uint8_t BYTES[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+
+static_assert(codec::decode<codec::uint8>(BYTES) == 0x01, "");
+static_assert(codec::decode<codec::uint16_le>(BYTES) == 0x0201, "");
+static_assert(codec::decode<codec::uint24_le, 1>(BYTES) == 0x040302, "");
+static_assert(codec::decode<codec::uint48_le, 2>(BYTES) == 0x080706050403, "");
+static_assert(codec::uint24_le::max == 0xFFFFFF, "");
+static_assert(codec::uint16_le::max == 0xFFFF, "");
+static_assert(std::is_same<codec::uint48_le::value_type, uint64_t>::value, "");
+
+static constexpr uint8_t DATE_TIME[] = { 0xE5, 0x07, 7, 14, 12, 30, 59 };
+
+static_assert(codec::decode<codec::date_time>(DATE_TIME).year == 2021, "");
+static_assert(codec::decode<codec::date_time>(DATE_TIME).seconds == 59, "");
+
+/* 0xF07D: exponent -1, mantissa 125 */
+static constexpr uint8_t SFLOAT[] = { 0x7D, 0xF0 };
+
+static_assert(codec::decode<codec::sfloat>(SFLOAT).mantissa == 125, "");
+static_assert(codec::decode<codec::sfloat>(SFLOAT).exponent == -1, "");
+
+/* encoding is usable at compile time too */
+static constexpr uint32_t round_trip_uint24(uint32_t value)
+{
+    uint8_t data[3] = {};
+    codec::encode<codec::uint24_le>(data, value);
+    return codec::decode<codec::uint24_le>(data);
+}
+
+static_assert(round_trip_uint24(0x123456) == 0x123456, "");
+static_assert(round_trip_uint24(0xFF123456) == 0x123456, "upper bits are ignored");
+
+TEST(TestGattCodec, uint_little_endian)
+{
+    uint8_t data[8] = {};
+
+    codec::encode<codec::uint16_le>(data, 0xA1B2);
+    codec::encode<codec::uint48_le, 2>(data, 0x0000665544332211);
+
+    const uint8_t expected[8] = { 0xB2, 0xA1, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+    for (size_t i = 0; i < 8; i++) {
+        ASSERT_EQ(data[i], expected[i]);
+    }
+
+    ASSERT_EQ(codec::uint40_le::decode(data + 3), 0x6655443322);
+}
+
+TEST(TestGattCodec, date_time)
+{
+    uint8_t data[codec::date_time::size] = {};
+
+    codec::date_time::value_type date_time{};
+    date_time.year    = 1999;
+    date_time.month   = 12;
+    date_time.day     = 31;
+    date_time.hours   = 23;
+    date_time.minutes = 59;
+    date_time.seconds = 58;
+
+    codec::encode<codec::date_time>(data, date_time);
+
+    ASSERT_EQ(data[0], 1999 & 0xFF);
+    ASSERT_EQ(data[1], 1999 >> 8);
+    ASSERT_EQ(data[6], 58);
+
+    codec::date_time::value_type decoded = codec::decode<codec::date_time>(data);
+    ASSERT_EQ(decoded.year, 1999);
+    ASSERT_EQ(decoded.month, 12);
+    ASSERT_EQ(decoded.day, 31);
+    ASSERT_EQ(decoded.hours, 23);
+    ASSERT_EQ(decoded.minutes, 59);
+    ASSERT_EQ(decoded.seconds, 58);
+}
+
+TEST(TestGattCodec, sfloat)
+{
+    uint8_t data[codec::sfloat::size] = {};
+
+    /* every mantissa and exponent survives a round trip */
+    for (int exponent = -8; exponent <= 7; exponent++) {
+        for (int mantissa = -2048; mantissa <= 2047; mantissa++) {
+            codec::sfloat::value_type value{ static_cast<int16_t>(mantissa), static_cast<int8_t>(exponent) };
+            codec::encode<codec::sfloat>(data, value);
+            codec::sfloat::value_type decoded = codec::decode<codec::sfloat>(data);
+            ASSERT_EQ(decoded.mantissa, mantissa);
+            ASSERT_EQ(decoded.exponent, exponent);
+        }
+    }
+
+    /* 36.4 */
+    codec::encode<codec::sfloat>(data, { 364, -1 });
+    ASSERT_EQ(data[0], 0x6C);
+    ASSERT_EQ(data[1], 0xF1);
+    ASSERT_FLOAT_EQ(codec::sfloat::to_float(codec::decode<codec::sfloat>(data)), 36.4f);
+}
+
+TEST(TestGattCodec, sfloat_special_values)
+{
+    const uint8_t nan[]            = { 0xFF, 0x07 };
+    const uint8_t nres[]           = { 0x00, 0x08 };
+    const uint8_t plus_infinity[]  = { 0xFE, 0x07 };
+    const uint8_t minus_infinity[] = { 0x02, 0x08 };
+    const uint8_t reserved[]       = { 0x01, 0x08 };
+
+    ASSERT_TRUE(codec::sfloat::is_special(codec::decode<codec::sfloat>(nan)));
+    ASSERT_TRUE(codec::sfloat::is_special(codec::decode<codec::sfloat>(nres)));
+    ASSERT_TRUE(codec::sfloat::is_special(codec::decode<codec::sfloat>(reserved)));
+
+    ASSERT_EQ(codec::decode<codec::sfloat>(nan).mantissa, codec::sfloat::NaN.mantissa);
+    ASSERT_EQ(codec::decode<codec::sfloat>(nres).mantissa, codec::sfloat::NRes.mantissa);
+
+    ASSERT_TRUE(std::isnan(codec::sfloat::to_float(codec::decode<codec::sfloat>(nan))));
+    ASSERT_TRUE(std::isnan(codec::sfloat::to_float(codec::decode<codec::sfloat>(reserved))));
+    ASSERT_EQ(codec::sfloat::to_float(codec::decode<codec::sfloat>(plus_infinity)), INFINITY);
+    ASSERT_EQ(codec::sfloat::to_float(codec::decode<codec::sfloat>(minus_infinity)), -INFINITY);
+
+    /* the largest finite mantissas are not special */
+    ASSERT_FALSE(codec::sfloat::is_special({ 2045, 0 }));
+    ASSERT_FALSE(codec::sfloat::is_special({ -2045, 0 }));
+    ASSERT_FALSE(codec::sfloat::is_special({ 2047, 1 }));
+}
+
+TEST(TestGattCodec, float32)
+{
+    uint8_t data[codec::float32::size] = {};
+
+    /* -1234567 * 10^-3 */
+    codec::encode<codec::float32>(data, { -1234567, -3 });
+    ASSERT_EQ(data[3], 0xFD);
+
+    codec::float32::value_type decoded = codec::decode<codec::float32>(data);
+    ASSERT_EQ(decoded.mantissa, -1234567);
+    ASSERT_EQ(decoded.exponent, -3);
+    ASSERT_FLOAT_EQ(codec::float32::to_float(decoded), -1234.567f);
+
+    const uint8_t nan[] = { 0xFF, 0xFF, 0x7F, 0x00 };
+    ASSERT_TRUE(codec::float32::is_special(codec::decode<codec::float32>(nan)));
+    ASSERT_EQ(codec::decode<codec::float32>(nan).mantissa, codec::float32::NaN.mantissa);
+
+    /* the exponent uses the whole top byte */
+    codec::encode<codec::float32>(data, { 1, 127 });
+    ASSERT_EQ(codec::decode<codec::float32>(data).exponent, 127);
+    codec::encode<codec::float32>(data, { 1, -128 });
+    ASSERT_EQ(codec::decode<codec::float32>(data).exponent, -128);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/GattServer.h"
+
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble-service-immediate-alert/ImmediateAlertService.h"
+
+#include "ble/gap/Events.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <chrono>
+
+using namespace ble;
+using namespace std::chrono;
+
+using ::testing::Property;
+
+struct EventHandlerMock : AlertDispatcher::EventHandler {
+    MOCK_METHOD(void, on_alert_changed, (AlertLevel, uint8_t), (override));
+};
+
+class TestImmediateAlertService : public testing::Test {
+protected:
+    BLE *ble;
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    AlertDispatcher alert_dispatcher{event_queue};
+    EventHandlerMock event_handler_mock;
+
+    std::unique_ptr<ImmediateAlertService> immediate_alert_service;
+
+    void SetUp()
+    {
+        ble = &BLE::Instance();
+
+        immediate_alert_service = std::make_unique<ImmediateAlertService>(
+            *ble, event_queue, chainable_gap_event_handler, alert_dispatcher
+        );
+        immediate_alert_service->init();
+
+        alert_dispatcher.set_event_handler(&event_handler_mock);
+    }
+
+    void TearDown()
+    {
+        immediate_alert_service.reset();
+        ble::delete_mocks();
+    }
+
+    GattAuthCallbackReply_t simulate_data_written_event(const uint8_t *data, uint16_t len,
+                                                        connection_handle_t connectionHandle = 0)
+    {
+        GattServerMock::characteristic_t &alert_level_char = gatt_server_mock().services[0].characteristics[0];
+
+        GattWriteAuthCallbackParams write_request {
+                connectionHandle,
+                alert_level_char.value_handle,
+                0,
+                len,
+                data,
+                AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        alert_level_char.write_cb(&write_request);
+
+        return write_request.authorizationReply;
+    }
+
+    GattAuthCallbackReply_t simulate_data_written_event(AlertLevel level, connection_handle_t connectionHandle = 0)
+    {
+        const uint8_t data = static_cast<uint8_t>(level);
+
+        return simulate_data_written_event(&data, sizeof(data), connectionHandle);
+    }
+
+    void simulate_disconnection_event(connection_handle_t connectionHandle = 0)
+    {
+        DisconnectionCompleteEvent disconnection_complete_event(
+                connectionHandle,
+                disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION
+        );
+
+        chainable_gap_event_handler.onDisconnectionComplete(disconnection_complete_event);
+    }
+};
+
+TEST_F(TestImmediateAlertService, init)
+{
+    ImmediateAlertService other_service(*ble, event_queue, chainable_gap_event_handler, alert_dispatcher);
+
+    // A service with uuid=0x1802 should be added to the gatt server
+    EXPECT_CALL(gatt_server_mock(), addService(
+            Property(&GattService::getUUID, GattService::UUID_IMMEDIATE_ALERT_SERVICE)))
+            .Times(1);
+
+    other_service.init();
+
+    auto characteristic = gatt_server_mock().services.back().characteristics[0];
+
+    // The alert level characteristic is written without response and cannot be read
+    ASSERT_EQ(characteristic.uuid, GattCharacteristic::UUID_ALERT_LEVEL_CHAR);
+    ASSERT_EQ(characteristic.properties, GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE_WITHOUT_RESPONSE);
+    ASSERT_TRUE(characteristic.write_cb);
+}
+
+TEST_F(TestImmediateAlertService, alert_requested_from_dispatcher)
+{
+    EXPECT_EQ(simulate_data_written_event(AlertLevel::HIGH_ALERT), AUTH_CALLBACK_REPLY_SUCCESS);
+
+    EXPECT_EQ(immediate_alert_service->get_alert_level(), AlertLevel::HIGH_ALERT);
+    EXPECT_EQ(alert_dispatcher.get_sources(), AlertDispatcher::IMMEDIATE_ALERT);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::HIGH_ALERT, AlertDispatcher::IMMEDIATE_ALERT));
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // Writing "No Alert" ends the alert
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::NO_ALERT, 0));
+    simulate_data_written_event(AlertLevel::NO_ALERT);
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestImmediateAlertService, last_level_written_in_effect)
+{
+    simulate_data_written_event(AlertLevel::HIGH_ALERT, 0);
+    simulate_data_written_event(AlertLevel::MILD_ALERT, 1);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::MILD_ALERT, AlertDispatcher::IMMEDIATE_ALERT));
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The first client leaving does not end the alert of the second
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+    simulate_disconnection_event(0);
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::NO_ALERT, 0));
+    simulate_disconnection_event(1);
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestImmediateAlertService, invalid_writes_rejected)
+{
+    const uint8_t out_of_range = 3;
+    const uint8_t too_long[] = { 1, 0 };
+
+    EXPECT_EQ(simulate_data_written_event(&out_of_range, sizeof(out_of_range)), AUTH_CALLBACK_REPLY_ATTERR_OUT_OF_RANGE);
+    EXPECT_EQ(simulate_data_written_event(too_long, sizeof(too_long)),
+              AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH);
+
+    EXPECT_EQ(immediate_alert_service->get_alert_level(), AlertLevel::NO_ALERT);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestImmediateAlertService, stop_alert)
+{
+    simulate_data_written_event(AlertLevel::HIGH_ALERT);
+
+    // The user presses a button before the event queue runs: the alert is never raised
+    immediate_alert_service->stop_alert();
+
+    EXPECT_EQ(immediate_alert_service->get_alert_level(), AlertLevel::NO_ALERT);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestImmediateAlertService, alert_timeout)
+{
+    immediate_alert_service->set_alert_timeout(seconds(10));
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::MILD_ALERT, AlertDispatcher::IMMEDIATE_ALERT));
+    simulate_data_written_event(AlertLevel::MILD_ALERT);
+    event_queue.dispatch(5000);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // Writing the alert level again re-arms the timeout
+    EXPECT_CALL(event_handler_mock, on_alert_changed)
+            .Times(0);
+    simulate_data_written_event(AlertLevel::MILD_ALERT);
+    event_queue.dispatch(9999);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::NO_ALERT, 0));
+    event_queue.dispatch(1);
+
+    EXPECT_EQ(immediate_alert_service->get_alert_level(), AlertLevel::NO_ALERT);
+    EXPECT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestImmediateAlertService, alerts_of_link_loss_coalesced)
+{
+    // A link of the proximity tag was lost just as a phone looks for it
+    alert_dispatcher.request(AlertDispatcher::LINK_LOSS, AlertLevel::MILD_ALERT);
+    simulate_data_written_event(AlertLevel::HIGH_ALERT, 1);
+
+    EXPECT_CALL(event_handler_mock, on_alert_changed(
+            AlertLevel::HIGH_ALERT, AlertDispatcher::LINK_LOSS | AlertDispatcher::IMMEDIATE_ALERT));
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The phone found it, the link loss alert goes on
+    EXPECT_CALL(event_handler_mock, on_alert_changed(AlertLevel::MILD_ALERT, AlertDispatcher::LINK_LOSS));
+    simulate_data_written_event(AlertLevel::NO_ALERT, 1);
+    event_queue.dispatch(0);
+}
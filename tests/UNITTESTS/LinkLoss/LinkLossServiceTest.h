@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BLE_UNITTEST_LINK_LOSS_SERVICE_TEST_H
+#define BLE_UNITTEST_LINK_LOSS_SERVICE_TEST_H
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "ble/BLE.h"
+#include "ble/GattServer.h"
+
+#include "ble/gap/ChainableGapEventHandler.h"
+#include "ble-service-link-loss/LinkLossService.h"
+
+#include "ble/gap/Events.h"
+
+#include "ble_mocks.h"
+#include "events/EventQueue.h"
+
+#include <memory>
+
+struct EventHandlerMock : LinkLossService::EventHandler {
+    MOCK_METHOD(void, on_alert_requested, (LinkLossService::AlertLevel), (override));
+    MOCK_METHOD(void, on_alert_end, (), (override));
+#if MBED_CONF_BLE_SERVICE_LINK_LOSS_EARLY_WARNING
+    MOCK_METHOD(void, on_pre_alert_requested, (LinkLossService::AlertLevel), (override));
+    MOCK_METHOD(void, on_pre_alert_end, (), (override));
+#endif
+};
+
+/**
+ * Link Loss Service Test
+ *
+ * @par purpose
+ * Fixture shared by the executables testing the service built with one configuration option enabled, each of them
+ * derives its own fixture from it.
+ *
+ * @par usage
+ * The service is initialised with the event handler mock before each test. A connection is from a different peer
+ * for each handle unless the last byte of the peer address is given.
+ */
+class LinkLossServiceTest : public testing::Test {
+protected:
+    ble::BLE *ble;
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+    EventHandlerMock event_handler_mock;
+
+    std::unique_ptr<LinkLossService> link_loss_service;
+
+    void SetUp() override
+    {
+        ble = &ble::BLE::Instance();
+
+        link_loss_service = std::make_unique<LinkLossService>(*ble, event_queue, chainable_gap_event_handler);
+        link_loss_service->init();
+        link_loss_service->set_event_handler(&event_handler_mock);
+    }
+
+    void TearDown() override
+    {
+        link_loss_service.reset();
+        ble::delete_mocks();
+    }
+
+    void simulate_connection_event(ble::connection_handle_t connectionHandle, uint8_t peer_addr_byte,
+                                   uint16_t interval, uint16_t latency, uint16_t supervision_timeout)
+    {
+        const uint8_t  peer_addr_bytes[] = {0xfb, 0xdd, 0x62, 0x03, 0x04, peer_addr_byte};
+        const uint8_t local_addr_bytes[] = {0x4d, 0xc7, 0x92, 0x0e, 0x51, 0xba};
+
+        ble::ConnectionCompleteEvent connection_complete_event(
+                BLE_ERROR_NONE,
+                connectionHandle,
+                ble::connection_role_t::PERIPHERAL,
+                ble::peer_address_type_t::PUBLIC,
+                ble::address_t(peer_addr_bytes),
+                ble::address_t(local_addr_bytes),
+                ble::address_t(peer_addr_bytes),
+                ble::conn_interval_t(interval),
+                ble::slave_latency_t(latency),
+                ble::supervision_timeout_t(supervision_timeout),
+                100
+        );
+
+        chainable_gap_event_handler.onConnectionComplete(connection_complete_event);
+    }
+
+    void simulate_connection_event(ble::connection_handle_t connectionHandle, uint8_t peer_addr_byte)
+    {
+        simulate_connection_event(connectionHandle, peer_addr_byte, 50, 0, 100);
+    }
+
+    void simulate_connection_event(ble::connection_handle_t connectionHandle = 0)
+    {
+        simulate_connection_event(connectionHandle, peer_addr_byte(connectionHandle));
+    }
+
+    void simulate_disconnection_event(ble::disconnection_reason_t reason, ble::connection_handle_t connectionHandle = 0)
+    {
+        ble::DisconnectionCompleteEvent disconnection_complete_event(connectionHandle, reason);
+
+        chainable_gap_event_handler.onDisconnectionComplete(disconnection_complete_event);
+    }
+
+    void simulate_data_written_event(LinkLossService::AlertLevel level, ble::connection_handle_t connectionHandle = 0)
+    {
+        ble::GattServerMock::characteristic_t &alert_level_char =
+                ble::gatt_server_mock().services[0].characteristics[0];
+
+        const uint8_t data = static_cast<uint8_t>(level);
+
+        GattWriteAuthCallbackParams write_request {
+                connectionHandle,
+                alert_level_char.value_handle,
+                0,
+                sizeof(data),
+                &data,
+                AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        alert_level_char.write_cb(&write_request);
+    }
+
+    /* the last byte of the address of the peer connected on a handle by default */
+    static uint8_t peer_addr_byte(ble::connection_handle_t connectionHandle)
+    {
+        return static_cast<uint8_t>(0xd8 + connectionHandle);
+    }
+};
+
+#endif // BLE_UNITTEST_LINK_LOSS_SERVICE_TEST_H
@@ -27,14 +27,17 @@
 
 #include "ble_mocks.h"
 #include "events/EventQueue.h"
+#include "AllocationTracker.h"
 
 #include <chrono>
+#include <vector>
 
 using namespace ble;
 using namespace events;
 using namespace std::chrono;
 using namespace std::literals::chrono_literals;
 
+using ::testing::InSequence;
 using ::testing::Property;
 using ::testing::Values;
 
@@ -82,12 +85,13 @@ protected:
         TestLinkLossService::TearDown();
     }
 
-    void simulate_connection_event(ble_error_t status)
+    void simulate_connection_event(ble_error_t status,
+                                   connection_handle_t connectionHandle = 0,
+                                   uint8_t peer_addr_last_byte = 0xd8)
     {
-        const uint8_t  peer_addr_bytes[] = {0xfb, 0xdd, 0x62, 0x03, 0x04, 0xd8};
+        const uint8_t  peer_addr_bytes[] = {0xfb, 0xdd, 0x62, 0x03, 0x04, peer_addr_last_byte};
         const uint8_t local_addr_bytes[] = {0x4d, 0xc7, 0x92, 0x0e, 0x51, 0xba};
 
-        connection_handle_t connectionHandle = 0;
         connection_role_t ownRole = connection_role_t::PERIPHERAL;
         const peer_address_type_t peerAddressType = peer_address_type_t::PUBLIC;
         const address_t peerAddress(peer_addr_bytes);
@@ -115,9 +119,8 @@ protected:
         chainable_gap_event_handler.onConnectionComplete(connection_complete_event);
     }
 
-    void simulate_disconnection_event(disconnection_reason_t reason)
+    void simulate_disconnection_event(disconnection_reason_t reason, connection_handle_t connectionHandle = 0)
     {
-        connection_handle_t connectionHandle = 0;
 
         DisconnectionCompleteEvent disconnection_complete_event(
                 connectionHandle,
@@ -131,10 +134,10 @@ protected:
             const uint8_t *data,
             uint16_t len,
             uint16_t offset = 0,
-            GattAuthCallbackReply_t authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS)
+            GattAuthCallbackReply_t authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS,
+            connection_handle_t connectionHandle = 0)
     {
-        connection_handle_t connectionHandle = 0;
-        GattServerMock::characteristic_t alert_level_char = gatt_server_mock().services[0].characteristics[0];
+        GattServerMock::characteristic_t &alert_level_char = gatt_server_mock().services[0].characteristics[0];
 
         GattWriteAuthCallbackParams write_request {
                 connectionHandle,
@@ -149,6 +152,26 @@ protected:
 
         return write_request.authorizationReply;
     }
+
+    uint8_t simulate_data_read_event(connection_handle_t connectionHandle)
+    {
+        GattServerMock::characteristic_t &alert_level_char = gatt_server_mock().services[0].characteristics[0];
+
+        GattReadAuthCallbackParams read_request {
+                connectionHandle,
+                alert_level_char.value_handle,
+                0,
+                0,
+                nullptr,
+                AUTH_CALLBACK_REPLY_SUCCESS
+        };
+
+        alert_level_char.read_cb(&read_request);
+
+        EXPECT_EQ(read_request.len, 1);
+
+        return *read_request.data;
+    }
 };
 
 TEST_F(TestLinkLossService, constructor)
@@ -232,6 +255,30 @@ TEST_F(TestLinkLossServiceEvents, disconnection_reconnection)
     event_queue.dispatch(1);
 }
 
+TEST_F(TestLinkLossServiceEvents, alert_timeout_with_pool_exhausted)
+{
+    link_loss_service->set_alert_timeout(minutes(1));
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    simulate_connection_event(BLE_ERROR_NONE);
+
+    // The application took every event of the pool of the event queue
+    event_queue.set_pool_size(0);
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+
+    // The alert timeout does not use the pool: the alert still ends on time
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(0);
+    event_queue.dispatch(59999);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_alert_end());
+    event_queue.dispatch(1);
+}
+
 TEST_F(TestLinkLossServiceEvents, disconnection_no_timeout)
 {
     // Set the alert timeout to 0
@@ -272,6 +319,19 @@ TEST_F(TestLinkLossServiceEvents, data_written_invalid)
     ASSERT_EQ(authorisationReply, GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_OUT_OF_RANGE);
 }
 
+TEST_F(TestLinkLossServiceEvents, data_written_invalid_length)
+{
+    const uint8_t data[2] = { static_cast<uint8_t>(LinkLossService::AlertLevel::HIGH_ALERT), 0 };
+
+    // Neither an empty nor a too long value is accepted
+    ASSERT_EQ(simulate_data_written_event(data, 0),
+              GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH);
+    ASSERT_EQ(simulate_data_written_event(data, sizeof(data)),
+              GattAuthCallbackReply_t::AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATTRIBUTE_VALUE_LENGTH);
+
+    ASSERT_EQ(link_loss_service->get_alert_level(0), LinkLossService::AlertLevel::NO_ALERT);
+}
+
 TEST_P(TestLinkLossServiceEvents, connection)
 {
     LinkLossService::AlertLevel alert_level = GetParam();
@@ -343,10 +403,378 @@ TEST_P(TestLinkLossServiceEvents, data_written)
 
     simulate_data_written_event(&data, len);
 
-    ASSERT_EQ(link_loss_service->get_alert_level(), alert_level);
+    ASSERT_EQ(link_loss_service->get_alert_level(0), alert_level);
+}
+
+TEST_F(TestLinkLossServiceEvents, alert_level_per_connection)
+{
+    link_loss_service->set_alert_timeout(minutes(1));
+
+    simulate_connection_event(BLE_ERROR_NONE, 0, 0x01);
+    simulate_connection_event(BLE_ERROR_NONE, 1, 0x02);
+
+    const uint8_t high = static_cast<uint8_t>(LinkLossService::AlertLevel::HIGH_ALERT);
+    const uint8_t mild = static_cast<uint8_t>(LinkLossService::AlertLevel::MILD_ALERT);
+
+    simulate_data_written_event(&high, sizeof(high), 0, AUTH_CALLBACK_REPLY_SUCCESS, 0);
+    simulate_data_written_event(&mild, sizeof(mild), 0, AUTH_CALLBACK_REPLY_SUCCESS, 1);
+
+    // The second client must not overwrite the level of the first one
+    EXPECT_EQ(link_loss_service->get_alert_level(0), LinkLossService::AlertLevel::HIGH_ALERT);
+    EXPECT_EQ(link_loss_service->get_alert_level(1), LinkLossService::AlertLevel::MILD_ALERT);
+
+    // Each client reads back its own level
+    EXPECT_EQ(simulate_data_read_event(0), high);
+    EXPECT_EQ(simulate_data_read_event(1), mild);
+
+    // Losing each link raises an alert with the level of that link
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::MILD_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 1);
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+
+    // Both alerts time out independently
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(2);
+
+    event_queue.dispatch(60000);
+}
+
+TEST_F(TestLinkLossServiceEvents, reconnection_of_other_peer)
+{
+    link_loss_service->set_alert_timeout(minutes(1));
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    simulate_connection_event(BLE_ERROR_NONE, 0, 0x01);
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+
+    // A different peer connecting, even reusing the connection handle, does not end the alert
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(0);
+    simulate_connection_event(BLE_ERROR_NONE, 0, 0x02);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The lost peer coming back does
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(1);
+    simulate_connection_event(BLE_ERROR_NONE, 1, 0x01);
+}
+
+TEST_F(TestLinkLossServiceEvents, alerts_of_peers_with_unknown_address)
+{
+    link_loss_service->set_alert_timeout(minutes(1));
+
+    // Two clients write an alert level on links established before the service listened to Gap
+    const uint8_t level = (uint8_t)LinkLossService::AlertLevel::HIGH_ALERT;
+    simulate_data_written_event(&level, sizeof(level), 0, AUTH_CALLBACK_REPLY_SUCCESS, 0);
+    simulate_data_written_event(&level, sizeof(level), 0, AUTH_CALLBACK_REPLY_SUCCESS, 1);
+
+    // Their addresses are unknown: each lost link gets its own alert
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT))
+            .Times(2);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 1);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // and any peer connecting may be one of them, both alerts end
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(2);
+    simulate_connection_event(BLE_ERROR_NONE, 2, 0x03);
+}
+
+TEST_F(TestLinkLossServiceEvents, full_alert_table)
+{
+    // Without timeout, the alerts only end when their peer comes back
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT))
+            .Times(MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS);
+    for (connection_handle_t handle = 0; handle < MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS; handle++) {
+        simulate_connection_event(BLE_ERROR_NONE, handle, 0x01 + handle);
+        simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, handle);
+    }
+    EXPECT_EQ(link_loss_service->get_overflow_count(), 0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // One more peer is lost, the alert of the first one makes room for its own
+    {
+        InSequence sequence;
+        EXPECT_CALL(event_handler_mock, on_alert_end());
+        EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    }
+    simulate_connection_event(BLE_ERROR_NONE, 0, 0x10);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+    EXPECT_EQ(link_loss_service->get_overflow_count(), 1);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The first peer has no alert left to end, the second one does
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(0);
+    simulate_connection_event(BLE_ERROR_NONE, 0, 0x01);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_alert_end());
+    simulate_connection_event(BLE_ERROR_NONE, 1, 0x02);
+}
+
+TEST_F(TestLinkLossServiceEvents, full_connection_table)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    for (connection_handle_t handle = 0; handle < MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS; handle++) {
+        simulate_connection_event(BLE_ERROR_NONE, handle, 0x01 + handle);
+    }
+    EXPECT_EQ(link_loss_service->get_overflow_count(), 0);
+
+    // The link beyond the table is not monitored, and counted
+    const connection_handle_t untracked = MBED_CONF_BLE_SERVICE_LINK_LOSS_MAX_CONNECTIONS;
+    simulate_connection_event(BLE_ERROR_NONE, untracked, 0x10);
+    EXPECT_EQ(link_loss_service->get_overflow_count(), 1);
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested)
+            .Times(0);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, untracked);
+}
+
+TEST_F(TestLinkLossServiceEvents, set_alert_timeout_rearms_alerts)
+{
+    link_loss_service->set_alert_timeout(minutes(1));
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    simulate_connection_event(BLE_ERROR_NONE, 0, 0x01);
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+
+    event_queue.dispatch(30000);
+
+    // The alert in progress now ends 10 s from now instead of 30 s
+    link_loss_service->set_alert_timeout(seconds(10));
+
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(0);
+    event_queue.dispatch(9999);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(1);
+    event_queue.dispatch(1);
+
+    // The timer wheel stops ticking once no alert is pending
+    EXPECT_EQ(event_queue.size(), 0);
+}
+
+struct AlertDispatcherHandlerMock : AlertDispatcher::EventHandler {
+    MOCK_METHOD(void, on_alert_changed, (AlertLevel, uint8_t), (override));
+};
+
+TEST_F(TestLinkLossServiceEvents, alerts_requested_from_dispatcher)
+{
+    AlertDispatcher alert_dispatcher(event_queue);
+    AlertDispatcherHandlerMock dispatcher_handler_mock;
+    alert_dispatcher.set_event_handler(&dispatcher_handler_mock);
+
+    link_loss_service->set_alert_dispatcher(&alert_dispatcher);
+
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::MILD_ALERT);
+    simulate_connection_event(BLE_ERROR_NONE, 0, 0x01);
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+    simulate_connection_event(BLE_ERROR_NONE, 1, 0x02);
+
+    // The event handler hears of each link lost
+    EXPECT_CALL(event_handler_mock, on_alert_requested)
+            .Times(2);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 1);
+
+    // while the dispatcher raises a single alert, at the highest level
+    EXPECT_CALL(dispatcher_handler_mock, on_alert_changed(AlertLevel::HIGH_ALERT, AlertDispatcher::LINK_LOSS));
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&dispatcher_handler_mock);
+
+    // The alert ends with the last alert of the service
+    EXPECT_CALL(event_handler_mock, on_alert_end())
+            .Times(2);
+    EXPECT_CALL(dispatcher_handler_mock, on_alert_changed(AlertLevel::NO_ALERT, 0));
+    link_loss_service->stop_alert();
+    event_queue.dispatch(0);
+
+    link_loss_service->set_alert_dispatcher(nullptr);
 }
 
 INSTANTIATE_TEST_SUITE_P(Expected, TestLinkLossServiceEvents,
                          Values(LinkLossService::AlertLevel::NO_ALERT,
                                 LinkLossService::AlertLevel::MILD_ALERT,
-                                LinkLossService::AlertLevel::HIGH_ALERT));
\ No newline at end of file
+                                LinkLossService::AlertLevel::HIGH_ALERT));
+
+/* the callbacks of the service run in the BLE stack and the event queue and must not allocate */
+class TestLinkLossServiceAllocations : public TestLinkLossServiceEvents {
+protected:
+    struct AlertHandler : LinkLossService::EventHandler {
+        void on_alert_requested(LinkLossService::AlertLevel) override { }
+        void on_alert_end() override { }
+    } alert_handler;
+
+    void SetUp()
+    {
+        TestLinkLossServiceEvents::SetUp();
+
+        link_loss_service->set_event_handler(&alert_handler);
+        link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+        link_loss_service->set_alert_timeout(60s);
+    }
+};
+
+TEST_F(TestLinkLossServiceAllocations, data_written_read)
+{
+    simulate_connection_event(BLE_ERROR_NONE, 0);
+
+    const uint8_t level = 1;
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_data_written_event(&level, sizeof(level)); }), 0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_data_read_event(0); }), 0);
+}
+
+TEST_F(TestLinkLossServiceAllocations, connection_disconnection)
+{
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_connection_event(BLE_ERROR_NONE, 0, 0x01); }), 0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_connection_event(BLE_ERROR_NONE, 1, 0x02); }), 0);
+
+    /* the first alert starts the alert timeouts, the second one shares them */
+    ASSERT_EQ(allocation_tracker::allocations_in([&] {
+        simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+    }), 0);
+    ASSERT_EQ(allocation_tracker::allocations_in([&] {
+        simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 1);
+    }), 0);
+
+    /* the reconnection ends an alert */
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { simulate_connection_event(BLE_ERROR_NONE, 0, 0x01); }), 0);
+}
+
+TEST_F(TestLinkLossServiceAllocations, alert_timeout)
+{
+    simulate_connection_event(BLE_ERROR_NONE, 0);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+
+    /* the periodic tick is queued again without allocating */
+    ASSERT_EQ(allocation_tracker::allocations_in([&] { event_queue.dispatch(60000); }), 0);
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+/* the handler is the service itself, its events are called without a vtable */
+class CountingLinkLossService : public BasicLinkLossService<CountingLinkLossService> {
+public:
+    using BasicLinkLossService::BasicLinkLossService;
+
+    std::vector<AlertLevel> alerts_requested;
+    int alerts_ended = 0;
+
+private:
+    friend class BasicLinkLossService<CountingLinkLossService>;
+
+    void on_alert_requested(AlertLevel level)
+    {
+        alerts_requested.push_back(level);
+    }
+
+    void on_alert_end()
+    {
+        alerts_ended++;
+    }
+};
+
+/* a handler hiding nothing keeps the empty handlers of the template */
+class SilentLinkLossService : public BasicLinkLossService<SilentLinkLossService> {
+public:
+    using BasicLinkLossService::BasicLinkLossService;
+};
+
+class TestBasicLinkLossService : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    ChainableGapEventHandler chainable_gap_event_handler;
+
+    void TearDown()
+    {
+        ble::delete_mocks();
+    }
+
+    void connect(connection_handle_t connection_handle)
+    {
+        const uint8_t peer_address[] = {0xfb, 0xdd, 0x62, 0x03, 0x04, 0xd8};
+        const uint8_t local_address[] = {0x4d, 0xc7, 0x92, 0x0e, 0x51, 0xba};
+
+        ConnectionCompleteEvent event(
+                BLE_ERROR_NONE,
+                connection_handle,
+                connection_role_t::PERIPHERAL,
+                peer_address_type_t::PUBLIC,
+                address_t(peer_address),
+                address_t(local_address),
+                address_t(peer_address),
+                conn_interval_t(50),
+                slave_latency_t::min(),
+                supervision_timeout_t(100),
+                100
+        );
+
+        chainable_gap_event_handler.onConnectionComplete(event);
+    }
+
+    void disconnect(connection_handle_t connection_handle, disconnection_reason_t reason)
+    {
+        DisconnectionCompleteEvent event(connection_handle, reason);
+
+        chainable_gap_event_handler.onDisconnectionComplete(event);
+    }
+};
+
+TEST_F(TestBasicLinkLossService, static_handler)
+{
+    CountingLinkLossService service(BLE::Instance(), event_queue, chainable_gap_event_handler);
+    ASSERT_EQ(service.init(), BLE_ERROR_NONE);
+
+    service.set_alert_level(CountingLinkLossService::AlertLevel::MILD_ALERT);
+    service.set_alert_timeout(seconds(10));
+
+    connect(0);
+    disconnect(0, disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION);
+    EXPECT_TRUE(service.alerts_requested.empty());
+
+    connect(0);
+    disconnect(0, disconnection_reason_t::CONNECTION_TIMEOUT);
+    ASSERT_EQ(service.alerts_requested.size(), 1);
+    EXPECT_EQ(service.alerts_requested[0], CountingLinkLossService::AlertLevel::MILD_ALERT);
+    EXPECT_EQ(service.alerts_ended, 0);
+
+    event_queue.dispatch(10000);
+    EXPECT_EQ(service.alerts_ended, 1);
+    EXPECT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestBasicLinkLossService, empty_handler)
+{
+    SilentLinkLossService service(BLE::Instance(), event_queue, chainable_gap_event_handler);
+    ASSERT_EQ(service.init(), BLE_ERROR_NONE);
+
+    service.set_alert_level(SilentLinkLossService::AlertLevel::HIGH_ALERT);
+    service.set_alert_timeout(seconds(10));
+
+    /* the alert is still tracked and timed out without anyone listening */
+    connect(0);
+    disconnect(0, disconnection_reason_t::CONNECTION_TIMEOUT);
+    EXPECT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(10000);
+    EXPECT_EQ(event_queue.size(), 0);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LinkLossServiceTest.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ble;
+using namespace events;
+using namespace std::chrono;
+
+/* built with the command mailbox enabled, it holds eight commands */
+class TestLinkLossServiceCommandMailbox : public LinkLossServiceTest {
+};
+
+TEST_F(TestLinkLossServiceCommandMailbox, alert_level_set_from_event_queue)
+{
+    ASSERT_TRUE(link_loss_service->post_set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT));
+
+    // The service is left alone until the event queue runs
+    EXPECT_EQ(link_loss_service->get_alert_level(), LinkLossService::AlertLevel::NO_ALERT);
+
+    event_queue.dispatch(0);
+
+    EXPECT_EQ(link_loss_service->get_alert_level(), LinkLossService::AlertLevel::HIGH_ALERT);
+}
+
+TEST_F(TestLinkLossServiceCommandMailbox, full_mailbox_refuses_commands)
+{
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(link_loss_service->post_set_alert_level(LinkLossService::AlertLevel::MILD_ALERT));
+    }
+
+    ASSERT_FALSE(link_loss_service->post_set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT));
+
+    event_queue.dispatch(0);
+
+    // The refused command was never applied
+    EXPECT_EQ(link_loss_service->get_alert_level(), LinkLossService::AlertLevel::MILD_ALERT);
+}
+
+TEST_F(TestLinkLossServiceCommandMailbox, commands_from_concurrent_threads)
+{
+    // A user interface thread sets the level while a settings thread sets the timeout
+    std::vector<std::thread> producers;
+    producers.emplace_back([this] {
+        for (int i = 0; i < 3; i++) {
+            EXPECT_TRUE(link_loss_service->post_set_alert_level(LinkLossService::AlertLevel::MILD_ALERT));
+        }
+        EXPECT_TRUE(link_loss_service->post_set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT));
+    });
+    producers.emplace_back([this] {
+        for (int i = 0; i < 3; i++) {
+            EXPECT_TRUE(link_loss_service->post_set_alert_timeout(milliseconds(5000)));
+        }
+        EXPECT_TRUE(link_loss_service->post_set_alert_timeout(milliseconds(1000)));
+    });
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    event_queue.dispatch(0);
+
+    // The last command of each thread wins
+    EXPECT_EQ(link_loss_service->get_alert_level(), LinkLossService::AlertLevel::HIGH_ALERT);
+
+    simulate_connection_event();
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_alert_end());
+    event_queue.dispatch(1000);
+}
+
+TEST_F(TestLinkLossServiceCommandMailbox, alert_stopped_from_another_thread)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+    simulate_connection_event();
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+
+    // A button handled by another thread stops the alert
+    std::thread button([this] { EXPECT_TRUE(link_loss_service->post_stop_alert()); });
+    button.join();
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_alert_end());
+    event_queue.dispatch(0);
+}
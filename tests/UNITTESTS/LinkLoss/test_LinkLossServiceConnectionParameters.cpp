@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LinkLossServiceTest.h"
+
+using namespace ble;
+using namespace events;
+
+using ::testing::_;
+using ::testing::Return;
+
+/* conn_interval_t, slave_latency_t and supervision_timeout_t in their units of 1.25 ms, events and 10 ms */
+MATCHER_P(HasValue, value, "")
+{
+    return arg.value() == value;
+}
+
+/* the parameters configured in CMakeLists.txt */
+struct Parameters {
+    uint16_t min_interval;
+    uint16_t max_interval;
+    uint16_t latency;
+    uint16_t supervision_timeout;
+};
+
+static const Parameters ALERT = { 24, 40, 0, 100 };
+static const Parameters IDLE = { 320, 400, 3, 600 };
+
+class TestLinkLossServiceConnectionParameters : public LinkLossServiceTest {
+protected:
+    void expect_request(const Parameters &parameters, connection_handle_t connectionHandle = 0, int times = 1)
+    {
+        EXPECT_CALL(gap_mock(), updateConnectionParameters(
+                connectionHandle,
+                HasValue(parameters.min_interval),
+                HasValue(parameters.max_interval),
+                HasValue(parameters.latency),
+                HasValue(parameters.supervision_timeout),
+                _, _))
+                .Times(times);
+    }
+
+    void expect_no_request()
+    {
+        EXPECT_CALL(gap_mock(), updateConnectionParameters).Times(0);
+    }
+
+    void verify()
+    {
+        testing::Mock::VerifyAndClearExpectations(&gap_mock());
+    }
+
+    void simulate_connection_event(uint16_t interval, uint16_t latency, uint16_t supervision_timeout,
+                                   connection_handle_t connectionHandle = 0)
+    {
+        LinkLossServiceTest::simulate_connection_event(connectionHandle, peer_addr_byte(connectionHandle),
+                                                       interval, latency, supervision_timeout);
+    }
+
+    void simulate_connection_event(const Parameters &parameters, connection_handle_t connectionHandle = 0)
+    {
+        simulate_connection_event(parameters.max_interval, parameters.latency, parameters.supervision_timeout,
+                                  connectionHandle);
+    }
+
+    void simulate_update_complete_event(ble_error_t status, uint16_t interval, uint16_t latency,
+                                        uint16_t supervision_timeout, connection_handle_t connectionHandle = 0)
+    {
+        ConnectionParametersUpdateCompleteEvent update_complete_event(
+                status,
+                connectionHandle,
+                conn_interval_t(interval),
+                slave_latency_t(latency),
+                supervision_timeout_t(supervision_timeout)
+        );
+
+        chainable_gap_event_handler.onConnectionParametersUpdateComplete(update_complete_event);
+    }
+
+    void simulate_update_complete_event(const Parameters &parameters, connection_handle_t connectionHandle = 0)
+    {
+        simulate_update_complete_event(BLE_ERROR_NONE, parameters.max_interval, parameters.latency,
+                                       parameters.supervision_timeout, connectionHandle);
+    }
+};
+
+TEST_F(TestLinkLossServiceConnectionParameters, idle_parameters_requested_on_connection)
+{
+    // A link without alert level, connected with a 50 ms interval and a 4 s supervision timeout, is relaxed
+    expect_request(IDLE);
+    simulate_connection_event(40, 0, 400);
+
+    verify();
+
+    // Once in effect, nothing more is requested
+    expect_no_request();
+    simulate_update_complete_event(IDLE);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, alert_parameters_requested_on_connection)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::MILD_ALERT);
+
+    expect_request(ALERT);
+    simulate_connection_event(IDLE);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, no_request_if_parameters_in_effect)
+{
+    expect_no_request();
+    simulate_connection_event(IDLE);
+
+    // The central may pick any interval of the range
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+    simulate_connection_event(30, ALERT.latency, ALERT.supervision_timeout, 1);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, alert_level_written_switches_parameters)
+{
+    simulate_connection_event(IDLE);
+
+    // Writing an alert level tightens the supervision timeout
+    expect_request(ALERT);
+    simulate_data_written_event(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    verify();
+
+    expect_no_request();
+    simulate_update_complete_event(ALERT);
+
+    // Changing between alert levels does not change the parameters
+    simulate_data_written_event(LinkLossService::AlertLevel::MILD_ALERT);
+
+    verify();
+
+    // Clearing it relaxes the link again
+    expect_request(IDLE);
+    simulate_data_written_event(LinkLossService::AlertLevel::NO_ALERT);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, one_request_at_a_time)
+{
+    simulate_connection_event(IDLE);
+
+    expect_request(ALERT);
+    simulate_data_written_event(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    verify();
+
+    // The client changes its mind while the update is in progress: nothing is requested until it completes
+    expect_no_request();
+    simulate_data_written_event(LinkLossService::AlertLevel::NO_ALERT);
+
+    verify();
+
+    // then the idle parameters are requested back
+    expect_request(IDLE);
+    simulate_update_complete_event(ALERT);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, rejected_request_retried_a_few_times)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    // The peer rejects the parameters every time, they are requested three times in all
+    expect_request(ALERT, 0, 3);
+
+    simulate_connection_event(IDLE);
+    for (int i = 0; i < 5; i++) {
+        simulate_update_complete_event(BLE_ERROR_INVALID_PARAM, IDLE.max_interval, IDLE.latency,
+                                       IDLE.supervision_timeout);
+    }
+
+    verify();
+
+    // The idle parameters are still in effect when the alert level is cleared
+    expect_no_request();
+    simulate_data_written_event(LinkLossService::AlertLevel::NO_ALERT);
+
+    verify();
+
+    // and setting it again requests the alert parameters afresh
+    expect_request(ALERT);
+    simulate_data_written_event(LinkLossService::AlertLevel::HIGH_ALERT);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, amended_parameters_accepted_eventually)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    expect_request(ALERT, 0, 3);
+
+    simulate_connection_event(IDLE);
+
+    // The central settles on a longer supervision timeout than requested
+    for (int i = 0; i < 5; i++) {
+        simulate_update_complete_event(BLE_ERROR_NONE, ALERT.max_interval, ALERT.latency, 200);
+    }
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, peer_update_reverted)
+{
+    simulate_connection_event(IDLE);
+
+    // The central changes the parameters on its own, the policy requests its own back
+    expect_request(IDLE);
+    simulate_update_complete_event(BLE_ERROR_NONE, 80, 0, 400);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, failed_request_retried_on_next_event)
+{
+    simulate_connection_event(IDLE);
+
+    // The stack is busy and refuses to send the request
+    EXPECT_CALL(gap_mock(), updateConnectionParameters)
+            .WillOnce(Return(BLE_ERROR_INVALID_STATE));
+    simulate_data_written_event(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    verify();
+
+    // The next parameter event tries again, it is not mistaken for the outcome of a pending request
+    expect_request(ALERT);
+    simulate_update_complete_event(IDLE);
+}
+
+TEST_F(TestLinkLossServiceConnectionParameters, parameters_per_connection)
+{
+    simulate_connection_event(IDLE, 0);
+    simulate_connection_event(IDLE, 1);
+
+    // Only the link with an alert level is tightened
+    expect_request(ALERT, 1);
+    simulate_data_written_event(LinkLossService::AlertLevel::HIGH_ALERT, 1);
+
+    verify();
+
+    // Events of unknown connections are ignored
+    expect_no_request();
+    simulate_update_complete_event(BLE_ERROR_NONE, 80, 0, 400, 2);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LinkLossServiceTest.h"
+
+using namespace ble;
+using namespace events;
+
+using ::testing::InSequence;
+
+/* built with deferred events enabled */
+class TestLinkLossServiceDeferredEvents : public LinkLossServiceTest {
+protected:
+    void SetUp() override
+    {
+        LinkLossServiceTest::SetUp();
+        link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+    }
+};
+
+TEST_F(TestLinkLossServiceDeferredEvents, alert_requested_from_event_queue)
+{
+    simulate_connection_event();
+
+    // Nothing is called from the disconnection event
+    EXPECT_CALL(event_handler_mock, on_alert_requested)
+            .Times(0);
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The handler is called once the event queue runs
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestLinkLossServiceDeferredEvents, handler_not_called_from_stack)
+{
+    bool in_stack_callback = false;
+    bool in_dispatch = false;
+    int calls_from_stack = 0;
+    int calls_from_dispatch = 0;
+
+    // Driving a buzzer takes a while, the stack must not wait for it
+    EXPECT_CALL(event_handler_mock, on_alert_requested)
+            .WillOnce([&](LinkLossService::AlertLevel) {
+                calls_from_stack += in_stack_callback;
+                calls_from_dispatch += in_dispatch;
+            });
+
+    simulate_connection_event();
+
+    in_stack_callback = true;
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+    in_stack_callback = false;
+
+    in_dispatch = true;
+    event_queue.dispatch(0);
+    in_dispatch = false;
+
+    EXPECT_EQ(calls_from_stack, 0);
+    EXPECT_EQ(calls_from_dispatch, 1);
+}
+
+TEST_F(TestLinkLossServiceDeferredEvents, alert_ended_before_dispatch_not_reported)
+{
+    simulate_connection_event();
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+
+    // The peer comes back before the event queue ran, the handlers never hear of its alert
+    simulate_connection_event(1, peer_addr_byte(0));
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested)
+            .Times(0);
+    EXPECT_CALL(event_handler_mock, on_alert_end)
+            .Times(0);
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestLinkLossServiceDeferredEvents, state_updated_immediately)
+{
+    simulate_connection_event();
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The alert is stopped before the handlers are told, losing the peer again raises a new one
+    link_loss_service->stop_alert();
+    simulate_connection_event(1, peer_addr_byte(0));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 1);
+
+    {
+        InSequence sequence;
+        EXPECT_CALL(event_handler_mock, on_alert_end());
+        EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    }
+    event_queue.dispatch(0);
+}
+
+TEST_F(TestLinkLossServiceDeferredEvents, burst_of_events_not_dropped)
+{
+    // Four peers, the last one with a mild alert level, are lost
+    for (connection_handle_t handle = 0; handle < 4; handle++) {
+        if (handle == 3) {
+            link_loss_service->set_alert_level(LinkLossService::AlertLevel::MILD_ALERT);
+        }
+        simulate_connection_event(handle, 0xd0 + handle);
+        simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, handle);
+    }
+
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT))
+            .Times(3);
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::MILD_ALERT));
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // They all come back, then are lost again before the event queue runs, raising eight events
+    for (connection_handle_t handle = 4; handle < 8; handle++) {
+        simulate_connection_event(handle, 0xd0 + handle - 4);
+    }
+    for (connection_handle_t handle = 4; handle < 8; handle++) {
+        simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, handle);
+    }
+
+    // Every alert dispatched ends before the alerts in progress are requested
+    {
+        InSequence sequence;
+        EXPECT_CALL(event_handler_mock, on_alert_end())
+                .Times(4);
+        EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::MILD_ALERT))
+                .Times(4);
+    }
+    event_queue.dispatch(0);
+}
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LinkLossServiceTest.h"
+
+#include "ble-service-link-loss/RssiDetector.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ble;
+using namespace events;
+
+using ::testing::InSequence;
+
+/* the detector of the service, as configured in CMakeLists.txt */
+using Detector = RssiDetector<-80, 6, 2, 3>;
+using Transition = Detector::Transition;
+
+/* RSSI sampled every 100 ms while the peer walks away at 1 dB per sample, with a few dB of fading */
+static std::vector<int8_t> walk_away_trace()
+{
+    static const int8_t fading[] = { 0, -3, 1, -2, 2, -4, 0, 1, -1, 3 };
+
+    std::vector<int8_t> trace;
+    for (int i = 0; i <= 36; i++) {
+        trace.push_back(static_cast<int8_t>(-60 - i + fading[i % 10]));
+    }
+
+    return trace;
+}
+
+/* index of the first sample raising the warning of a fresh detector, or the size of the trace */
+template<typename D>
+static size_t warning_index(const std::vector<int8_t> &trace)
+{
+    D detector;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        if (detector.add_sample(trace[i]) == D::Transition::WARNING_RAISED) {
+            return i;
+        }
+    }
+
+    return trace.size();
+}
+
+TEST(TestRssiDetector, no_warning_in_range)
+{
+    Detector detector;
+
+    for (int8_t rssi : { -55, -60, -58, -72, -65, -61, -59, -70, -66, -63 }) {
+        EXPECT_EQ(detector.add_sample(rssi), Transition::NONE);
+    }
+
+    EXPECT_FALSE(detector.warning());
+    EXPECT_LE(detector.average(), -55);
+    EXPECT_GE(detector.average(), -72);
+}
+
+TEST(TestRssiDetector, walk_away_raises_warning)
+{
+    const std::vector<int8_t> trace = walk_away_trace();
+
+    size_t index = warning_index<Detector>(trace);
+
+    // The warning is raised before the peer reaches the sensitivity of the receiver, at the end of the trace
+    ASSERT_LT(index, trace.size());
+
+    // but not before the RSSI is actually around the threshold
+    EXPECT_LE(trace[index], -76);
+}
+
+TEST(TestRssiDetector, fade_does_not_raise_warning)
+{
+    Detector detector;
+
+    // Deep fades of one or two samples are smoothed out
+    for (int8_t rssi : { -70, -70, -95, -70, -70, -70, -96, -94, -70, -70, -70, -70 }) {
+        EXPECT_EQ(detector.add_sample(rssi), Transition::NONE);
+    }
+
+    EXPECT_FALSE(detector.warning());
+}
+
+TEST(TestRssiDetector, hysteresis_prevents_chattering)
+{
+    Detector detector;
+
+    size_t raised = 0;
+    size_t cleared = 0;
+
+    // The RSSI hovers around the threshold, a few dB either way
+    for (int repeat = 0; repeat < 20; repeat++) {
+        for (int8_t rssi : { -78, -83, -79, -84, -77, -82 }) {
+            Transition transition = detector.add_sample(rssi);
+            raised += (transition == Transition::WARNING_RAISED);
+            cleared += (transition == Transition::WARNING_CLEARED);
+        }
+    }
+
+    EXPECT_EQ(raised, 1);
+    EXPECT_EQ(cleared, 0);
+    EXPECT_TRUE(detector.warning());
+}
+
+TEST(TestRssiDetector, recovery_clears_warning)
+{
+    Detector detector;
+
+    for (int i = 0; i < 10; i++) {
+        detector.add_sample(-90);
+    }
+    ASSERT_TRUE(detector.warning());
+
+    // Back just above the threshold is not enough
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(detector.add_sample(-76), Transition::NONE);
+    }
+
+    // Back above the hysteresis, the warning clears once the average caught up and stayed there
+    std::vector<Transition> transitions;
+    for (int i = 0; i < 10; i++) {
+        transitions.push_back(detector.add_sample(-65));
+    }
+
+    EXPECT_EQ(std::count(transitions.begin(), transitions.end(), Transition::WARNING_CLEARED), 1);
+    EXPECT_FALSE(detector.warning());
+}
+
+TEST(TestRssiDetector, unavailable_samples_ignored)
+{
+    Detector detector;
+
+    EXPECT_EQ(detector.average(), Detector::RSSI_NOT_AVAILABLE);
+
+    for (int i = 0; i < 10; i++) {
+        detector.add_sample(-90);
+        EXPECT_EQ(detector.add_sample(Detector::RSSI_NOT_AVAILABLE), Transition::NONE);
+    }
+
+    EXPECT_TRUE(detector.warning());
+    EXPECT_EQ(detector.average(), -90);
+
+    detector.reset();
+
+    EXPECT_FALSE(detector.warning());
+    EXPECT_EQ(detector.average(), Detector::RSSI_NOT_AVAILABLE);
+}
+
+TEST(TestRssiDetector, smoothing_and_samples_delay_warning)
+{
+    using Immediate = RssiDetector<-80, 6, 0, 1>;
+    using Smoothed  = RssiDetector<-80, 6, 3, 1>;
+    using Debounced = RssiDetector<-80, 6, 0, 4>;
+
+    std::vector<int8_t> trace(10, -70);
+    trace.resize(20, -90);
+
+    // Without smoothing nor debouncing the first sample below the threshold raises the warning
+    EXPECT_EQ(warning_index<Immediate>(trace), 10);
+    // the average takes a few samples to follow a step
+    EXPECT_GT(warning_index<Smoothed>(trace), 10);
+    // and so does the number of samples below the threshold required
+    EXPECT_EQ(warning_index<Debounced>(trace), 13);
+}
+
+class TestLinkLossServiceEarlyWarning : public LinkLossServiceTest {
+protected:
+    void add_rssi_samples(int8_t rssi, size_t count, connection_handle_t connectionHandle = 0)
+    {
+        for (size_t i = 0; i < count; i++) {
+            link_loss_service->add_rssi_sample(connectionHandle, rssi);
+        }
+    }
+};
+
+TEST_F(TestLinkLossServiceEarlyWarning, pre_alert_seconds_before_link_loss)
+{
+    const int sample_interval_ms = 100;
+    const int supervision_timeout_ms = 4000;
+
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    simulate_connection_event();
+
+    int now_ms = 0;
+    int pre_alert_ms = -1;
+
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT))
+            .WillOnce([&](LinkLossService::AlertLevel) { pre_alert_ms = now_ms; });
+
+    // The peer walks away, its last packet is received at the end of the trace
+    for (int8_t rssi : walk_away_trace()) {
+        link_loss_service->add_rssi_sample(0, rssi);
+        now_ms += sample_interval_ms;
+    }
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The link is reported lost a supervision timeout later, the pre-alert ends when the alert starts
+    now_ms += supervision_timeout_ms;
+    {
+        InSequence sequence;
+        EXPECT_CALL(event_handler_mock, on_pre_alert_end());
+        EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    }
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+
+    ASSERT_GE(pre_alert_ms, 0);
+
+    // The pre-alert came more than the supervision timeout ahead of the alert
+    EXPECT_GT(now_ms - pre_alert_ms, supervision_timeout_ms);
+}
+
+TEST_F(TestLinkLossServiceEarlyWarning, pre_alert_ends_on_recovery)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::MILD_ALERT);
+
+    simulate_connection_event();
+
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested(LinkLossService::AlertLevel::MILD_ALERT));
+    add_rssi_samples(-90, 10);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    EXPECT_CALL(event_handler_mock, on_pre_alert_end());
+    add_rssi_samples(-60, 10);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // The peer walking back does not raise an alert when it disconnects
+    EXPECT_CALL(event_handler_mock, on_pre_alert_end())
+            .Times(0);
+    EXPECT_CALL(event_handler_mock, on_alert_requested)
+            .Times(0);
+    simulate_disconnection_event(disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION);
+}
+
+struct AlertDispatcherHandlerMock : AlertDispatcher::EventHandler {
+    MOCK_METHOD(void, on_alert_changed, (AlertLevel, uint8_t), (override));
+};
+
+TEST_F(TestLinkLossServiceEarlyWarning, pre_alert_requested_as_out_of_range)
+{
+    AlertDispatcher alert_dispatcher(event_queue);
+    AlertDispatcherHandlerMock dispatcher_handler_mock;
+    alert_dispatcher.set_event_handler(&dispatcher_handler_mock);
+
+    link_loss_service->set_alert_dispatcher(&alert_dispatcher);
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::MILD_ALERT);
+
+    simulate_connection_event();
+
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested(LinkLossService::AlertLevel::MILD_ALERT));
+    EXPECT_CALL(dispatcher_handler_mock, on_alert_changed(AlertLevel::MILD_ALERT, AlertDispatcher::OUT_OF_RANGE));
+    add_rssi_samples(-90, 10);
+    event_queue.dispatch(0);
+
+    testing::Mock::VerifyAndClearExpectations(&dispatcher_handler_mock);
+
+    // The link is lost: the out-of-range alert turns into a link loss alert in a single change
+    EXPECT_CALL(event_handler_mock, on_pre_alert_end());
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::MILD_ALERT));
+    EXPECT_CALL(dispatcher_handler_mock, on_alert_changed(AlertLevel::MILD_ALERT, AlertDispatcher::LINK_LOSS));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT);
+    event_queue.dispatch(0);
+
+    link_loss_service->set_alert_dispatcher(nullptr);
+}
+
+TEST_F(TestLinkLossServiceEarlyWarning, pre_alert_ends_on_graceful_disconnection)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    simulate_connection_event();
+
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    add_rssi_samples(-90, 10);
+
+    EXPECT_CALL(event_handler_mock, on_pre_alert_end());
+    EXPECT_CALL(event_handler_mock, on_alert_requested)
+            .Times(0);
+    simulate_disconnection_event(disconnection_reason_t::REMOTE_USER_TERMINATED_CONNECTION);
+}
+
+TEST_F(TestLinkLossServiceEarlyWarning, pre_alert_follows_alert_level)
+{
+    simulate_connection_event();
+
+    // A link without alert level fading requests nothing
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested)
+            .Times(0);
+    add_rssi_samples(-90, 10);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // until its client sets an alert level
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_data_written_event(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // and the pre-alert ends if the client clears it
+    EXPECT_CALL(event_handler_mock, on_pre_alert_end());
+    simulate_data_written_event(LinkLossService::AlertLevel::NO_ALERT);
+}
+
+TEST_F(TestLinkLossServiceEarlyWarning, pre_alert_per_connection)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    simulate_connection_event(0);
+    simulate_connection_event(1);
+
+    // Only the link fading requests a pre-alert
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT))
+            .Times(1);
+    for (int i = 0; i < 10; i++) {
+        link_loss_service->add_rssi_sample(0, -60);
+        link_loss_service->add_rssi_sample(1, -90);
+    }
+
+    testing::Mock::VerifyAndClearExpectations(&event_handler_mock);
+
+    // and losing the other one raises the alert alone
+    EXPECT_CALL(event_handler_mock, on_pre_alert_end())
+            .Times(0);
+    EXPECT_CALL(event_handler_mock, on_alert_requested(LinkLossService::AlertLevel::HIGH_ALERT));
+    simulate_disconnection_event(disconnection_reason_t::CONNECTION_TIMEOUT, 0);
+}
+
+TEST_F(TestLinkLossServiceEarlyWarning, samples_of_unknown_connection_ignored)
+{
+    link_loss_service->set_alert_level(LinkLossService::AlertLevel::HIGH_ALERT);
+
+    EXPECT_CALL(event_handler_mock, on_pre_alert_requested)
+            .Times(0);
+    add_rssi_samples(-90, 10, 3);
+
+    // A connection established afterwards starts afresh
+    simulate_connection_event(3);
+    add_rssi_samples(-60, 1, 3);
+}
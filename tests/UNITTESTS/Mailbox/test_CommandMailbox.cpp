@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gtest/gtest.h"
+
+#include "ble/common/CommandMailbox.h"
+
+#include <thread>
+#include <vector>
+
+using namespace ble;
+
+class TestCommandMailbox : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    std::vector<int> handled;
+    CommandMailbox<int, 4> mailbox{event_queue, [this](const int &command) { handled.push_back(command); }};
+};
+
+TEST_F(TestCommandMailbox, commands_handled_from_event_queue)
+{
+    ASSERT_TRUE(mailbox.post(1));
+    ASSERT_TRUE(mailbox.post(2));
+
+    // Nothing is handled from post() and a single event handles the commands in order
+    ASSERT_TRUE(handled.empty());
+    ASSERT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2}));
+    ASSERT_EQ(event_queue.size(), 0);
+
+    // The next command schedules the mailbox again
+    ASSERT_TRUE(mailbox.post(3));
+    ASSERT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2, 3}));
+}
+
+TEST_F(TestCommandMailbox, full_mailbox_refuses_commands)
+{
+    for (int i = 1; i <= 4; i++) {
+        ASSERT_TRUE(mailbox.post(i));
+    }
+
+    // The caller learns that the command is dropped, nothing is handled from post() to make room
+    ASSERT_FALSE(mailbox.post(5));
+    ASSERT_TRUE(handled.empty());
+
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2, 3, 4}));
+    ASSERT_TRUE(mailbox.post(5));
+}
+
+TEST_F(TestCommandMailbox, pool_exhausted)
+{
+    event_queue.set_pool_size(0);
+
+    // The mailbox is scheduled with its own events, the pool of the event queue is not used
+    ASSERT_TRUE(mailbox.post(1));
+    event_queue.dispatch(0);
+    ASSERT_TRUE(mailbox.post(2));
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2}));
+}
+
+TEST_F(TestCommandMailbox, commands_posted_by_handler)
+{
+    CommandMailbox<int, 2> *self = nullptr;
+    CommandMailbox<int, 2> chained{event_queue, [&](const int &command) {
+        handled.push_back(command);
+        if (command < 5) {
+            self->post(command + 1);
+        }
+    }};
+    self = &chained;
+
+    chained.post(1);
+    event_queue.dispatch(0);
+
+    // The commands posted while draining are handled, none waits for another command to be posted
+    ASSERT_EQ(handled, std::vector<int>({1, 2, 3, 4, 5}));
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestCommandMailbox, pending_commands_dropped_with_mailbox)
+{
+    {
+        CommandMailbox<int, 2> dropped{event_queue, [this](const int &command) { handled.push_back(command); }};
+        dropped.post(1);
+    }
+
+    ASSERT_EQ(event_queue.size(), 0);
+    event_queue.dispatch(0);
+    ASSERT_TRUE(handled.empty());
+}
+
+TEST(TestCommandMailboxThreads, concurrent_producers)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int COMMANDS = 100;
+
+    events::EventQueue event_queue;
+    std::vector<int> handled;
+    CommandMailbox<int, 512> mailbox{event_queue, [&handled](const int &command) { handled.push_back(command); }};
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < PRODUCERS; producer++) {
+        producers.emplace_back([&mailbox, producer] {
+            for (int i = 0; i < COMMANDS; i++) {
+                EXPECT_TRUE(mailbox.post(producer * COMMANDS + i));
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    // The producers scheduled a single dispatch between them
+    ASSERT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(0);
+
+    // and each producer's commands were handled in the order it posted them
+    ASSERT_EQ(handled.size(), PRODUCERS * COMMANDS);
+    std::vector<int> next(PRODUCERS, 0);
+    for (int command : handled) {
+        int producer = command / COMMANDS;
+        ASSERT_EQ(command % COMMANDS, next[producer]);
+        next[producer]++;
+    }
+}
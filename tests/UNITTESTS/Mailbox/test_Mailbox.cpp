@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/common/Mailbox.h"
+
+#include <vector>
+
+using namespace ble;
+
+class TestMailbox : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    std::vector<int> handled;
+    Mailbox<int, 4> mailbox{event_queue, [this](const int &message) { handled.push_back(message); }};
+};
+
+TEST_F(TestMailbox, messages_handled_from_event_queue)
+{
+    mailbox.post(1);
+    mailbox.post(2);
+
+    // Nothing is handled from post()
+    ASSERT_TRUE(handled.empty());
+    ASSERT_EQ(mailbox.size(), 2);
+
+    // and a single event handles the messages in order
+    ASSERT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2}));
+    ASSERT_EQ(mailbox.size(), 0);
+    ASSERT_EQ(event_queue.size(), 0);
+
+    // The mailbox is posted again for the next messages
+    mailbox.post(3);
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2, 3}));
+}
+
+TEST_F(TestMailbox, full_mailbox_drops_messages)
+{
+    for (int i = 1; i <= 4; i++) {
+        ASSERT_TRUE(mailbox.post(i));
+    }
+
+    // The messages that do not fit are dropped and counted, nothing is handled from post()
+    ASSERT_FALSE(mailbox.post(5));
+    ASSERT_FALSE(mailbox.post(6));
+
+    ASSERT_TRUE(handled.empty());
+    ASSERT_EQ(mailbox.size(), 4);
+    ASSERT_EQ(mailbox.dropped(), 2);
+
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2, 3, 4}));
+
+    // The room is back once the event queue ran
+    ASSERT_TRUE(mailbox.post(7));
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2, 3, 4, 7}));
+    ASSERT_EQ(mailbox.dropped(), 2);
+}
+
+TEST_F(TestMailbox, full_mailbox_does_not_call_handler)
+{
+    bool posting = false;
+    int calls_from_post = 0;
+    Mailbox<int, 2> slow{event_queue, [&](const int &message) {
+        calls_from_post += posting;
+        handled.push_back(message);
+    }};
+
+    posting = true;
+    for (int i = 1; i <= 8; i++) {
+        slow.post(i);
+    }
+    posting = false;
+
+    // Flushing to make room would have run the handler from post() for each overflow
+    EXPECT_EQ(calls_from_post, 0);
+    EXPECT_TRUE(handled.empty());
+    EXPECT_EQ(slow.dropped(), 6);
+
+    event_queue.dispatch(0);
+
+    ASSERT_EQ(handled, std::vector<int>({1, 2}));
+}
+
+TEST_F(TestMailbox, messages_posted_by_handler)
+{
+    Mailbox<int, 2> *self = nullptr;
+    Mailbox<int, 2> chained{event_queue, [&](const int &message) {
+        handled.push_back(message);
+        if (message < 5) {
+            self->post(message + 1);
+        }
+    }};
+    self = &chained;
+
+    chained.post(1);
+    event_queue.dispatch(0);
+
+    // The messages posted while dispatching are handled by the same dispatch
+    ASSERT_EQ(handled, std::vector<int>({1, 2, 3, 4, 5}));
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestMailbox, clear)
+{
+    mailbox.post(1);
+    mailbox.clear();
+
+    ASSERT_EQ(mailbox.size(), 0);
+    ASSERT_EQ(event_queue.size(), 0);
+
+    event_queue.dispatch(0);
+    ASSERT_TRUE(handled.empty());
+}
+
+TEST_F(TestMailbox, flush)
+{
+    mailbox.post(1);
+    mailbox.flush();
+
+    ASSERT_EQ(handled, std::vector<int>({1}));
+
+    // The event still pending has nothing left to handle
+    event_queue.dispatch(0);
+    ASSERT_EQ(handled, std::vector<int>({1}));
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gtest/gtest.h"
+
+#include "ble/common/MpscRing.h"
+
+#include <thread>
+#include <vector>
+
+using namespace ble;
+
+TEST(TestMpscRing, values_popped_in_order)
+{
+    MpscRing<int, 4> ring;
+    int value = 0;
+
+    ASSERT_TRUE(ring.empty());
+    ASSERT_FALSE(ring.pop(value));
+
+    ASSERT_TRUE(ring.push(1));
+    ASSERT_TRUE(ring.push(2));
+    ASSERT_FALSE(ring.empty());
+
+    ASSERT_TRUE(ring.pop(value));
+    ASSERT_EQ(value, 1);
+    ASSERT_TRUE(ring.pop(value));
+    ASSERT_EQ(value, 2);
+    ASSERT_TRUE(ring.empty());
+}
+
+TEST(TestMpscRing, full_ring_refuses_values)
+{
+    MpscRing<int, 4> ring;
+    int value = 0;
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.push(i));
+    }
+
+    // The fifth value is refused, the ones pushed are kept
+    ASSERT_FALSE(ring.push(4));
+
+    // and popping one makes room for one more
+    ASSERT_TRUE(ring.pop(value));
+    ASSERT_EQ(value, 0);
+    ASSERT_TRUE(ring.push(4));
+    ASSERT_FALSE(ring.push(5));
+}
+
+TEST(TestMpscRing, many_laps)
+{
+    MpscRing<int, 4> ring;
+    int value = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(ring.push(i));
+        ASSERT_TRUE(ring.push(-i));
+
+        ASSERT_TRUE(ring.pop(value));
+        ASSERT_EQ(value, i);
+        ASSERT_TRUE(ring.pop(value));
+        ASSERT_EQ(value, -i);
+    }
+}
+
+TEST(TestMpscRing, concurrent_producers)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int VALUES = 20000;
+
+    MpscRing<int, 16> ring;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < PRODUCERS; producer++) {
+        producers.emplace_back([&ring, producer] {
+            for (int i = 0; i < VALUES; i++) {
+                // a full ring is retried, the consumer makes room
+                while (!ring.push(producer * VALUES + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each producer's values come out in the order it pushed them, none lost nor duplicated
+    std::vector<int> next(PRODUCERS, 0);
+    int popped = 0;
+    std::thread consumer([&] {
+        int value;
+        while (popped < PRODUCERS * VALUES) {
+            if (!ring.pop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            int producer = value / VALUES;
+            EXPECT_EQ(value % VALUES, next[producer]);
+            next[producer] = value % VALUES + 1;
+            popped++;
+        }
+    });
+
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    consumer.join();
+
+    ASSERT_EQ(popped, PRODUCERS * VALUES);
+    ASSERT_EQ(next, std::vector<int>(PRODUCERS, VALUES));
+    ASSERT_TRUE(ring.empty());
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/common/TimerWheel.h"
+
+#include <random>
+#include <vector>
+
+using namespace ble;
+using namespace std::chrono;
+
+class TestTimerWheel : public testing::Test {
+protected:
+    events::EventQueue event_queue;
+    TimerWheel wheel{event_queue, milliseconds(10)};
+};
+
+TEST_F(TestTimerWheel, fires_after_timeout)
+{
+    TimerWheel::Timer timer;
+    int fired = 0;
+
+    wheel.arm(timer, milliseconds(1000), [&fired] { fired++; });
+
+    ASSERT_TRUE(timer.armed());
+    ASSERT_EQ(wheel.size(), 1);
+
+    /* a single event drives the wheel */
+    ASSERT_EQ(event_queue.size(), 1);
+
+    event_queue.dispatch(999);
+    ASSERT_EQ(fired, 0);
+
+    event_queue.dispatch(1);
+    ASSERT_EQ(fired, 1);
+    ASSERT_FALSE(timer.armed());
+
+    /* the wheel stops ticking when it is empty */
+    ASSERT_EQ(wheel.size(), 0);
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestTimerWheel, timeout_rounded_up_to_resolution)
+{
+    TimerWheel::Timer short_timer;
+    TimerWheel::Timer rounded_timer;
+    int short_fired = 0;
+    int rounded_fired = 0;
+
+    wheel.arm(short_timer, milliseconds(0), [&short_fired] { short_fired++; });
+    wheel.arm(rounded_timer, milliseconds(15), [&rounded_fired] { rounded_fired++; });
+
+    event_queue.dispatch(10);
+    ASSERT_EQ(short_fired, 1);
+    ASSERT_EQ(rounded_fired, 0);
+
+    event_queue.dispatch(10);
+    ASSERT_EQ(rounded_fired, 1);
+}
+
+TEST_F(TestTimerWheel, cancel)
+{
+    TimerWheel::Timer timer;
+    TimerWheel::Timer other_timer;
+    int fired = 0;
+
+    wheel.arm(timer, milliseconds(100), [&fired] { fired++; });
+    wheel.arm(other_timer, milliseconds(100), [&fired] { fired++; });
+
+    ASSERT_TRUE(wheel.cancel(timer));
+    ASSERT_FALSE(wheel.cancel(timer));
+    ASSERT_EQ(event_queue.size(), 1);
+
+    /* cancelling the last timer cancels the tick */
+    ASSERT_TRUE(wheel.cancel(other_timer));
+    ASSERT_EQ(event_queue.size(), 0);
+
+    event_queue.dispatch(1000);
+    ASSERT_EQ(fired, 0);
+}
+
+TEST_F(TestTimerWheel, rearm)
+{
+    TimerWheel::Timer timer;
+    int fired = 0;
+
+    wheel.arm(timer, milliseconds(100), [&fired] { fired++; });
+    event_queue.dispatch(50);
+
+    wheel.arm(timer, milliseconds(100), [&fired] { fired++; });
+    ASSERT_EQ(wheel.size(), 1);
+
+    event_queue.dispatch(99);
+    ASSERT_EQ(fired, 0);
+
+    event_queue.dispatch(1);
+    ASSERT_EQ(fired, 1);
+}
+
+TEST_F(TestTimerWheel, callbacks_arm_and_cancel)
+{
+    TimerWheel::Timer first;
+    TimerWheel::Timer second;
+    TimerWheel::Timer periodic;
+    int periodic_fired = 0;
+    int fired = 0;
+
+    /* a callback can cancel a timer expiring in the same tick and re-arm its own timer */
+    wheel.arm(first, milliseconds(50), [&] { fired++; wheel.cancel(second); });
+    wheel.arm(second, milliseconds(50), [&] { fired++; wheel.cancel(first); });
+
+    mbed::Callback<void()> reload = [&] {
+        if (++periodic_fired < 3) {
+            wheel.arm(periodic, milliseconds(20), reload);
+        }
+    };
+    wheel.arm(periodic, milliseconds(20), reload);
+
+    event_queue.dispatch(1000);
+
+    ASSERT_EQ(periodic_fired, 3);
+    ASSERT_EQ(fired, 1);
+    ASSERT_FALSE(first.armed() || second.armed());
+    ASSERT_EQ(event_queue.size(), 0);
+}
+
+TEST_F(TestTimerWheel, long_timeouts_cascade)
+{
+    TimerWheel::Timer timer;
+    int fired = 0;
+
+    /* spans several levels of the wheel */
+    const milliseconds timeout = milliseconds(10) * 70000;
+    wheel.arm(timer, timeout, [&fired] { fired++; });
+
+    event_queue.dispatch((timeout - milliseconds(1)).count());
+    ASSERT_EQ(fired, 0);
+
+    event_queue.dispatch(1);
+    ASSERT_EQ(fired, 1);
+}
+
+TEST_F(TestTimerWheel, timeout_clamped)
+{
+    TimerWheel::Timer timer;
+    int fired = 0;
+
+    wheel.arm(timer, hours(24 * 365), [&fired] { fired++; });
+
+    event_queue.dispatch(TimerWheel::MAX_TICKS * 10 - 1);
+    ASSERT_EQ(fired, 0);
+
+    event_queue.dispatch(1);
+    ASSERT_EQ(fired, 1);
+}
+
+TEST_F(TestTimerWheel, matches_reference_expiry)
+{
+    const size_t count = 500;
+    std::vector<TimerWheel::Timer> timers(count);
+    std::vector<int> expected(count, -1);
+    std::vector<int> fired_at(count, -1);
+    std::mt19937 random(42);
+
+    int now = 0;
+    for (int step = 0; step < 3000; step++) {
+        size_t index = random() % count;
+        if (random() % 4 == 0) {
+            if (wheel.cancel(timers[index])) {
+                expected[index] = -1;
+            }
+        } else {
+            int ticks = 1 + random() % 5000;
+            wheel.arm(timers[index], milliseconds(ticks * 10), [&fired_at, &now, index] {
+                fired_at[index] = now;
+            });
+            expected[index] = now + ticks;
+            fired_at[index] = -1;
+        }
+
+        /* move time forward by one tick at a time so that callbacks can record it */
+        for (int i = random() % 3; i > 0; i--) {
+            now++;
+            event_queue.dispatch(10);
+        }
+    }
+
+    while (wheel.size()) {
+        now++;
+        event_queue.dispatch(10);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        ASSERT_EQ(fired_at[i], expected[i]) << "timer " << i;
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2021, Arm Limited and affiliates.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "ble/BLE.h"
+#include "ble/GattServer.h"
+
+#include "ble-service-tx-power/TxPowerService.h"
+
+#include "ble_mocks.h"
+
+using namespace ble;
+
+using ::testing::_;
+using ::testing::Pointee;
+using ::testing::Property;
+using ::testing::Return;
+
+class TestTxPowerService : public testing::Test {
+protected:
+    BLE *ble;
+
+    std::unique_ptr<TxPowerService> tx_power_service;
+
+    void SetUp()
+    {
+        ble = &BLE::Instance();
+
+        tx_power_service = std::make_unique<TxPowerService>(*ble);
+    }
+
+    void TearDown()
+    {
+        tx_power_service.reset();
+        ble::delete_mocks();
+    }
+
+    int8_t characteristic_value()
+    {
+        GattServerMock::characteristic_t &tx_power_level_char = gatt_server_mock().services[0].characteristics[0];
+
+        EXPECT_EQ(tx_power_level_char.len, sizeof(int8_t));
+
+        return *reinterpret_cast<const int8_t *>(tx_power_level_char.value);
+    }
+};
+
+TEST_F(TestTxPowerService, init)
+{
+    // A service with uuid=0x1804 should be added to the gatt server
+    EXPECT_CALL(gatt_server_mock(), addService(Property(&GattService::getUUID, GattService::UUID_TX_POWER_SERVICE)))
+            .Times(1);
+
+    ASSERT_EQ(tx_power_service->init(-8), BLE_ERROR_NONE);
+
+    auto characteristic = gatt_server_mock().services[0].characteristics[0];
+
+    // The tx power level characteristic is read only
+    ASSERT_EQ(characteristic.uuid, GattCharacteristic::UUID_TX_POWER_LEVEL_CHAR);
+    ASSERT_EQ(characteristic.properties, GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ);
+
+    // and served by the stack from its value, without a read authorisation callback
+    ASSERT_FALSE(characteristic.read_cb);
+    ASSERT_EQ(characteristic_value(), -8);
+    ASSERT_EQ(tx_power_service->get_tx_power_level(), -8);
+}
+
+TEST_F(TestTxPowerService, init_out_of_range)
+{
+    EXPECT_CALL(gatt_server_mock(), addService)
+            .Times(0);
+
+    ASSERT_EQ(tx_power_service->init(21), BLE_ERROR_INVALID_PARAM);
+    ASSERT_EQ(tx_power_service->init(-101), BLE_ERROR_INVALID_PARAM);
+}
+
+TEST_F(TestTxPowerService, set_tx_power_level)
+{
+    tx_power_service->init(0);
+
+    // The new level is written to the characteristic locally, clients are not notified
+    EXPECT_CALL(gatt_server_mock(), write(
+            gatt_server_mock().services[0].characteristics[0].value_handle, Pointee(4), sizeof(int8_t), true))
+            .WillOnce(Return(BLE_ERROR_NONE));
+
+    ASSERT_EQ(tx_power_service->set_tx_power_level(4), BLE_ERROR_NONE);
+    ASSERT_EQ(tx_power_service->get_tx_power_level(), 4);
+
+    testing::Mock::VerifyAndClearExpectations(&gatt_server_mock());
+
+    // Setting the same level again is free
+    EXPECT_CALL(gatt_server_mock(), write(_, _, _, _))
+            .Times(0);
+
+    ASSERT_EQ(tx_power_service->set_tx_power_level(4), BLE_ERROR_NONE);
+    ASSERT_EQ(tx_power_service->set_tx_power_level(30), BLE_ERROR_INVALID_PARAM);
+}
+
+TEST_F(TestTxPowerService, set_tx_power_level_failed)
+{
+    tx_power_service->init(0);
+
+    EXPECT_CALL(gatt_server_mock(), write(_, _, _, _))
+            .WillOnce(Return(BLE_ERROR_INVALID_STATE));
+
+    // The level exposed is left unchanged
+    ASSERT_EQ(tx_power_service->set_tx_power_level(4), BLE_ERROR_INVALID_STATE);
+    ASSERT_EQ(tx_power_service->get_tx_power_level(), 0);
+}